@@ -19,6 +19,7 @@
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "environment/map.hpp"
+#include "environment/map_cache.hpp"
 
 #include <imgui.h>
 #include <SFML/Graphics/Image.hpp>
@@ -58,6 +59,7 @@ private:
 	unsigned int m_seed;
 	resources::map_info m_map_props;
 	map m_map;
+	map_cache m_map_cache{};
 
 	sf::Image m_image;
 	sf::Texture m_texture;
@@ -23,11 +23,13 @@
 #include <vector>
 
 #include <environment/world.hpp>
+#include <utils/tick_scheduler.hpp>
 #include <imterm/terminal.hpp>
 #include <imterm/terminal_helpers.hpp>
 
 struct program_state {
 	class world world{};
+	dungeep::tick_scheduler scheduler{};
 	bool running{true};
 };
 class terminal_commands : public ImTerm::basic_spdlog_terminal_helper<terminal_commands, program_state, std::mutex> {
@@ -44,7 +46,9 @@ public:
 	static void exit(argument_type&);
 	static void help(argument_type&);
 	static void print_resource(argument_type&);
+	static void qtree_stats(argument_type&);
 	static void quit(argument_type&);
+	static void tick_stats(argument_type&);
 };
 
 
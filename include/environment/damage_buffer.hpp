@@ -0,0 +1,95 @@
+#ifndef DUNGEEP_DAMAGE_BUFFER_HPP
+#define DUNGEEP_DAMAGE_BUFFER_HPP
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///                                                                                                                                     ///
+///  Copyright C 2019, Lucas Lazare                                                                                                     ///
+///  Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation         ///
+///  		files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy,  ///
+///  modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software     ///
+///  		is furnished to do so, subject to the following conditions:                                                                 ///
+///                                                                                                                                     ///
+///  The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.     ///
+///                                                                                                                                     ///
+///  The Software is provided “as is”, without warranty of any kind, express or implied, including but not limited to the               ///
+///  warranties of merchantability, fitness for a particular purpose and noninfringement. In no event shall the authors or              ///
+///  copyright holders be liable for any claim, damages or other liability, whether in an action of contract, tort or otherwise,        ///
+///  arising from, out of or in connection with the software or the use or other dealings in the Software.                              ///
+///                                                                                                                                     ///
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+
+class creature;
+
+enum class damage_type : unsigned char {
+	physical,
+	magical,
+	true_damage,
+};
+
+/**
+ * Damages dealt during a tick, resolved all at once at its end
+ * Events are grouped by target: the input hooks of each target's buffs run in the order the events were pushed, then the armor and
+ * resist reductions of all events are computed in a single loop, and each target loses its health once.
+ *
+ * Target is creature in the game (see damage_buffer). It provides entity_id(), filter_input_damage(type, amount),
+ * defense_against(type), lose_health(amount) and get_hp().
+ */
+template <typename Target>
+class basic_damage_buffer {
+public:
+	struct event {
+		Target* target;
+		damage_type type;
+		int amount;
+		int penetration; // ignored armor or resist
+	};
+
+	void push(Target& target, damage_type type, int amount, int penetration = 0) {
+		events.push_back({&target, type, amount, penetration});
+	}
+
+	// moves the events of 'other' after those of *this
+	void append(basic_damage_buffer& other);
+
+	[[nodiscard]] bool empty() const noexcept {
+		return events.empty();
+	}
+
+	[[nodiscard]] std::size_t size() const noexcept {
+		return events.size();
+	}
+
+	/**
+	 * Applies and clears the pending events. Returns the targets whose health dropped to 0 or below, ordered by entity id
+	 */
+	std::vector<Target*> resolve();
+
+	// damage left once armor or resist reduced it: with n armor/resist, you have a (n/10)% effective hp boost
+	static int reduce(int damage, int defense) noexcept {
+		if (defense >= 0) {
+			return damage * 1000 / (1000 + defense);
+		} else {
+			return damage * 2 - damage * 1000 / (1000 - defense);
+		}
+	}
+
+	// reduce(damages[i], defenses[i]) in out[i] for i in [0 ; count[, without branches nor integer divisions so that it vectorises
+	static void reduce_all(const int* damages, const int* defenses, int* out, std::size_t count) noexcept;
+
+private:
+	std::vector<event> events{};
+
+	// reused between calls
+	std::vector<int> amounts{};
+	std::vector<int> defenses{};
+	std::vector<int> reduced{};
+};
+
+using damage_buffer = basic_damage_buffer<creature>;
+extern template class basic_damage_buffer<creature>; // instantiated in damage_buffer.cpp
+
+#include "damage_buffer.tpp"
+
+#endif //DUNGEEP_DAMAGE_BUFFER_HPP
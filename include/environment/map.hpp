@@ -22,8 +22,11 @@
 #include <vector>
 #include <random>
 #include <chrono>
+#include <cstdint>
+#include <utility>
 #include "tiles.hpp"
 #include "utils/geometry.hpp"
+#include "utils/random.hpp"
 
 struct zone_gen_properties {
 	/**
@@ -62,11 +65,11 @@ struct hallway_gen_properties {
 };
 
 namespace dungeep {
-	template <typename>
-	class normal_distribution;
+	class thread_pool;
 }
 
 class map {
+	friend class map_snapshot;
 
 public:
 	struct map_area {
@@ -80,9 +83,17 @@ public:
 
 	map() = default;
 
+	// seeded from dungeep::random_engine
 	std::vector<map_area> generate(size_type size, const std::vector<room_gen_properties>& rooms_properties,
 	                               const hallway_gen_properties& hgp);
 
+	/**
+	 * Rooms' shapes and hallways are computed on 'pool' if given. Each of them draws from its own engine, derived from 'seed',
+	 * and they are merged in a fixed order: a given seed gives the same map whatever the number of threads.
+	 */
+	std::vector<map_area> generate(size_type size, const std::vector<room_gen_properties>& rooms_properties,
+	                               const hallway_gen_properties& hgp, std::uint64_t seed, dungeep::thread_pool* pool = nullptr);
+
 	std::vector<tiles>& operator[](std::vector<tiles>::size_type sz) {
 		return m_tiles[sz];
 	}
@@ -111,33 +122,58 @@ public:
 
 	std::vector<dungeep::point_i> path_to_pt(const dungeep::point_i& source, const dungeep::point_i& destination, float wall_crossing_penalty = 30.f) const;
 
+	// returns the position, in [0 ; 1], at which the segment [from ; to] enters the first tile blocking sight (1 if there is none)
+	float cast_ray(const dungeep::point_f& from, const dungeep::point_f& to) const noexcept;
+
+	// first value of the spatial index 'index' met on [from ; to] before a tile blocking sight, for which 'predicate(value)'
+	// returned true. index.end() if there is none.
+	template <typename Index, typename Pred>
+	auto cast_ray(Index& index, const dungeep::point_f& from, const dungeep::point_f& to, Pred&& predicate) const {
+		const dungeep::point_f end = from + (to - from) * cast_ray(from, to);
+		return index.raycast_if(from, end, std::forward<Pred>(predicate));
+	}
+
 
 
 private:
+	// tiles of a zone with fuzzy borders, before being placed on the map. tiles::none outside of the zone.
+	struct zone_stamp {
+		dungeep::point_ui dim{};
+		unsigned int margin{};
+		std::vector<std::vector<tiles>> grid{};
+	};
+
+	struct hallway {
+		std::vector<dungeep::point_i> stop_offs{};
+		int width{};
+	};
 
 	static void add_fuzziness(std::vector<std::vector<tiles>>& generated_room, const zone_gen_properties& rp
-			, const map_area& tiles_area, tiles tile, dungeep::normal_distribution<float>& zone_fuzziness);
+			, const map_area& tiles_area, tiles tile, dungeep::normal_distribution<float>& zone_fuzziness, dungeep::default_engine& rand);
+
+	static float gen_positive(float avg, float dev, dungeep::default_engine& rand);
 
-	static float gen_positive(float avg, float dev);
+	void ensure_pathing(const std::vector<map_area>& rooms_center, const hallway_gen_properties&, std::uint64_t seed, dungeep::thread_pool* pool);
 
-	void ensure_pathing(const std::vector<map_area>& rooms_center, const hallway_gen_properties&);
+	static hallway plan_hallway(const dungeep::point_ui& r1_center, const dungeep::point_ui& r2_center, const hallway_gen_properties&, dungeep::default_engine& rand);
 
-	void ensure_tworoom_path(const dungeep::point_ui& r1_center, const dungeep::point_ui& r2_center, const hallway_gen_properties&);
+	void carve_hallway(const hallway& path);
 
-	map_area generate_holed_room(const room_gen_properties& rp, unsigned int hole_count);
+	map_area place_holed_room(const zone_stamp& room, const std::vector<zone_stamp>& holes, dungeep::default_engine& rand);
 
-	static dungeep::point_ui generate_zone_dimensions(const zone_gen_properties& zgp);
+	static dungeep::point_ui generate_zone_dimensions(const zone_gen_properties& zgp, dungeep::default_engine& rand);
 
+	static zone_stamp generate_zone(const zone_gen_properties& rp, dungeep::point_ui dim, tiles tile, dungeep::default_engine& rand);
 
-	void generate_tiles(const zone_gen_properties& rp, map_area tiles_area, tiles tile);
+	void stamp_zone(const zone_stamp& zone, dungeep::point_ui pos);
 
 	dungeep::point_ui
-	find_zone_filled_with(dungeep::point_ui zone_dim, tiles tile)
+	find_zone_filled_with(dungeep::point_ui zone_dim, tiles tile, dungeep::default_engine& rand)
 	const noexcept {
-		return find_zone_filled_with(zone_dim, tile, {0,0, size().width - 1, size().height - 1});
+		return find_zone_filled_with(zone_dim, tile, {0,0, size().width - 1, size().height - 1}, rand);
 	}
 
-	dungeep::point_ui find_zone_filled_with(dungeep::point_ui zone_dim, tiles tile, map_area sub_area) const noexcept;
+	dungeep::point_ui find_zone_filled_with(dungeep::point_ui zone_dim, tiles tile, map_area sub_area, dungeep::default_engine& rand) const noexcept;
 
 	std::vector<std::vector<tiles>> m_tiles{};
 
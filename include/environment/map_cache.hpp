@@ -0,0 +1,63 @@
+#ifndef DUNGEEP_MAP_CACHE_HPP
+#define DUNGEEP_MAP_CACHE_HPP
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///                                                                                                                                     ///
+///  Copyright C 2019, Lucas Lazare                                                                                                     ///
+///  Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation         ///
+///  		files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy,  ///
+///  modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software     ///
+///  		is furnished to do so, subject to the following conditions:                                                                 ///
+///                                                                                                                                     ///
+///  The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.     ///
+///                                                                                                                                     ///
+///  The Software is provided “as is”, without warranty of any kind, express or implied, including but not limited to the               ///
+///  warranties of merchantability, fitness for a particular purpose and noninfringement. In no event shall the authors or              ///
+///  copyright holders be liable for any claim, damages or other liability, whether in an action of contract, tort or otherwise,        ///
+///  arising from, out of or in connection with the software or the use or other dealings in the Software.                              ///
+///                                                                                                                                     ///
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+#include "environment/map.hpp"
+
+namespace dungeep {
+	class thread_pool;
+}
+
+/**
+ * On disk cache of generated maps, keyed by a hash of everything map::generate's output depends on
+ * Each map is stored in its own file, <key in hexadecimal>.dgm, as a run length encoded map_snapshot tagged with its key.
+ * The cache is best effort: unreadable or corrupted files are treated as misses, and failing to write one only logs a warning.
+ * Files are written to a temporary file first, then renamed: several threads or processes may share a cache.
+ */
+class map_cache {
+public:
+	// to be bumped whenever map::generate's output changes for a given seed and properties, invalidating former files
+	static constexpr std::uint32_t generator_version = 1;
+
+	explicit map_cache(std::filesystem::path directory = "resources/map_cache/") noexcept : m_directory{std::move(directory)} {}
+
+	[[nodiscard]] static std::uint64_t key(std::uint64_t seed, map::size_type size, const std::vector<room_gen_properties>& rooms_properties,
+	                                       const hallway_gen_properties& hgp) noexcept;
+
+	// returns the rooms, and fills 'target', if the cache holds the map of 'key'
+	std::optional<std::vector<map::map_area>> load(std::uint64_t key, map& target) const;
+
+	void store(std::uint64_t key, const map& generated, const std::vector<map::map_area>& rooms) const;
+
+	// same as map::generate, but only generates (and stores) the map on cache misses
+	std::vector<map::map_area> generate(map& target, map::size_type size, const std::vector<room_gen_properties>& rooms_properties,
+	                                    const hallway_gen_properties& hgp, std::uint64_t seed, dungeep::thread_pool* pool = nullptr) const;
+
+private:
+	[[nodiscard]] std::filesystem::path file_of(std::uint64_t key) const;
+
+	std::filesystem::path m_directory;
+};
+
+#endif //DUNGEEP_MAP_CACHE_HPP
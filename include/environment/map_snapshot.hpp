@@ -0,0 +1,113 @@
+#ifndef DUNGEEP_MAP_SNAPSHOT_HPP
+#define DUNGEEP_MAP_SNAPSHOT_HPP
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///                                                                                                                                     ///
+///  Copyright C 2019, Lucas Lazare                                                                                                     ///
+///  Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation         ///
+///  		files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy,  ///
+///  modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software     ///
+///  		is furnished to do so, subject to the following conditions:                                                                 ///
+///                                                                                                                                     ///
+///  The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.     ///
+///                                                                                                                                     ///
+///  The Software is provided “as is”, without warranty of any kind, express or implied, including but not limited to the               ///
+///  warranties of merchantability, fitness for a particular purpose and noninfringement. In no event shall the authors or              ///
+///  copyright holders be liable for any claim, damages or other liability, whether in an action of contract, tort or otherwise,        ///
+///  arising from, out of or in connection with the software or the use or other dealings in the Software.                              ///
+///                                                                                                                                     ///
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "environment/map.hpp"
+#include "utils/mapped_file.hpp"
+
+/**
+ * Versioned binary snapshot of a map: its tiles and rooms
+ *
+ * Layout, little endian:
+ *   header (40 bytes): "DGMS", u16 format version, u16 header size, u32 width, u32 height, u32 room count,
+ *                      u8 tile encoding, 3 padding bytes, u64 tag (free for the writer), u64 checksum (FNV-1a of what follows)
+ *   rooms: room count times u32 x, y, width, height
+ *   tiles, column after column (as map[x][y]):
+ *     - raw: one byte per tile. Can be read in place, without copying nor decoding anything.
+ *     - run_length: u32 run length and u8 tile, repeated. Much smaller for maps that are mostly empty space.
+ *
+ * Readers refuse snapshots written with a newer format version.
+ */
+class map_snapshot {
+public:
+	enum class tile_encoding : std::uint8_t {
+		raw,
+		run_length,
+	};
+
+	static constexpr std::uint16_t format_version = 1;
+	static constexpr std::size_t header_size = 40;
+
+	static std::string serialize(const map& source, const std::vector<map::map_area>& rooms, tile_encoding encoding, std::uint64_t tag = 0);
+
+	// views a snapshot held in memory, which must outlive this object
+	map_snapshot(const unsigned char* data, std::size_t size) noexcept;
+
+	// maps 'path' and views it
+	explicit map_snapshot(const std::filesystem::path& path) noexcept;
+
+	// false if the snapshot could not be read, or is truncated, malformed (unknown tiles included), or of a newer version.
+	// Other functions require it.
+	[[nodiscard]] bool is_valid() const noexcept {
+		return m_valid;
+	}
+
+	// the checksum is not checked on construction, as it requires reading the whole snapshot
+	[[nodiscard]] bool checksum_matches() const noexcept;
+
+	[[nodiscard]] std::uint16_t version() const noexcept {
+		return m_version;
+	}
+
+	[[nodiscard]] std::uint64_t tag() const noexcept {
+		return m_tag;
+	}
+
+	[[nodiscard]] tile_encoding encoding() const noexcept {
+		return m_encoding;
+	}
+
+	[[nodiscard]] map::size_type size() const noexcept {
+		return m_size;
+	}
+
+	[[nodiscard]] std::vector<map::map_area> rooms() const;
+
+	// tiles read in place, for raw snapshots only
+	[[nodiscard]] tiles tile(unsigned int x, unsigned int y) const noexcept {
+		assert(m_encoding == tile_encoding::raw && x < m_size.width && y < m_size.height);
+		return static_cast<tiles>(m_tiles[std::size_t{x} * m_size.height + y]);
+	}
+
+	// copies the tiles in 'target', whatever the encoding
+	void load_into(map& target) const;
+
+private:
+	bool parse() noexcept;
+
+	dungeep::mapped_file m_file{};
+	const unsigned char* m_data;
+	std::size_t m_data_size;
+
+	bool m_valid{false};
+	std::uint16_t m_version{};
+	tile_encoding m_encoding{};
+	map::size_type m_size{};
+	std::uint32_t m_room_count{};
+	std::uint64_t m_tag{};
+	std::uint64_t m_checksum{};
+	const unsigned char* m_tiles{nullptr};
+};
+
+#endif //DUNGEEP_MAP_SNAPSHOT_HPP
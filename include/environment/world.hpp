@@ -18,13 +18,30 @@
 ///                                                                                                                                     ///
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+#include <atomic>
+#include <future>
+#include <memory>
 #include <random>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
 
 #include "environment/world_objects/dynamic_object.hpp"
 #include "utils/quadtree.hpp"
+#include "utils/spatial_grid.hpp"
+#include "utils/thread_pool.hpp"
+#include "utils/random.hpp"
 #include "map.hpp"
+#include "map_cache.hpp"
 
 enum class chest_level;
+class creature;
+class player;
+
+// Spatial index holding the world's objects
+// dungeep::spatial_grid has the same interface as dungeep::quadtree, and is usually faster for many small creatures.
+template <typename T>
+using world_index = dungeep::quadtree<T>;
 
 class world {
 	friend class world_proxy;
@@ -32,35 +49,169 @@ class world {
 
 public:
 	world() = default;
-
+	world(const world&) = delete;
+	world& operator=(const world&) = delete;
+	~world();
+
+	/**
+	 * Swaps in the next level, generated in the background since the previous call (synchronously on the first call or after
+	 * seed_world), then starts generating the one after it.
+	 * The next level only depends on a seed drawn from shared_random when its generation starts, so every player builds
+	 * the same one.
+	 */
 	void generate_next_level();
 
-	void seed_world(std::mt19937_64::result_type seed) {
+	// drops the level being generated in the background, as it was generated from the former seed
+	void seed_world(dungeep::default_engine::result_type seed) {
+		cancel_level_generation();
 		shared_random.seed(seed);
+		world_seed = seed;
+	}
+
+	/**
+	 * Stream of randoms of an entity for the current tick, keyed by (world seed, entity id, tick)
+	 * Independent of the other entities' streams and of the order in which entities tick.
+	 */
+	[[nodiscard]] dungeep::philox4x32 entity_random(std::uint32_t entity) const noexcept {
+		return dungeep::philox4x32{world_seed, entity, tick_number};
 	}
 
+	/**
+	 * Regenerates the creatures' health (in bulk, see creature_components::regenerate), ticks every dynamic object, then applies
+	 * the creations and deletions they requested
+	 * Objects are split in vertical strips of the map, ticked on 'tick_pool': even strips first, then odd ones, so that two
+	 * objects ticking at the same time are at least a strip apart. Each strip has its own world_proxy, whose requests are
+	 * applied in strip order: the result does not depend on the number of threads.
+	 */
 	void next_tick();
 
+	/**
+	 * Players are inserted in the dynamic objects. They are dropped when the next level is generated.
+	 */
+	void add_player(std::unique_ptr<player>&& new_player);
+
+	/**
+	 * Creatures whose hitbox does not cross the square of half side 'radius' around a player are put to sleep: they are moved to
+	 * a separate index, skipped by next_tick and by the world_proxy queries, until a player comes close enough.
+	 */
+	void set_sleep_radius(float radius) noexcept {
+		sleep_radius = radius;
+	}
+
+	[[nodiscard]] std::size_t sleeping_objects_count() const noexcept {
+		return sleeping_objects.size();
+	}
+
+	// shape and usage of the spatial indexes holding the world's objects
+	[[nodiscard]] dungeep::quadtree_stats dynamic_objects_stats() const {
+		return dynamic_objects.stats();
+	}
+
+	[[nodiscard]] dungeep::quadtree_stats static_objects_stats() const {
+		return static_objects.stats();
+	}
+
+	void reset_objects_stats() noexcept {
+		dynamic_objects.reset_stats();
+		static_objects.reset_stats();
+	}
+
 private:
+	// Objects are only described in the background: creating them allocates entities and reads their sprites, which is done
+	// on the main thread, in spawn order, when the level is swapped in.
+	struct chest_spawn {
+		dungeep::area_f hitbox;
+		chest_level quality;
+	};
+
+	struct mob_spawn {
+		dungeep::area_f hitbox;
+		std::string_view name; // of its resources::creature_info
+	};
+
+	// what generate_next_level swaps in
+	struct level {
+		map terrain{};
+		unsigned int number{0u};
+		std::vector<chest_spawn> chests{};
+		std::vector<mob_spawn> mobs{};
+	};
+
+	// thrown by build_level, and reported through the level_generation's future when generating in the background
+	struct level_generation_error : std::runtime_error {
+		using std::runtime_error::runtime_error;
+	};
+
+	struct level_generation {
+		std::atomic<bool> cancelled{false};
+		std::future<std::unique_ptr<level>> result{}; // declared last: its destructor waits for the generation
+	};
+
+	// generates a level from 'seed' only, without touching the world nor creating objects: may run on any thread.
+	// Returns nullptr if cancelled.
+	static std::unique_ptr<level> build_level(unsigned int level_number, std::uint64_t seed, const map_cache& cache,
+	                                          dungeep::thread_pool* pool, const std::atomic<bool>& cancelled);
+
+	void start_level_generation();
+
+	// waits for the background generation to stop, which it checks for between its steps
+	void cancel_level_generation() noexcept;
+
+	// creates the objects described by 'lvl' in the (empty) indexes of the world
+	void spawn_objects(const level& lvl);
 
 	// tries to generate a valid position for an object, returns false on failure
-	bool try_gen_pos(const map::map_area& room, dungeep::area_f& /* out */ generated_area, dungeep::dim_uc dim);
+	static bool try_gen_pos(const level& lvl, const map::map_area& room, dungeep::area_f& /* out */ generated_area, dungeep::dim_uc dim,
+	                        dungeep::default_engine& rand);
 
 
 	// generates a chest
-	void put_n_chest(chest_level lvl, unsigned short count, const std::vector<map::map_area>& room_list);
+	static void put_n_chest(level& lvl, chest_level chest_lvl, unsigned short count, const std::vector<map::map_area>& room_list,
+	                        dungeep::default_engine& rand);
 
-	unsigned int mobs_per_100_tiles() const noexcept {
-		return 2 * current_level + 10;
+	static unsigned int mobs_per_100_tiles(unsigned int level_number) noexcept {
+		return 2 * level_number + 10;
 	}
 
-	std::mt19937_64 shared_random{}; // NOLINT, shared as in shared between all players. For local random, use dungeep::random_engine
-	dungeep::quadtree<dungeep::qtree_unique_ptr<dynamic_object>> dynamic_objects{dungeep::area_f::null};
-	dungeep::quadtree<dungeep::qtree_unique_ptr<world_object>> static_objects{dungeep::area_f::null};
+	// applies the creations and deletions requested through 'proxy'
+	void apply_requests(world_proxy& proxy);
+
+	// wakes the sleeping objects close to a player, and puts the far away creatures to sleep
+	void update_sleep();
+
+	[[nodiscard]] bool is_near_player(const dungeep::area_f& hitbox) const noexcept;
+
+	[[nodiscard]] bool is_player(const world_object* object) const noexcept;
+
+	// moves 'object' from an index to the other, returns false if it was not in 'from'
+	using dynamic_index = world_index<dungeep::qtree_unique_ptr<dynamic_object>>;
+	static bool transfer(dynamic_index& from, dynamic_index& to, const world_object* object);
+
+	static constexpr unsigned int tick_strip_count = 16;
+	static constexpr std::size_t parallel_tick_threshold = 256; // fewer objects are ticked from the calling thread
+	static constexpr unsigned int sleep_check_interval = 30;    // ticks between two searches for creatures to put to sleep
+
+	dungeep::default_engine shared_random{}; // NOLINT, shared as in shared between all players. For local random, use dungeep::random_engine
+	world_index<dungeep::qtree_unique_ptr<dynamic_object>> dynamic_objects{dungeep::area_f::null};
+	world_index<dungeep::qtree_unique_ptr<world_object>> static_objects{dungeep::area_f::null};
+	world_index<dungeep::qtree_unique_ptr<dynamic_object>> sleeping_objects{dungeep::area_f::null};
+
+	// references to objects owned by the indexes: those going stale are dropped by apply_requests
+	std::vector<dungeep::pool_ref<player>> players{};
+	std::vector<std::pair<dungeep::pool_ref<world_object>, int>> drowsy_creatures{}; // creatures going to sleep, and their remaining forced ticks
+	float sleep_radius{48.f};
+	unsigned int ticks_before_sleep_check{0u};
 
 	unsigned int current_level{0u};
+	std::uint64_t world_seed{0u};
+	std::uint32_t tick_number{0u};
+
+	dungeep::thread_pool tick_pool{};
 
 	map shared_map{}; // shared as in shared between all players
+	map_cache level_cache{};
+
+	std::unique_ptr<level_generation> next_level{};
 
 };
 
@@ -35,7 +35,7 @@ enum class chest_level {
 	magic
 };
 
-class chest : public world_object {
+class chest final : public world_object, public dungeep::pool_allocated<chest> {
 public:
 
 	chest(chest_level l) : ite{item::generate_rand(l)} {}
@@ -57,6 +57,10 @@ public:
 		// TODO
 	}
 
+	dungeep::pool_ref<world_object> ref() const noexcept override {
+		return dungeep::pool_ref<world_object>::to(*this);
+	}
+
 private:
 	std::unique_ptr<item> ite;
 };
@@ -18,11 +18,15 @@
 ///                                                                                                                                     ///
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+#include <utility>
 #include <vector>
 
 #include "iconned/fixed.hpp"
 #include "iconned/dynamic.hpp"
+#include "iconned/buff_set.hpp"
 #include "dynamic_object.hpp"
+#include "creature_components.hpp"
+#include "environment/damage_buffer.hpp"
 
 namespace sf {
 	class Sprite;
@@ -31,7 +35,9 @@ namespace sf {
 class creature : public dynamic_object {
 public:
 
-	explicit creature(std::string_view name_) noexcept;
+	explicit creature(std::string_view name_);
+
+	~creature() override;
 
 	virtual void magical_hit(int damage, int resist_ignore) noexcept;
 
@@ -39,6 +45,7 @@ public:
 
 	void add_effect(std::unique_ptr<fixed_effect>&& effect) noexcept;
 
+	// does nothing if the effect is not one of this creature's
 	void remove_effect(fixed_effect*) noexcept;
 
 	// returns the number of forced non-sleep ticks
@@ -46,53 +53,75 @@ public:
 
 	virtual void true_hit(int damage) noexcept;
 
+	// damage left once the input hooks of the buffs ran, in the order the buffs were added
+	int filter_input_damage(damage_type type, int damage) noexcept;
+
+	// armor for physical damages, resist for magical ones
+	int defense_against(damage_type type) const noexcept {
+		return type == damage_type::magical ? get_resist() : get_armor();
+	}
+
+	void lose_health(int amount) noexcept {
+		stat(stat_id::current_health) -= amount;
+	}
+
+	creature_components::id entity_id() const noexcept {
+		return entity;
+	}
+
 	void print(sf::RenderWindow& rw) const noexcept override;
 
 	virtual int get_armor() const noexcept {
-		return armor;
+		return stat(stat_id::armor) + buffs.bonuses().armor;
 	}
 
 	virtual int get_resist() const noexcept {
-		return resist;
+		return stat(stat_id::resist) + buffs.bonuses().resist;
 	}
 
 	virtual int get_hp() const noexcept {
-		return current_health;
+		return stat(stat_id::current_health);
 	}
 
 	virtual int get_max_hp() const noexcept {
-		return max_health;
+		return stat(stat_id::max_health) + buffs.bonuses().hp;
 	}
 
 	virtual void heal(int heal) noexcept {
-		current_health = std::min(get_hp() + heal, get_max_hp());
+		stat(stat_id::current_health) = std::min(get_hp() + heal, get_max_hp());
 	}
 
 protected:
 
 	// with n armor/resist, you have a (n/10)% effective hp boost
 	static int compute_damage_reduction(int damage, int defense) noexcept {
-		if (defense >= 0) {
-			return damage * 1000 / (1000 + defense);
-		} else {
-			return damage * 2 - damage * 1000 / (1000 - defense);
-		}
+		return damage_buffer::reduce(damage, defense);
+	}
+
+	using stat_id = creature_components::stat;
+
+	// stats are stored in creature_components::instance()
+	int& stat(stat_id s) noexcept {
+		return creature_components::instance().get(s, entity);
+	}
+
+	int stat(stat_id s) const noexcept {
+		return std::as_const(creature_components::instance()).get(s, entity);
 	}
 
 	std::string_view name;
 
-	int current_health{};
-	int max_health{};
-	int armor{};
-	int resist{};
-	int attack_power{};
-	int crit_chance{};
-	int move_speed{};
+	const creature_components::id entity;
 
 	dungeep::direction current_direction{};
 
-	std::vector<std::unique_ptr<fixed_effect>> fixed_buffs{};
-	std::vector<std::unique_ptr<dynamic_effect>> dynamic_buffs{};
+	// dynamic buffs implementing 'hook', in the order they were added
+	const std::vector<dynamic_effect*>& hooked_buffs(effect_hook hook) const noexcept {
+		return buffs.hooked(hook);
+	}
+
+	// keeps the sum of the buffs' stats and the per hook lists up to date, so that hits do not walk every buff
+	buff_set buffs{};
 
 	std::array<sf::Sprite, static_cast<unsigned>(dungeep::direction::none)>& sprites; // TODO: vector of array / array of vector (animations)
 };
@@ -0,0 +1,145 @@
+#ifndef DUNGEEP_CREATURE_COMPONENTS_HPP
+#define DUNGEEP_CREATURE_COMPONENTS_HPP
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///                                                                                                                                     ///
+///  Copyright C 2019, Lucas Lazare                                                                                                     ///
+///  Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation         ///
+///  		files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy,  ///
+///  modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software     ///
+///  		is furnished to do so, subject to the following conditions:                                                                 ///
+///                                                                                                                                     ///
+///  The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.     ///
+///                                                                                                                                     ///
+///  The Software is provided “as is”, without warranty of any kind, express or implied, including but not limited to the               ///
+///  warranties of merchantability, fitness for a particular purpose and noninfringement. In no event shall the authors or              ///
+///  copyright holders be liable for any claim, damages or other liability, whether in an action of contract, tort or otherwise,        ///
+///  arising from, out of or in connection with the software or the use or other dealings in the Software.                              ///
+///                                                                                                                                     ///
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+
+#include "utils/chunked_storage.hpp"
+
+/**
+ * Structure of arrays holding the creatures' simulation stats, indexed by entity id
+ * Stats are stored by chunks of 'chunk_size' entities, each stat having its own array: per tick passes stream over packed ints
+ * instead of hopping from a heap allocated creature to another.
+ *
+ * Chunks are never moved nor freed (see dungeep::chunked_storage): entities can be created from objects ticking in parallel
+ * while other threads read or write the stats of entities they own.
+ */
+class creature_components {
+public:
+	using id = std::uint32_t;
+
+	enum class stat : unsigned int {
+		current_health,
+		max_health,
+		armor,
+		resist,
+		attack_power,
+		crit_chance,
+		move_speed,
+		health_regen, // per tick, see regenerate()
+		health_bonus, // granted by the creature's buffs, on top of max_health
+		count
+	};
+
+	static constexpr std::size_t chunk_size = 256;
+	static constexpr std::size_t max_chunks = 4096;
+	static constexpr std::size_t stat_count = static_cast<std::size_t>(stat::count);
+
+	struct chunk {
+		[[nodiscard]] std::array<int, chunk_size>& operator[](stat s) noexcept {
+			return stats[static_cast<std::size_t>(s)];
+		}
+
+		[[nodiscard]] const std::array<int, chunk_size>& operator[](stat s) const noexcept {
+			return stats[static_cast<std::size_t>(s)];
+		}
+
+		std::array<std::array<int, chunk_size>, stat_count> stats{};
+		std::array<bool, chunk_size> alive{};
+	};
+
+	// creatures use instance(), other storages being for tests
+	creature_components() = default;
+	creature_components(const creature_components&) = delete;
+	creature_components& operator=(const creature_components&) = delete;
+
+	// storage shared by every creature
+	static creature_components& instance() noexcept {
+		static creature_components components;
+		return components;
+	}
+
+	// new entity, with all of its stats set to 0. Throws std::bad_alloc once chunk_size * max_chunks entities exist
+	[[nodiscard]] id create() {
+		return storage_.acquire([this](id entity) {
+			chunk& c = storage_.chunk(entity);
+			for (auto& values : c.stats) {
+				values[storage_.offset(entity)] = 0;
+			}
+			c.alive[storage_.offset(entity)] = true;
+		});
+	}
+
+	void destroy(id entity) noexcept {
+		assert(entity < storage_.used());
+		storage_.release(entity, [this](id dead) {
+			assert(storage_.chunk(dead).alive[storage_.offset(dead)]);
+			storage_.chunk(dead).alive[storage_.offset(dead)] = false;
+		});
+	}
+
+	[[nodiscard]] int& get(stat s, id entity) noexcept {
+		return storage_.chunk(entity)[s][storage_.offset(entity)];
+	}
+
+	[[nodiscard]] int get(stat s, id entity) const noexcept {
+		return storage_.chunk(entity)[s][storage_.offset(entity)];
+	}
+
+	/**
+	 * Calls 'func(chunk&, size_type used)' for each allocated chunk, entities [0 ; used[ of the chunk having been created at some point
+	 * Dead entities are flagged in 'chunk::alive'. Must not run while entities are being created or destroyed.
+	 */
+	template <typename FuncT>
+	void for_each_chunk(FuncT&& func) {
+		const std::size_t used = storage_.used();
+		for (std::size_t first = 0 ; first < used ; first += chunk_size) {
+			func(storage_.chunk(static_cast<id>(first)), std::min<std::size_t>(chunk_size, used - first));
+		}
+	}
+
+	/**
+	 * Per tick regeneration pass: each entity whose current health is positive gains its health_regen, up to max_health + health_bonus
+	 * Health already above that cap is left as is. Dead entities are processed as well, as their stats are reset by create().
+	 */
+	void regenerate() noexcept {
+		for_each_chunk([](chunk& c, std::size_t used) {
+			int* health = c[stat::current_health].data();
+			const int* regen = c[stat::health_regen].data();
+			const int* max_health = c[stat::max_health].data();
+			const int* bonus = c[stat::health_bonus].data();
+			for (std::size_t i = 0 ; i < used ; ++i) {
+				const int healed = std::min(health[i] + regen[i], max_health[i] + bonus[i]);
+				health[i] = health[i] > 0 ? std::max(health[i], healed) : health[i];
+			}
+		});
+	}
+
+	[[nodiscard]] std::size_t size() const {
+		return storage_.size();
+	}
+
+private:
+	dungeep::chunked_storage<chunk, chunk_size, max_chunks> storage_{};
+};
+
+#endif //DUNGEEP_CREATURE_COMPONENTS_HPP
@@ -26,7 +26,7 @@
 
 enum class chest_level;
 
-class item final : public world_object {
+class item final : public world_object, public dungeep::pool_allocated<item> {
 public:
 	static std::unique_ptr<item> generate_rand(chest_level);
 
@@ -40,6 +40,10 @@ public:
 		// todo
 	}
 
+	dungeep::pool_ref<world_object> ref() const noexcept override {
+		return dungeep::pool_ref<world_object>::to(*this);
+	}
+
 
 private:
 	std::unique_ptr<fixed_effect> item_effects;
@@ -29,9 +29,9 @@ namespace sf {
 
 class player;
 
-class mob final : public creature {
+class mob final : public creature, public dungeep::pool_allocated<mob> {
 public:
-	mob(const resources::creature_info& infos, unsigned int level) noexcept;
+	mob(const resources::creature_info& infos, unsigned int level);
 
 	void tick(world_proxy& world) noexcept override;
 
@@ -41,6 +41,10 @@ public:
 
 	void interact_with(player&) noexcept override {}
 
+	dungeep::pool_ref<world_object> ref() const noexcept override {
+		return dungeep::pool_ref<world_object>::to(*this);
+	}
+
 	int sleep() noexcept override;
 
 	~mob() override;
@@ -21,9 +21,9 @@
 #include "utils/resource_manager.hpp"
 #include "creature.hpp"
 
-class mob_spawner final : public creature {
+class mob_spawner final : public creature, public dungeep::pool_allocated<mob_spawner> {
 	// FIXME: pas de sprite pour les spawners
-	mob_spawner(const resources::creature_info& infos_, int level_) noexcept;
+	mob_spawner(const resources::creature_info& infos_, int level_);
 
 	void tick(world_proxy& world) noexcept override;
 
@@ -33,6 +33,10 @@ class mob_spawner final : public creature {
 
 	void interact_with(player&) noexcept override {}
 
+	dungeep::pool_ref<world_object> ref() const noexcept override {
+		return dungeep::pool_ref<world_object>::to(*this);
+	}
+
 	int sleep() noexcept override;
 
 	~mob_spawner() override;
@@ -26,7 +26,7 @@
 class fixed_effect;
 class dynamic_effect;
 
-class player final : public creature {
+class player final : public creature, public dungeep::pool_allocated<player> {
 public:
 	// return 0 when dead ?
 	int sleep() noexcept override;
@@ -39,6 +39,10 @@ public:
 
 	void interact_with(player&) noexcept override {}
 
+	dungeep::pool_ref<world_object> ref() const noexcept override {
+		return dungeep::pool_ref<world_object>::to(*this);
+	}
+
 	void true_hit(int damage) noexcept override;
 
 	void move(dungeep::area_f) noexcept;
@@ -21,6 +21,7 @@
 #include <memory>
 
 #include "utils/geometry.hpp"
+#include "utils/object_pool.hpp"
 
 namespace sf {
 	class RenderWindow;
@@ -71,6 +72,9 @@ public:
 
 	virtual void interact_with(player&) noexcept = 0;
 
+	// generation checked reference to this object, which lives in the pool of its class (see dungeep::pool_allocated)
+	[[nodiscard]] virtual dungeep::pool_ref<world_object> ref() const noexcept = 0;
+
 	virtual ~world_object() = default;
 
 protected:
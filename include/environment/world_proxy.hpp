@@ -1,13 +1,17 @@
 #ifndef DUNGEEP_WORLD_PROXY_HPP
 #define DUNGEEP_WORLD_PROXY_HPP
 
+#include <functional>
 #include <memory>
+#include <tuple>
+#include <variant>
 #include <vector>
 #include <random>
 #include <spdlog/spdlog.h>
 
 #include "world.hpp"
 #include "tiles.hpp"
+#include "damage_buffer.hpp"
 
 class world_object;
 class creature;
@@ -20,36 +24,74 @@ namespace dungeep {
 	template <typename>
 	struct point;
 	using point_i = point<int>;
+	using point_f = point<float>;
 }
 
 class world_proxy {
 	friend class world;
 public:
-	explicit world_proxy(world& w) noexcept : tied_world(w) {}
+	explicit world_proxy(world& w) noexcept : tied_world(w), random_engine(&w.shared_random) {}
 
-	std::mt19937_64& world_shared_random_engine() {
-		return tied_world.shared_random;
+	// proxy of a batch of objects ticked in parallel with others: draws from its own engine, so that the results do not
+	// depend on how batches are scheduled
+	world_proxy(world& w, dungeep::default_engine::result_type seed) noexcept : tied_world(w), batch_random(seed), random_engine(&batch_random) {}
+
+	world_proxy(const world_proxy&) = delete;
+	world_proxy& operator=(const world_proxy&) = delete;
+
+	dungeep::default_engine& world_shared_random_engine() {
+		return *random_engine;
 	}
 
-	std::mt19937_64::result_type world_shared_rand() {
+	dungeep::default_engine::result_type world_shared_rand() {
 		return world_shared_random_engine()();
 	}
 
+	// reproducible randoms of an entity (see creature::entity_id()), for this tick
+	[[nodiscard]] dungeep::philox4x32 entity_random(std::uint32_t entity) const noexcept {
+		return tied_world.entity_random(entity);
+	}
+
+	// adds an object built beforehand, which must not allocate entities (see spawn)
 	void create_entity(std::unique_ptr<world_object>&& ptr) {
 		auto center = ptr->hitbox().center();
 		spdlog::debug("New entity will be added to world (at [{}, {}])", center.x, center.y);
 		new_objects.emplace_back(std::move(ptr));
 	}
 
+	/**
+	 * Adds an Object built from copies of 'args' once every object ticked, by the world, in strip order: entity ids and pool
+	 * slots are then handed out in the same order whatever the number of threads.
+	 */
+	template <typename Object, typename... Args>
+	void spawn(Args&&... args) {
+		spdlog::debug("New entity will be spawned in world");
+		new_objects.emplace_back(object_factory{[args = std::make_tuple(std::forward<Args>(args)...)] {
+			return std::apply([](const auto&... object_args) -> std::unique_ptr<world_object> {
+				return std::make_unique<Object>(object_args...);
+			}, args);
+		}});
+	}
+
 	void delete_entity(world_object* ptr) {
 		auto center = ptr->hitbox().center();
 		spdlog::debug("Entity at [{}, {}] will be removed from world.", center.x, center.y);
-		deleted_objects.emplace_back(ptr);
+		deleted_objects.emplace_back(ptr->ref());
+	}
+
+	// the damage is applied at the end of the tick, with the others dealt to the same target
+	void deal_damage(creature& target, damage_type type, int amount, int penetration = 0) {
+		damages.push(target, type, amount, penetration);
 	}
 
 	template <typename Pred>
 	std::vector<std::unique_ptr<world_object>> find_targets(const dungeep::area_f& area, Pred&& predicate);
 
+	// returns the first dynamic object met on the segment [from ; to] for which 'predicate' returned true.
+	// walls stop the segment. returns nullptr if nothing was hit.
+	template <typename Pred>
+	dynamic_object* cast_ray(const dungeep::point_f& from, const dungeep::point_f& to, Pred&& predicate);
+
 	std::vector<dungeep::point_i> find_path(const dungeep::point_i& dep, const dungeep::point_i& arr, int max_depth = 30) const;
 
 	tiles operator()(int x, int y) const;
@@ -60,9 +102,21 @@ public:
 
 private:
 	world& tied_world;
+	dungeep::default_engine batch_random{};
+	dungeep::default_engine* random_engine;
 
-	std::vector<std::unique_ptr<world_object>> new_objects{};
-	std::vector<world_object*> deleted_objects{};
+	using object_factory = std::function<std::unique_ptr<world_object>()>;
+	std::vector<std::variant<std::unique_ptr<world_object>, object_factory>> new_objects{};
+	std::vector<dungeep::pool_ref<world_object>> deleted_objects{};
+	damage_buffer damages{};
 };
 
+template <typename Pred>
+dynamic_object* world_proxy::cast_ray(const dungeep::point_f& from, const dungeep::point_f& to, Pred&& predicate) {
+	auto it = tied_world.shared_map.cast_ray(tied_world.dynamic_objects, from, to, [&predicate](auto& object) {
+		return predicate(*object);
+	});
+	return it == tied_world.dynamic_objects.end() ? nullptr : it->get().get();
+}
+
 #endif //DUNGEEP_WORLD_PROXY_HPP
@@ -0,0 +1,113 @@
+#ifndef DUNGEEP_BUFF_SET_HPP
+#define DUNGEEP_BUFF_SET_HPP
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///                                                                                                                                     ///
+///  Copyright C 2019, Lucas Lazare                                                                                                     ///
+///  Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation         ///
+///  		files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy,  ///
+///  modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software     ///
+///  		is furnished to do so, subject to the following conditions:                                                                 ///
+///                                                                                                                                     ///
+///  The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.     ///
+///                                                                                                                                     ///
+///  The Software is provided “as is”, without warranty of any kind, express or implied, including but not limited to the               ///
+///  warranties of merchantability, fitness for a particular purpose and noninfringement. In no event shall the authors or              ///
+///  copyright holders be liable for any claim, damages or other liability, whether in an action of contract, tort or otherwise,        ///
+///  arising from, out of or in connection with the software or the use or other dealings in the Software.                              ///
+///                                                                                                                                     ///
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <memory>
+#include <vector>
+
+#include "iconned/fixed.hpp"
+#include "iconned/dynamic.hpp"
+
+/**
+ * Buffs held by a creature, along with what hits need from them, kept up to date by add and remove:
+ * the sum of the stats of every buff, and for each hook the dynamic buffs implementing it, in the order they were added.
+ */
+class buff_set {
+public:
+	void add(std::unique_ptr<fixed_effect>&& effect) {
+		bonuses_ += effect->stats();
+		if (effect->is_dynamic()) {
+			auto dyn_effect = dynamic_cast<dynamic_effect*>(effect.release());
+			assert(dyn_effect);
+			dynamic_buffs_.emplace_back(dyn_effect);
+
+			const unsigned int hooks = dyn_effect->hooks();
+			for (auto hook = 0u ; hook < buffs_by_hook_.size() ; ++hook) {
+				if (hooks & effect_hook_bit(static_cast<effect_hook>(hook))) {
+					buffs_by_hook_[hook].push_back(dyn_effect);
+				}
+			}
+		} else {
+			fixed_buffs_.emplace_back(std::move(effect));
+		}
+	}
+
+	/**
+	 * Destroys 'effect'. Returns false, leaving the set untouched, if 'effect' is not in the set (it may then be dangling,
+	 * as when it is removed twice: it is not dereferenced).
+	 */
+	bool remove(const fixed_effect* effect) noexcept {
+		auto is_effect = [effect](const auto& u_ptr) {
+			return u_ptr.get() == effect;
+		};
+
+		auto fixed_it = std::find_if(fixed_buffs_.begin(), fixed_buffs_.end(), is_effect);
+		if (fixed_it != fixed_buffs_.end()) {
+			bonuses_ -= (*fixed_it)->stats();
+			swap_and_pop(fixed_buffs_, fixed_it);
+			return true;
+		}
+
+		auto dynamic_it = std::find_if(dynamic_buffs_.begin(), dynamic_buffs_.end(), is_effect);
+		if (dynamic_it != dynamic_buffs_.end()) {
+			bonuses_ -= (*dynamic_it)->stats();
+			for (std::vector<dynamic_effect*>& hooked : buffs_by_hook_) {
+				// kept in insertion order, as hooks are applied one after the other
+				hooked.erase(std::remove(hooked.begin(), hooked.end(), dynamic_it->get()), hooked.end());
+			}
+			swap_and_pop(dynamic_buffs_, dynamic_it);
+			return true;
+		}
+		return false;
+	}
+
+	// sum of the stats of every buff, fixed and dynamic
+	[[nodiscard]] const effect_stats& bonuses() const noexcept {
+		return bonuses_;
+	}
+
+	// dynamic buffs implementing 'hook', in the order they were added
+	[[nodiscard]] const std::vector<dynamic_effect*>& hooked(effect_hook hook) const noexcept {
+		return buffs_by_hook_[static_cast<unsigned int>(hook)];
+	}
+
+	[[nodiscard]] std::size_t size() const noexcept {
+		return fixed_buffs_.size() + dynamic_buffs_.size();
+	}
+
+private:
+	template <typename T>
+	static void swap_and_pop(std::vector<T>& vect, typename std::vector<T>::iterator it) noexcept {
+		if (std::next(it) != vect.end()) {
+			*it = std::move(vect.back());
+		}
+		vect.pop_back();
+	}
+
+	std::vector<std::unique_ptr<fixed_effect>> fixed_buffs_{};
+	std::vector<std::unique_ptr<dynamic_effect>> dynamic_buffs_{};
+
+	effect_stats bonuses_{};
+	std::array<std::vector<dynamic_effect*>, static_cast<unsigned int>(effect_hook::count)> buffs_by_hook_{};
+};
+
+#endif //DUNGEEP_BUFF_SET_HPP
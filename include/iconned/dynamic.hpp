@@ -29,8 +29,28 @@ namespace Json {
 class player;
 class world_proxy;
 
+// Methods of dynamic_effect called when a creature computes its damages and cooldowns
+enum class effect_hook : unsigned int {
+	cooldown,
+	input_physical_damage,
+	input_magical_damage,
+	input_true_damage,
+	output_physical_damage,
+	output_magical_damage,
+	output_true_damage,
+	ignored_armor,
+	ignored_resist,
+	count
+};
+
+constexpr unsigned int effect_hook_bit(effect_hook hook) noexcept {
+	return 1u << static_cast<unsigned int>(hook);
+}
+
 class dynamic_effect : public fixed_effect {
 public:
+	using fixed_effect::fixed_effect;
+
 	virtual int update_cooldown_once(int current_cooldown) noexcept = 0;
 	virtual int update_input_physical_damage(int input) noexcept = 0;
 	virtual int update_input_magical_damage(int input) noexcept = 0;
@@ -43,6 +63,11 @@ public:
 
 	virtual void tick(player&, world_proxy&) noexcept = 0;
 
+	// set of effect_hook_bit() of the hooks that actually change their input: the others are not called
+	virtual unsigned int hooks() const noexcept {
+		return effect_hook_bit(effect_hook::count) - 1;
+	}
+
 	// TODO should be final and not override, but compiler is stupid.
 	bool is_dynamic() const noexcept override {
 		return true;
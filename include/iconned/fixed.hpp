@@ -48,6 +48,51 @@ namespace details {
 	};
 }
 
+// Sum of the bonuses given by fixed effects
+struct effect_stats {
+	int hp{0};
+	int armor{0};
+	int resist{0};
+	int physical_damage{0};
+	int magical_damage{0};
+	int attack_speed{0}; // percent
+	int physical_crit_chance{0};
+	int magical_crit_chance{0};
+	float move_speed{0.f};
+	int ignored_armor{0};
+	int ignored_resist{0};
+
+	effect_stats& operator+=(const effect_stats& other) noexcept {
+		hp += other.hp;
+		armor += other.armor;
+		resist += other.resist;
+		physical_damage += other.physical_damage;
+		magical_damage += other.magical_damage;
+		attack_speed += other.attack_speed;
+		physical_crit_chance += other.physical_crit_chance;
+		magical_crit_chance += other.magical_crit_chance;
+		move_speed += other.move_speed;
+		ignored_armor += other.ignored_armor;
+		ignored_resist += other.ignored_resist;
+		return *this;
+	}
+
+	effect_stats& operator-=(const effect_stats& other) noexcept {
+		hp -= other.hp;
+		armor -= other.armor;
+		resist -= other.resist;
+		physical_damage -= other.physical_damage;
+		magical_damage -= other.magical_damage;
+		attack_speed -= other.attack_speed;
+		physical_crit_chance -= other.physical_crit_chance;
+		magical_crit_chance -= other.magical_crit_chance;
+		move_speed -= other.move_speed;
+		ignored_armor -= other.ignored_armor;
+		ignored_resist -= other.ignored_resist;
+		return *this;
+	}
+};
+
 class fixed_effect : public iconned {
 	// TODO: systèmes d'ensemble > rajout d'un effet dynamique "global" à l'équipement du premier ensemble ?
 	//  classe spéciale d'ensemble qui génère par la suite un/des effets dynamiques ?
@@ -61,17 +106,7 @@ public:
 
 	fixed_effect(std::string&& name_, defense def, attack atk, critics crit, misc m)
 		: name(std::move(name_))
-		, physical_crit_chance_(crit.physic)
-		, magical_crit_chance_(crit.magic)
-		, physical_damage_bonus_(atk.physic)
-		, magical_damage_bonus_(atk.magic)
-		, move_speed_bonus_(m.move_speed)
-		, attack_speed_bonus_(atk.speed)
-		, armor_bonus_(def.armor)
-		, resist_bonus_(def.resist)
-		, hp_bonus_(def.hp)
-		, ignored_armor_(m.armor_pen)
-		, ignored_resist_(m.resist_pen)
+		, stats_{def.hp, def.armor, def.resist, atk.physic, atk.magic, atk.speed, crit.physic, crit.magic, m.move_speed, m.armor_pen, m.resist_pen}
 		{}
 
 	std::string_view get_tooltip() const noexcept override { /* todo */ return {}; }
@@ -85,48 +120,53 @@ public:
 	}
 
 
+	// all of the bonuses at once, to be summed by the effect holder
+	const effect_stats& stats() const noexcept {
+		return stats_;
+	}
+
 	int physical_crit_chance() const noexcept {
-		return physical_crit_chance_;
+		return stats_.physical_crit_chance;
 	}
 
 	int magical_crit_chance() const noexcept {
-		return magical_crit_chance_;
+		return stats_.magical_crit_chance;
 	}
 
 	int physical_damage_bonus() const noexcept {
-		return physical_damage_bonus_;
+		return stats_.physical_damage;
 	}
 
 	int magical_damage_bonus() const noexcept {
-		return magical_damage_bonus_;
+		return stats_.magical_damage;
 	}
 
 	float move_speed_bonus() const noexcept {
-		return move_speed_bonus_;
+		return stats_.move_speed;
 	}
 
 	int attack_speed_bonus() const noexcept { // percent
-		return attack_speed_bonus_;
+		return stats_.attack_speed;
 	}
 
 	int armor_bonus() const noexcept {
-		return armor_bonus_;
+		return stats_.armor;
 	}
 
 	int resist_bonus() const noexcept {
-		return resist_bonus_;
+		return stats_.resist;
 	}
 
 	int hp_bonus() const noexcept {
-		return hp_bonus_;
+		return stats_.hp;
 	}
 
 	int ignored_armor() const noexcept {
-		return ignored_armor_;
+		return stats_.ignored_armor;
 	}
 
 	int ignored_resist() const noexcept {
-		return ignored_resist_;
+		return stats_.ignored_resist;
 	}
 
 
@@ -139,17 +179,7 @@ public:
 private:
 	std::string name;
 
-	int physical_crit_chance_;
-	int magical_crit_chance_;
-	int physical_damage_bonus_;
-	int magical_damage_bonus_;
-	float move_speed_bonus_;
-	int attack_speed_bonus_;
-	int armor_bonus_;
-	int resist_bonus_;
-	int hp_bonus_;
-	int ignored_armor_;
-	int ignored_resist_;
+	effect_stats stats_;
 
 };
 
@@ -0,0 +1,114 @@
+#ifndef DUNGEEP_CHUNKED_STORAGE_HPP
+#define DUNGEEP_CHUNKED_STORAGE_HPP
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///                                                                                                                                     ///
+///  Copyright C 2019, Lucas Lazare                                                                                                     ///
+///  Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation         ///
+///  		files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy,  ///
+///  modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software     ///
+///  		is furnished to do so, subject to the following conditions:                                                                 ///
+///                                                                                                                                     ///
+///  The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.     ///
+///                                                                                                                                     ///
+///  The Software is provided “as is”, without warranty of any kind, express or implied, including but not limited to the               ///
+///  warranties of merchantability, fitness for a particular purpose and noninfringement. In no event shall the authors or              ///
+///  copyright holders be liable for any claim, damages or other liability, whether in an action of contract, tort or otherwise,        ///
+///  arising from, out of or in connection with the software or the use or other dealings in the Software.                              ///
+///                                                                                                                                     ///
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace dungeep {
+
+	/**
+	 * Slots stored by chunks of ChunkSize, allocated on demand and never moved nor freed, with a free list of the released slots
+	 * Slot i lives in chunk(i), at offset(i). Chunk is expected to hold ChunkSize slots in whatever layout it likes
+	 * (array of structures for object_pool, structure of arrays for creature_components).
+	 *
+	 * acquire and release are guarded by a mutex. The chunks of the slots [0 ; used()[ may be read from any thread.
+	 */
+	template <typename Chunk, std::size_t ChunkSize, std::size_t MaxChunks>
+	class chunked_storage {
+	public:
+		using index_type = std::uint32_t;
+
+		chunked_storage() noexcept = default;
+		chunked_storage(const chunked_storage&) = delete;
+		chunked_storage& operator=(const chunked_storage&) = delete;
+
+		/**
+		 * Index of a free slot, released slots being reused first. 'init(index)' is called before the mutex is unlocked.
+		 * Throws std::bad_alloc once ChunkSize * MaxChunks slots are used
+		 */
+		template <typename FuncT>
+		[[nodiscard]] index_type acquire(FuncT&& init) {
+			std::lock_guard lock{mutex_};
+
+			index_type index;
+			if (!free_.empty()) {
+				index = free_.back();
+				free_.pop_back();
+			} else {
+				index = used_.load(std::memory_order_relaxed);
+				if (index == ChunkSize * MaxChunks) {
+					throw std::bad_alloc{};
+				}
+				if (index % ChunkSize == 0) {
+					free_.reserve(index + ChunkSize); // room for every slot: release never allocates
+					chunks_[index / ChunkSize] = std::make_unique<Chunk>();
+				}
+				used_.store(index + 1, std::memory_order_release);
+			}
+
+			init(index);
+			++acquired_;
+			return index;
+		}
+
+		// 'fini(index)' is called before the mutex is unlocked. The free list was reserved by acquire: nothing here can throw.
+		template <typename FuncT>
+		void release(index_type index, FuncT&& fini) noexcept {
+			std::lock_guard lock{mutex_};
+			fini(index);
+			--acquired_;
+			free_.push_back(index);
+		}
+
+		[[nodiscard]] Chunk& chunk(index_type index) const noexcept {
+			return *chunks_[index / ChunkSize];
+		}
+
+		[[nodiscard]] static constexpr std::size_t offset(index_type index) noexcept {
+			return index % ChunkSize;
+		}
+
+		// slots [0 ; used()[ have been acquired at least once
+		[[nodiscard]] index_type used() const noexcept {
+			return used_.load(std::memory_order_acquire);
+		}
+
+		// number of slots currently acquired
+		[[nodiscard]] std::size_t size() const {
+			std::lock_guard lock{mutex_};
+			return acquired_;
+		}
+
+	private:
+		std::array<std::unique_ptr<Chunk>, MaxChunks> chunks_{};
+		std::atomic<index_type> used_{0};
+		std::vector<index_type> free_{};
+		std::size_t acquired_{0};
+		mutable std::mutex mutex_{};
+	};
+}
+
+#endif //DUNGEEP_CHUNKED_STORAGE_HPP
@@ -0,0 +1,221 @@
+#ifndef DUNGEEP_FLAT_QUADTREE_HPP
+#define DUNGEEP_FLAT_QUADTREE_HPP
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///                                                                                                                                     ///
+///  Copyright C 2019, Lucas Lazare                                                                                                     ///
+///  Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation         ///
+///  		files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy,  ///
+///  modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software     ///
+///  		is furnished to do so, subject to the following conditions:                                                                 ///
+///                                                                                                                                     ///
+///  The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.     ///
+///                                                                                                                                     ///
+///  The Software is provided “as is”, without warranty of any kind, express or implied, including but not limited to the               ///
+///  warranties of merchantability, fitness for a particular purpose and noninfringement. In no event shall the authors or              ///
+///  copyright holders be liable for any claim, damages or other liability, whether in an action of contract, tort or otherwise,        ///
+///  arising from, out of or in connection with the software or the use or other dealings in the Software.                              ///
+///                                                                                                                                     ///
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+#include <iterator>
+#include <utility>
+
+#include "geometry.hpp"
+#include "hitbox_soa.hpp"
+
+namespace dungeep {
+
+	/**
+	 * Quadtree of fixed depth, with all of its (4^(Depth+1) - 1) / 3 nodes laid out in a single array
+	 * Nodes of a level form a 2^level x 2^level grid, stored row by row after the nodes of the previous levels, so that
+	 * parents, children and the nodes crossed by an area are found with index arithmetic only.
+	 * Elements are stored in the deepest node fully containing their hitbox.
+	 *
+	 * Replaces quadtree<T, quadtree_dynamics::static_children> when the depth is known at compile time.
+	 * T, Container and Coord have the same requirements as for quadtree.
+	 */
+	template <typename T, unsigned int Depth, template <typename...> typename Container = std::vector, typename Coord = float>
+	class flat_quadtree {
+		template <typename, typename, typename>
+		struct iterator_type;
+
+	public:
+
+		using container = Container<T>;
+		using value_type = typename container::value_type;
+		using allocator_type = typename container::allocator_type;
+		using size_type = typename container::size_type;
+		using difference_type = typename container::difference_type;
+		using reference = typename container::reference;
+		using const_reference = typename container::const_reference;
+		using pointer = typename container::pointer;
+		using const_pointer = typename container::const_pointer;
+		using iterator = iterator_type<flat_quadtree<T,Depth,Container,Coord>, value_type, typename container::iterator>;
+		using const_iterator = iterator_type<const flat_quadtree<T,Depth,Container,Coord>, const value_type, typename container::const_iterator>;
+
+		using area = dungeep::area<Coord>;
+		using point = dungeep::point<Coord>;
+
+		static_assert(Depth < 16, "node indexes would overflow");
+
+		// index of the first node of a level
+		static constexpr size_type level_begin(unsigned int level) noexcept {
+			return ((size_type{1} << (2 * level)) - 1) / 3;
+		}
+
+		static constexpr size_type node_count = level_begin(Depth + 1);
+
+		static constexpr size_type parent_of(size_type node, unsigned int level) noexcept {
+			const size_type side = size_type{1} << level;
+			const size_type pos = node - level_begin(level);
+			return level_begin(level - 1) + (pos / side / 2) * (side / 2) + (pos % side) / 2;
+		}
+
+		// top left child, the others being at +1, +2^(level+1) and +2^(level+1)+1
+		static constexpr size_type first_child_of(size_type node, unsigned int level) noexcept {
+			const size_type side = size_type{1} << level;
+			const size_type pos = node - level_begin(level);
+			return level_begin(level + 1) + (pos / side) * 4 * side + (pos % side) * 2;
+		}
+
+	public:
+		explicit flat_quadtree(const area& ar);
+
+		[[nodiscard]] iterator begin() noexcept;
+		[[nodiscard]] const_iterator begin() const noexcept;
+		[[nodiscard]] const_iterator cbegin() const noexcept;
+
+		[[nodiscard]] iterator end() noexcept;
+		[[nodiscard]] const_iterator end() const noexcept;
+		[[nodiscard]] const_iterator cend() const noexcept;
+
+		/**
+		 * Inserts an element, given its '.hitbox()' location
+		 * Iterators are invalidated
+		 */
+		iterator insert(const value_type& value);
+
+		/**
+		 * Iterators are invalidated
+		 */
+		template <typename... Args>
+		iterator emplace(const area& target, Args&&... args);
+
+		/**
+		 * Visits all elements on the given area
+		 * The visitor function should not attempt to insert or remove an element in or from the collection.
+		 * If the visitor returns true, the element is safely deleted (iterators are invalidated).
+		 */
+		template <typename FuncT>
+		std::enable_if_t<std::is_invocable_v<FuncT, iterator>>
+		visit(const area& target, FuncT&& visitor) noexcept(std::is_nothrow_invocable_v<FuncT, iterator>);
+
+		/**
+		 * Thread-safe: several threads may visit the tree concurrently, as long as none of them modifies it.
+		 */
+		template <typename FuncT>
+		std::enable_if_t<std::is_invocable_v<FuncT, const_iterator>>
+		visit(const area& target, FuncT&& visitor) const noexcept(std::is_nothrow_invocable_v<FuncT, const_iterator>);
+
+		[[nodiscard]] bool empty() const noexcept;
+
+		[[nodiscard]] size_type size() const noexcept;
+
+		void clear() noexcept(noexcept(container().clear()));
+
+		/**
+		 * returns the element right after the erased one
+		 * Iterators are invalidated
+		 */
+		iterator erase(iterator it);
+		iterator erase(const_iterator it);
+		void erase(const T&);
+
+		/**
+		 * Returns true if at least one element is at least partially present in the given area
+		 */
+		[[nodiscard]] bool has_collision(const area& ar) const noexcept;
+
+		/**
+		 * Same as without 'pred', but the colliding element must be an argument for which pred returned true
+		 * 'pred' should take 'T&'/'const T&' as single parameter.
+		 */
+		template <typename FuncT>
+		[[nodiscard]] bool has_collision_if(const area& ar, FuncT&& pred) noexcept(std::is_nothrow_invocable_v<FuncT, T&>);
+		template <typename FuncT>
+		[[nodiscard]] bool has_collision_if(const area& ar, FuncT&& pred) const noexcept(std::is_nothrow_invocable_v<FuncT, const T&>);
+
+		/**
+		 * Iterators are invalidated
+		 */
+		[[nodiscard]] T extract(iterator element);
+		[[nodiscard]] T extract(const_iterator element);
+
+		[[nodiscard]] iterator find(const T& element) noexcept;
+		[[nodiscard]] const_iterator find(const T& element) const noexcept;
+
+		/**
+		 * Iterators are invalidated
+		 */
+		void move(iterator it, const area& new_area);
+		void move(const T& element, const area& new_area);
+		void move(const_iterator it, const area& new_area);
+
+	private:
+
+		struct node {
+			container values{};
+			hitbox_soa<Coord> hitboxes{}; // hitboxes[i] is the location of values[i]
+		};
+
+		// inclusive bounds, in nodes of the deepest level
+		struct cell_range {
+			size_type min_x;
+			size_type min_y;
+			size_type max_x;
+			size_type max_y;
+		};
+
+		[[nodiscard]] cell_range cells_of(const area& ar) const noexcept;
+
+		[[nodiscard]] size_type node_of(const area& hitbox) const noexcept;
+
+		// replaces the value at 'idx' by the last value of the node
+		void erase_value_at(node& n, size_type idx);
+
+		template <typename IteratorType>
+		iterator erase_impl(IteratorType it);
+
+		template <typename IteratorType>
+		T extract_impl(IteratorType element);
+
+		template <typename IteratorType>
+		void move_impl(IteratorType it, const area& new_area);
+
+		template <typename IteratorType, typename Tree>
+		static IteratorType find_impl(Tree& tree, const T& element);
+
+		template <typename IteratorType, typename Tree, typename FuncT>
+		static void visit_impl(Tree& tree, const area& target, FuncT& visitor);
+
+		template <typename Tree, typename FuncT>
+		static bool has_collision_impl(Tree& tree, const area& ar, FuncT& pred);
+
+		area area_;
+		dungeep::point<float> scale_; // deepest level nodes per unit
+		size_type size_{0};
+
+		std::vector<node> nodes_;
+
+		friend const_iterator;
+		friend iterator;
+	};
+}
+
+
+#include "flat_quadtree.tpp"
+
+
+#endif //DUNGEEP_FLAT_QUADTREE_HPP
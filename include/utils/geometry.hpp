@@ -123,6 +123,9 @@ struct area {
 
 	constexpr bool collides_with(const area& other) const noexcept;
 
+	// returns the position, in [0 ; 1], at which the segment [from ; to] enters this area, or a negative value if it does not cross it
+	constexpr float segment_entry(const point<T>& from, const point<T>& to) const noexcept;
+
 	constexpr void assert_well_formed() const noexcept;
 
 	constexpr point<T> center() const noexcept;
@@ -0,0 +1,89 @@
+#ifndef DUNGEEP_HASH_HPP
+#define DUNGEEP_HASH_HPP
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///                                                                                                                                     ///
+///  Copyright C 2019, Lucas Lazare                                                                                                     ///
+///  Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation         ///
+///  		files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy,  ///
+///  modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software     ///
+///  		is furnished to do so, subject to the following conditions:                                                                 ///
+///                                                                                                                                     ///
+///  The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.     ///
+///                                                                                                                                     ///
+///  The Software is provided “as is”, without warranty of any kind, express or implied, including but not limited to the               ///
+///  warranties of merchantability, fitness for a particular purpose and noninfringement. In no event shall the authors or              ///
+///  copyright holders be liable for any claim, damages or other liability, whether in an action of contract, tort or otherwise,        ///
+///  arising from, out of or in connection with the software or the use or other dealings in the Software.                              ///
+///                                                                                                                                     ///
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+
+namespace dungeep {
+
+	/**
+	 * 64 bits FNV-1a (Fowler, Noll, Vo), fed incrementally
+	 * Not cryptographic: meant for content keys and checksums. Values are fed as little endian bytes, so that a hash does not
+	 * depend on the platform it was computed on.
+	 */
+	class fnv1a {
+	public:
+		static constexpr std::uint64_t offset_basis = 0xCBF29CE484222325u;
+		static constexpr std::uint64_t prime = 0x100000001B3u;
+
+		constexpr fnv1a& add_bytes(const unsigned char* data, std::size_t size) noexcept {
+			for (std::size_t i = 0 ; i < size ; ++i) {
+				add_byte(data[i]);
+			}
+			return *this;
+		}
+
+		constexpr fnv1a& add(std::string_view str) noexcept {
+			for (char c : str) {
+				add_byte(static_cast<unsigned char>(c));
+			}
+			return *this;
+		}
+
+		template <typename T, typename = std::enable_if_t<std::is_arithmetic_v<T> || std::is_enum_v<T>>>
+		constexpr fnv1a& add(T value) noexcept {
+			if constexpr (std::is_enum_v<T>) {
+				return add(static_cast<std::underlying_type_t<T>>(value));
+			} else if constexpr (std::is_same_v<T, bool>) {
+				return add_byte(value ? 1u : 0u);
+			} else if constexpr (std::is_floating_point_v<T>) {
+				static_assert(sizeof(T) == sizeof(std::uint32_t) || sizeof(T) == sizeof(std::uint64_t), "unsupported floating point type");
+				using bits_type = std::conditional_t<sizeof(T) == sizeof(std::uint32_t), std::uint32_t, std::uint64_t>;
+				bits_type bits{};
+				std::memcpy(&bits, &value, sizeof(T));
+				return add(bits);
+			} else {
+				auto bits = static_cast<std::make_unsigned_t<T>>(value);
+				for (std::size_t i = 0 ; i < sizeof(T) ; ++i) {
+					add_byte(static_cast<unsigned char>(bits & 0xFFu));
+					bits = static_cast<std::make_unsigned_t<T>>(bits >> 8u);
+				}
+				return *this;
+			}
+		}
+
+		[[nodiscard]] constexpr std::uint64_t value() const noexcept {
+			return hash_;
+		}
+
+	private:
+		constexpr fnv1a& add_byte(unsigned char byte) noexcept {
+			hash_ ^= byte;
+			hash_ *= prime;
+			return *this;
+		}
+
+		std::uint64_t hash_{offset_basis};
+	};
+}
+
+#endif //DUNGEEP_HASH_HPP
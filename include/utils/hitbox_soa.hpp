@@ -0,0 +1,173 @@
+#ifndef DUNGEEP_HITBOX_SOA_HPP
+#define DUNGEEP_HITBOX_SOA_HPP
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///                                                                                                                                     ///
+///  Copyright C 2019, Lucas Lazare                                                                                                     ///
+///  Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation         ///
+///  		files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy,  ///
+///  modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software     ///
+///  		is furnished to do so, subject to the following conditions:                                                                 ///
+///                                                                                                                                     ///
+///  The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.     ///
+///                                                                                                                                     ///
+///  The Software is provided “as is”, without warranty of any kind, express or implied, including but not limited to the               ///
+///  warranties of merchantability, fitness for a particular purpose and noninfringement. In no event shall the authors or              ///
+///  copyright holders be liable for any claim, damages or other liability, whether in an action of contract, tort or otherwise,        ///
+///  arising from, out of or in connection with the software or the use or other dealings in the Software.                              ///
+///                                                                                                                                     ///
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+
+#if defined(__AVX__)
+#	include <immintrin.h>
+#	define DUNGEEP_HITBOX_SOA_AVX
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#	include <xmmintrin.h>
+#	define DUNGEEP_HITBOX_SOA_SSE
+#endif
+
+#include "geometry.hpp"
+
+namespace dungeep {
+
+	// Structure of arrays copy of a list of hitboxes, so that several of them can be tested against an area at once
+	// (8 per instruction with AVX, 4 with SSE, when Coord is float).
+	template <typename Coord>
+	class hitbox_soa {
+	public:
+		using size_type = std::size_t;
+
+		void push_back(const area<Coord>& ar) {
+			min_x_.push_back(ar.top_left.x);
+			min_y_.push_back(ar.top_left.y);
+			max_x_.push_back(ar.bot_right.x);
+			max_y_.push_back(ar.bot_right.y);
+		}
+
+		void set(size_type idx, const area<Coord>& ar) noexcept {
+			assert(idx < size());
+			min_x_[idx] = ar.top_left.x;
+			min_y_[idx] = ar.top_left.y;
+			max_x_[idx] = ar.bot_right.x;
+			max_y_[idx] = ar.bot_right.y;
+		}
+
+		// replaces the hitbox at 'idx' with the last one, mirroring the way elements are erased in the quadtree
+		void erase_by_swap(size_type idx) noexcept {
+			assert(idx < size());
+			min_x_[idx] = min_x_.back();
+			min_y_[idx] = min_y_.back();
+			max_x_[idx] = max_x_.back();
+			max_y_[idx] = max_y_.back();
+			min_x_.pop_back();
+			min_y_.pop_back();
+			max_x_.pop_back();
+			max_y_.pop_back();
+		}
+
+		void clear() noexcept {
+			min_x_.clear();
+			min_y_.clear();
+			max_x_.clear();
+			max_y_.clear();
+		}
+
+		void reserve(size_type sz) {
+			min_x_.reserve(sz);
+			min_y_.reserve(sz);
+			max_x_.reserve(sz);
+			max_y_.reserve(sz);
+		}
+
+		[[nodiscard]] size_type size() const noexcept {
+			return min_x_.size();
+		}
+
+		// heap memory held by this object
+		[[nodiscard]] std::size_t allocated_bytes() const noexcept {
+			return (min_x_.capacity() + min_y_.capacity() + max_x_.capacity() + max_y_.capacity()) * sizeof(Coord);
+		}
+
+		[[nodiscard]] area<Coord> operator[](size_type idx) const noexcept {
+			assert(idx < size());
+			return {{min_x_[idx], min_y_[idx]}, {max_x_[idx], max_y_[idx]}};
+		}
+
+		/**
+		 * Returns the index of the first hitbox, starting from 'first', colliding with 'target'.
+		 * Returns size() if there is none
+		 */
+		[[nodiscard]] size_type find_collision(const area<Coord>& target, size_type first) const noexcept {
+			const size_type sz = size();
+
+			if constexpr (std::is_same_v<Coord, float>) {
+#if defined(DUNGEEP_HITBOX_SOA_AVX)
+				const __m256 t_min_x = _mm256_set1_ps(target.top_left.x);
+				const __m256 t_min_y = _mm256_set1_ps(target.top_left.y);
+				const __m256 t_max_x = _mm256_set1_ps(target.bot_right.x);
+				const __m256 t_max_y = _mm256_set1_ps(target.bot_right.y);
+
+				for (; first + 8 <= sz ; first += 8) {
+					__m256 hits = _mm256_and_ps(
+							_mm256_and_ps(_mm256_cmp_ps(_mm256_loadu_ps(&min_x_[first]), t_max_x, _CMP_LE_OQ),
+							              _mm256_cmp_ps(t_min_x, _mm256_loadu_ps(&max_x_[first]), _CMP_LE_OQ)),
+							_mm256_and_ps(_mm256_cmp_ps(_mm256_loadu_ps(&min_y_[first]), t_max_y, _CMP_LE_OQ),
+							              _mm256_cmp_ps(t_min_y, _mm256_loadu_ps(&max_y_[first]), _CMP_LE_OQ)));
+					auto mask = static_cast<unsigned int>(_mm256_movemask_ps(hits));
+					if (mask != 0) {
+						return first + lowest_bit(mask);
+					}
+				}
+#elif defined(DUNGEEP_HITBOX_SOA_SSE)
+				const __m128 t_min_x = _mm_set1_ps(target.top_left.x);
+				const __m128 t_min_y = _mm_set1_ps(target.top_left.y);
+				const __m128 t_max_x = _mm_set1_ps(target.bot_right.x);
+				const __m128 t_max_y = _mm_set1_ps(target.bot_right.y);
+
+				for (; first + 4 <= sz ; first += 4) {
+					__m128 hits = _mm_and_ps(
+							_mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(&min_x_[first]), t_max_x),
+							           _mm_cmple_ps(t_min_x, _mm_loadu_ps(&max_x_[first]))),
+							_mm_and_ps(_mm_cmple_ps(_mm_loadu_ps(&min_y_[first]), t_max_y),
+							           _mm_cmple_ps(t_min_y, _mm_loadu_ps(&max_y_[first]))));
+					auto mask = static_cast<unsigned int>(_mm_movemask_ps(hits));
+					if (mask != 0) {
+						return first + lowest_bit(mask);
+					}
+				}
+#endif
+			}
+
+			for (; first < sz ; ++first) {
+				if (min_x_[first] <= target.bot_right.x && target.top_left.x <= max_x_[first]
+				    && min_y_[first] <= target.bot_right.y && target.top_left.y <= max_y_[first]) {
+					return first;
+				}
+			}
+			return sz;
+		}
+
+	private:
+		static size_type lowest_bit(unsigned int mask) noexcept {
+			assert(mask != 0);
+			size_type idx = 0;
+			while ((mask & 1u) == 0) {
+				mask >>= 1u;
+				++idx;
+			}
+			return idx;
+		}
+
+		std::vector<Coord> min_x_{};
+		std::vector<Coord> min_y_{};
+		std::vector<Coord> max_x_{};
+		std::vector<Coord> max_y_{};
+	};
+}
+
+#endif //DUNGEEP_HITBOX_SOA_HPP
@@ -0,0 +1,145 @@
+#ifndef DUNGEEP_MAPPED_FILE_HPP
+#define DUNGEEP_MAPPED_FILE_HPP
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///                                                                                                                                     ///
+///  Copyright C 2019, Lucas Lazare                                                                                                     ///
+///  Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation         ///
+///  		files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy,  ///
+///  modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software     ///
+///  		is furnished to do so, subject to the following conditions:                                                                 ///
+///                                                                                                                                     ///
+///  The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.     ///
+///                                                                                                                                     ///
+///  The Software is provided “as is”, without warranty of any kind, express or implied, including but not limited to the               ///
+///  warranties of merchantability, fitness for a particular purpose and noninfringement. In no event shall the authors or              ///
+///  copyright holders be liable for any claim, damages or other liability, whether in an action of contract, tort or otherwise,        ///
+///  arising from, out of or in connection with the software or the use or other dealings in the Software.                              ///
+///                                                                                                                                     ///
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <filesystem>
+#include <utility>
+
+#ifdef _WIN32
+#	ifndef NOMINMAX
+#		define NOMINMAX
+#	endif
+#	include <windows.h>
+#else
+#	include <fcntl.h>
+#	include <sys/mman.h>
+#	include <sys/stat.h>
+#	include <unistd.h>
+#endif
+
+namespace dungeep {
+
+	/**
+	 * Read only memory mapping of a whole file
+	 * The file's content is paged in lazily by the OS, and shared with other processes mapping the same file.
+	 * is_open() is false if the file could not be opened or mapped. An empty file is open, with a null data().
+	 */
+	class mapped_file {
+	public:
+		mapped_file() noexcept = default;
+
+		explicit mapped_file(const std::filesystem::path& path) noexcept {
+#ifdef _WIN32
+			HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+			                          FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (file == INVALID_HANDLE_VALUE) {
+				return;
+			}
+			LARGE_INTEGER file_size{};
+			if (GetFileSizeEx(file, &file_size) && file_size.QuadPart == 0) {
+				open_ = true;
+			} else if (file_size.QuadPart > 0) {
+				HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+				if (mapping != nullptr) {
+					data_ = static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+					CloseHandle(mapping);
+				}
+				open_ = data_ != nullptr;
+				size_ = open_ ? static_cast<std::size_t>(file_size.QuadPart) : 0;
+			}
+			CloseHandle(file);
+#else
+			const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+			if (fd < 0) {
+				return;
+			}
+			struct stat file_stat{};
+			if (::fstat(fd, &file_stat) == 0) {
+				if (file_stat.st_size == 0) {
+					open_ = true;
+				} else {
+					void* mapping = ::mmap(nullptr, static_cast<std::size_t>(file_stat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+					if (mapping != MAP_FAILED) {
+						data_ = static_cast<const unsigned char*>(mapping);
+						size_ = static_cast<std::size_t>(file_stat.st_size);
+						open_ = true;
+					}
+				}
+			}
+			::close(fd); // the mapping stays valid
+#endif
+		}
+
+		mapped_file(const mapped_file&) = delete;
+		mapped_file& operator=(const mapped_file&) = delete;
+
+		mapped_file(mapped_file&& other) noexcept
+			: data_{std::exchange(other.data_, nullptr)}
+			, size_{std::exchange(other.size_, 0)}
+			, open_{std::exchange(other.open_, false)}
+		{}
+
+		mapped_file& operator=(mapped_file&& other) noexcept {
+			if (this != &other) {
+				close();
+				data_ = std::exchange(other.data_, nullptr);
+				size_ = std::exchange(other.size_, 0);
+				open_ = std::exchange(other.open_, false);
+			}
+			return *this;
+		}
+
+		~mapped_file() {
+			close();
+		}
+
+		void close() noexcept {
+			if (data_ != nullptr) {
+#ifdef _WIN32
+				UnmapViewOfFile(data_);
+#else
+				::munmap(const_cast<unsigned char*>(data_), size_);
+#endif
+			}
+			data_ = nullptr;
+			size_ = 0;
+			open_ = false;
+		}
+
+		[[nodiscard]] bool is_open() const noexcept {
+			return open_;
+		}
+
+		[[nodiscard]] const unsigned char* data() const noexcept {
+			return data_;
+		}
+
+		[[nodiscard]] std::size_t size() const noexcept {
+			return size_;
+		}
+
+	private:
+		const unsigned char* data_{nullptr};
+		std::size_t size_{0};
+		bool open_{false};
+	};
+}
+
+#endif //DUNGEEP_MAPPED_FILE_HPP
@@ -0,0 +1,233 @@
+#ifndef DUNGEEP_OBJECT_POOL_HPP
+#define DUNGEEP_OBJECT_POOL_HPP
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///                                                                                                                                     ///
+///  Copyright C 2019, Lucas Lazare                                                                                                     ///
+///  Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation         ///
+///  		files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy,  ///
+///  modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software     ///
+///  		is furnished to do so, subject to the following conditions:                                                                 ///
+///                                                                                                                                     ///
+///  The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.     ///
+///                                                                                                                                     ///
+///  The Software is provided “as is”, without warranty of any kind, express or implied, including but not limited to the               ///
+///  warranties of merchantability, fitness for a particular purpose and noninfringement. In no event shall the authors or              ///
+///  copyright holders be liable for any claim, damages or other liability, whether in an action of contract, tort or otherwise,        ///
+///  arising from, out of or in connection with the software or the use or other dealings in the Software.                              ///
+///                                                                                                                                     ///
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "chunked_storage.hpp"
+
+namespace dungeep {
+
+	// generation checked reference to an object of an object_pool
+	struct pool_handle {
+		static constexpr std::uint32_t invalid_index = ~std::uint32_t{0};
+
+		std::uint32_t index{invalid_index};
+		std::uint32_t generation{0};
+
+		bool operator==(const pool_handle& other) const noexcept {
+			return index == other.index && generation == other.generation;
+		}
+
+		bool operator!=(const pool_handle& other) const noexcept {
+			return !(*this == other);
+		}
+	};
+
+	/**
+	 * Pool of slots holding objects of type T, allocated by chunks of ChunkSize slots
+	 * Chunks are never moved nor freed: addresses are stable, and freed slots are reused by later allocations.
+	 * Each slot has a generation, bumped when it is freed: handles to a destroyed object are detected, even once the slot is reused.
+	 *
+	 * Allocations and deallocations are guarded by a mutex, and may happen from several threads at once. Handles may be checked
+	 * from any thread, but nothing prevents the object from being destroyed by another thread right after get() returned.
+	 * Objects still alive when the pool is destroyed are not destroyed.
+	 */
+	template <typename T, std::size_t ChunkSize = 256, std::size_t MaxChunks = 4096>
+	class object_pool {
+	public:
+		using handle = pool_handle;
+
+		object_pool() noexcept = default;
+		object_pool(const object_pool&) = delete;
+		object_pool& operator=(const object_pool&) = delete;
+
+		/**
+		 * Storage for one T, to be constructed by the caller. Throws std::bad_alloc once ChunkSize * MaxChunks slots are used
+		 */
+		[[nodiscard]] void* allocate() {
+			const std::uint32_t index = storage_.acquire([this](std::uint32_t idx) {
+				slot& s = slot_at(idx);
+				s.index = idx;
+				s.alive = true;
+			});
+			return slot_at(index).storage;
+		}
+
+		/**
+		 * 'ptr' should come from allocate(), and its object should already have been destroyed
+		 */
+		void deallocate(void* ptr) noexcept {
+			slot& s = *static_cast<slot*>(ptr); // storage is the first member of slot
+			storage_.release(s.index, [&s](std::uint32_t) {
+				assert(s.alive);
+				s.alive = false;
+				s.generation.fetch_add(1, std::memory_order_release);
+			});
+		}
+
+		template <typename... Args>
+		[[nodiscard]] handle create(Args&&... args) {
+			void* storage = allocate();
+			try {
+				return handle_of(new (storage) T(std::forward<Args>(args)...));
+			} catch (...) {
+				deallocate(storage);
+				throw;
+			}
+		}
+
+		// does nothing if 'h' is stale
+		void destroy(handle h) noexcept {
+			if (T* object = get(h)) {
+				object->~T();
+				deallocate(object);
+			}
+		}
+
+		/**
+		 * Returns nullptr if the object 'h' refers to was destroyed
+		 * The generation of a slot only matches the handles to its current object, so the alive flag needs not be read.
+		 */
+		[[nodiscard]] T* get(handle h) const noexcept {
+			if (h.index >= storage_.used()) {
+				return nullptr;
+			}
+			slot& s = slot_at(h.index);
+			if (s.generation.load(std::memory_order_acquire) != h.generation) {
+				return nullptr;
+			}
+			return std::launder(reinterpret_cast<T*>(s.storage));
+		}
+
+		// 'object' should live in this pool
+		[[nodiscard]] handle handle_of(const T* object) const noexcept {
+			const auto& s = *reinterpret_cast<const slot*>(object);
+			return {s.index, s.generation.load(std::memory_order_relaxed)};
+		}
+
+		// number of allocated slots
+		[[nodiscard]] std::size_t size() const {
+			return storage_.size();
+		}
+
+	private:
+		struct slot {
+			alignas(T) unsigned char storage[sizeof(T)];
+			std::uint32_t index{0};
+			std::atomic<std::uint32_t> generation{0};
+			bool alive{false}; // only accessed while the storage's mutex is locked
+		};
+		using chunk = std::array<slot, ChunkSize>;
+
+		slot& slot_at(std::uint32_t index) const noexcept {
+			return storage_.chunk(index)[storage_.offset(index)];
+		}
+
+		chunked_storage<chunk, ChunkSize, MaxChunks> storage_{};
+	};
+
+	/**
+	 * Routes 'new Derived' and 'delete' through a shared object_pool<Derived>, so that std::make_unique and std::unique_ptr keep working
+	 * Derived should be final: objects of a class deriving from it are allocated with the global operator new.
+	 */
+	template <typename Derived>
+	class pool_allocated {
+	public:
+		using pool_type = object_pool<Derived>;
+		using handle = typename pool_type::handle;
+
+		static pool_type& pool() noexcept {
+			static pool_type instance;
+			return instance;
+		}
+
+		static void* operator new(std::size_t size) {
+			if (size != sizeof(Derived)) {
+				return ::operator new(size);
+			}
+			return pool().allocate();
+		}
+
+		static void operator delete(void* ptr, std::size_t size) noexcept {
+			if (size != sizeof(Derived)) {
+				::operator delete(ptr);
+				return;
+			}
+			pool().deallocate(ptr);
+		}
+
+		// generation checked reference to this object
+		[[nodiscard]] handle get_handle() const noexcept {
+			return pool().handle_of(static_cast<const Derived*>(this));
+		}
+
+		// returns nullptr if the object was deleted
+		[[nodiscard]] static Derived* from_handle(handle h) noexcept {
+			return pool().get(h);
+		}
+	};
+
+	/**
+	 * Generation checked reference to an object of any pool_allocated class deriving from Base
+	 * Keeps the handle along with the function resolving it in the right pool.
+	 */
+	template <typename Base>
+	class pool_ref {
+	public:
+		pool_ref() noexcept = default;
+
+		template <typename Derived>
+		[[nodiscard]] static pool_ref to(const Derived& object) noexcept {
+			static_assert(std::is_base_of_v<Base, Derived> && std::is_base_of_v<pool_allocated<Derived>, Derived>);
+			return pool_ref{object.get_handle(), [](pool_handle h) noexcept -> Base* {
+				return Derived::from_handle(h);
+			}};
+		}
+
+		// returns nullptr if the object was deleted, or for a default constructed reference
+		[[nodiscard]] Base* get() const noexcept {
+			return resolve_ ? resolve_(handle_) : nullptr;
+		}
+
+		bool operator==(const pool_ref& other) const noexcept {
+			return handle_ == other.handle_ && resolve_ == other.resolve_;
+		}
+
+		bool operator!=(const pool_ref& other) const noexcept {
+			return !(*this == other);
+		}
+
+	private:
+		using resolver = Base* (*)(pool_handle) noexcept;
+
+		pool_ref(pool_handle h, resolver resolve) noexcept : handle_{h}, resolve_{resolve} {}
+
+		pool_handle handle_{};
+		resolver resolve_{nullptr};
+	};
+}
+
+#endif //DUNGEEP_OBJECT_POOL_HPP
@@ -0,0 +1,157 @@
+#ifndef DUNGEEP_PERSISTENT_QUADTREE_HPP
+#define DUNGEEP_PERSISTENT_QUADTREE_HPP
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///                                                                                                                                     ///
+///  Copyright C 2019, Lucas Lazare                                                                                                     ///
+///  Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation         ///
+///  		files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy,  ///
+///  modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software     ///
+///  		is furnished to do so, subject to the following conditions:                                                                 ///
+///                                                                                                                                     ///
+///  The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.     ///
+///                                                                                                                                     ///
+///  The Software is provided “as is”, without warranty of any kind, express or implied, including but not limited to the               ///
+///  warranties of merchantability, fitness for a particular purpose and noninfringement. In no event shall the authors or              ///
+///  copyright holders be liable for any claim, damages or other liability, whether in an action of contract, tort or otherwise,        ///
+///  arising from, out of or in connection with the software or the use or other dealings in the Software.                              ///
+///                                                                                                                                     ///
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <array>
+#include <memory>
+#include <vector>
+#include <type_traits>
+
+#include "geometry.hpp"
+#include "hitbox_soa.hpp"
+
+namespace dungeep {
+
+	/**
+	 * Quadtree whose nodes are shared between copies: copying or taking a snapshot() is O(1), and a mutation only duplicates
+	 * the nodes on the path it walks that are still shared with another copy (nodes owned by a single copy are updated in place).
+	 *
+	 * Lets a writer thread keep mutating the tree while other threads read snapshots without locking: a snapshot never
+	 * changes, and the writer never writes to a node a snapshot can reach. A given copy must not be accessed by several threads
+	 * if one of them modifies it.
+	 *
+	 * T should be copyable, have a noexcept '.hitbox()' method returning an area<Coord> and, for move(), a '.set_hitbox(area<Coord>)'
+	 * method. erase() and move() compare elements with operator==.
+	 */
+	template <typename T, typename Coord = float>
+	class persistent_quadtree {
+	public:
+		using value_type = T;
+		using size_type = std::size_t;
+		using area = dungeep::area<Coord>;
+		using point = dungeep::point<Coord>;
+
+		explicit persistent_quadtree(const area& ar) : persistent_quadtree(ar, 5, 20) {}
+
+		persistent_quadtree(const area& ar, size_type max_depth, size_type max_size);
+
+		/**
+		 * Copies share every node with the original
+		 */
+		persistent_quadtree(const persistent_quadtree&) noexcept = default;
+		persistent_quadtree(persistent_quadtree&&) noexcept = default;
+		persistent_quadtree& operator=(const persistent_quadtree&) noexcept = default;
+		persistent_quadtree& operator=(persistent_quadtree&&) noexcept = default;
+
+		/**
+		 * O(1) read-only view of the current state, unaffected by later modifications of *this.
+		 * May be handed to another thread.
+		 */
+		[[nodiscard]] persistent_quadtree snapshot() const noexcept {
+			return *this;
+		}
+
+		void insert(const value_type& value);
+
+		/**
+		 * Returns false if no element compares equal to 'value'
+		 */
+		bool erase(const value_type& value);
+
+		/**
+		 * Moves the element comparing equal to 'element' to 'new_area'. Returns false if there is none
+		 */
+		bool move(const value_type& element, const area& new_area);
+
+		/**
+		 * Calls 'visitor' with every element at least partially present in 'target'
+		 * 'visitor' should take 'const T&' as single parameter.
+		 */
+		template <typename FuncT>
+		void visit(const area& target, FuncT&& visitor) const noexcept(std::is_nothrow_invocable_v<FuncT, const T&>);
+
+		/**
+		 * Returns true if at least one element is at least partially present in the given area
+		 */
+		[[nodiscard]] bool has_collision(const area& ar) const noexcept;
+
+		/**
+		 * Same as without 'pred', but the colliding element must be an argument for which pred returned true
+		 * 'pred' should take 'const T&' as single parameter.
+		 */
+		template <typename FuncT>
+		[[nodiscard]] bool has_collision_if(const area& ar, FuncT&& pred) const noexcept(std::is_nothrow_invocable_v<FuncT, const T&>);
+
+		[[nodiscard]] bool empty() const noexcept {
+			return size() == 0;
+		}
+
+		[[nodiscard]] size_type size() const noexcept {
+			return root_->subtree_size;
+		}
+
+		void clear();
+
+		// number of nodes reachable from both *this and 'other'
+		[[nodiscard]] size_type shared_node_count(const persistent_quadtree& other) const;
+
+	private:
+		struct node {
+			node(const area& ar, size_type depth_left) noexcept : box{ar}, max_depth{depth_left} {}
+
+			area box;
+			size_type max_depth;
+			size_type subtree_size{0};
+			std::vector<T> values{};
+			hitbox_soa<Coord> hitboxes{}; // hitboxes[i] is the location of values[i]
+			std::array<std::shared_ptr<node>, 4> children{}; // all null or all set
+		};
+
+		// makes sure 'ptr' is only referenced from this copy, cloning it otherwise
+		static node& own(std::shared_ptr<node>& ptr);
+
+		// index of the child fully containing 'hitbox', or 4 if there is none
+		static unsigned int child_index(const node& n, const area& hitbox) noexcept;
+
+		void insert_in(std::shared_ptr<node>& ptr, const value_type& value, const area& hitbox);
+
+		// the element must be present
+		void erase_in(std::shared_ptr<node>& ptr, const value_type& value, const area& hitbox);
+
+		void split(node& n);
+
+		// moves every element of the subtree in 'n', then drops the children
+		static void merge(node& n);
+
+		template <typename FuncT>
+		static void visit_impl(const node& n, const area& target, FuncT& visitor);
+
+		template <typename FuncT>
+		static bool has_collision_impl(const node& n, const area& target, FuncT& pred);
+
+		std::shared_ptr<node> root_;
+		size_type max_size_;
+	};
+}
+
+
+#include "persistent_quadtree.tpp"
+
+
+#endif //DUNGEEP_PERSISTENT_QUADTREE_HPP
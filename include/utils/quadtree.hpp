@@ -22,8 +22,12 @@
 #include <iterator>
 #include <utility>
 #include <memory>
+#include <atomic>
+#include <cstdint>
 
 #include "geometry.hpp"
+#include "hitbox_soa.hpp"
+#include "thread_pool.hpp"
 
 namespace dungeep {
 
@@ -50,11 +54,12 @@ namespace dungeep {
 			return *value;
 		}
 
-		area<float> hitbox() const noexcept {
+		decltype(auto) hitbox() const noexcept {
 			return value->hitbox();
 		}
 
-		void set_hitbox(area<float> ar) noexcept {
+		template <typename Area>
+		void set_hitbox(const Area& ar) noexcept {
 			value->set_hitbox(ar);
 		}
 
@@ -87,11 +92,12 @@ namespace dungeep {
 			return *value;
 		}
 
-		area<float> hitbox() const noexcept {
+		decltype(auto) hitbox() const noexcept {
 			return value->hitbox();
 		}
 
-		void set_hitbox(area<float> ar) noexcept {
+		template <typename Area>
+		void set_hitbox(const Area& ar) noexcept {
 			value->set_hitbox(ar);
 		}
 
@@ -104,15 +110,71 @@ namespace dungeep {
 	template <typename T>
 	using qtree_shared_ptr = quadtree_wrapper<std::shared_ptr<T>>;
 
+	// Shape and usage of a spatial index, to tune its parameters
+	struct quadtree_stats {
+		std::size_t node_count{0};
+		std::vector<std::size_t> nodes_per_depth{};    // depth histogram
+		std::vector<std::size_t> elements_per_depth{};
+		std::size_t interior_elements{0};              // elements kept in nodes having children, as they cross a split line
+		std::size_t allocated_bytes{0};
+		std::uint64_t query_count{0};
+		std::uint64_t visited_nodes{0};                // by those queries
+
+		[[nodiscard]] float average_query_visits() const noexcept {
+			return query_count == 0 ? 0.f : static_cast<float>(visited_nodes) / static_cast<float>(query_count);
+		}
+	};
+
+	// Relaxed atomic counter, usable from const queries running on several threads
+	// Copyable, so that the containers holding one stay copyable.
+	class query_counter {
+	public:
+		query_counter() noexcept = default;
+		query_counter(const query_counter& other) noexcept : value_{other.get()} {}
+		query_counter& operator=(const query_counter& other) noexcept {
+			value_.store(other.get(), std::memory_order_relaxed);
+			return *this;
+		}
+
+		void add(std::uint64_t count = 1) const noexcept {
+			value_.fetch_add(count, std::memory_order_relaxed);
+		}
+
+		[[nodiscard]] std::uint64_t get() const noexcept {
+			return value_.load(std::memory_order_relaxed);
+		}
+
+		void reset() noexcept {
+			value_.store(0, std::memory_order_relaxed);
+		}
+
+	private:
+		mutable std::atomic<std::uint64_t> value_{0};
+	};
+
+	// Parameters of quadtree::adapt
+	struct quadtree_tuning {
+		std::size_t node_budget{32};     // nodes examined per call, so that rebalancing is spread across ticks
+		std::uint64_t split_cost{4096};  // elements tested by the queries walking a node, since its last examination, above which it splits deeper
+		std::uint64_t merge_cost{256};   // cost of a subtree below which it is merged back into its root
+		std::uint64_t move_cost{8};      // cost of an element moving from a child to another
+		std::size_t min_size{4};         // bounds of the split threshold
+		std::size_t max_size{64};
+		std::size_t max_depth{10};
+	};
+
 	enum class quadtree_dynamics {
 		static_children,   // children are created at the start
 		lazy_children,     // children are created when needed
 		dynamic_children,  // children are created when needed, deleted when unneeded
 	};
 
-	// T should have a noexcept '.hitbox()' method returning an area<float>.
-	// T should have a '.set_hitbox(area<float>)' method.
-	template <typename T, quadtree_dynamics Dynamicity = quadtree_dynamics::dynamic_children, template <typename...> typename Container = std::vector>
+	// T should have a noexcept '.hitbox()' method returning an area<Coord>.
+	// T should have a '.set_hitbox(area<Coord>)' method.
+	// Container should provide random access iterators.
+	// Hitboxes are cached by the quadtree: an element's hitbox should only be changed through quadtree::move.
+	// Coord may be an integer type, for elements aligned on tiles: comparisons are then exact.
+	template <typename T, quadtree_dynamics Dynamicity = quadtree_dynamics::dynamic_children, template <typename...> typename Container = std::vector, typename Coord = float>
 	class quadtree {
 		template <typename, typename, typename>
 		struct iterator_type;
@@ -128,13 +190,13 @@ namespace dungeep {
 		using const_reference = typename container::const_reference;
 		using pointer = typename container::pointer;
 		using const_pointer = typename container::const_pointer;
-		using iterator = iterator_type<quadtree<T,Dynamicity,Container>, value_type, typename container::iterator>;
-		using const_iterator = iterator_type<const quadtree<T,Dynamicity,Container>, const value_type, typename container::const_iterator>;
+		using iterator = iterator_type<quadtree<T,Dynamicity,Container,Coord>, value_type, typename container::iterator>;
+		using const_iterator = iterator_type<const quadtree<T,Dynamicity,Container,Coord>, const value_type, typename container::const_iterator>;
 		using reverse_iterator = std::reverse_iterator<iterator>;
 		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 
-		using area = dungeep::area<float>;
-		using point = dungeep::point<float>;
+		using area = dungeep::area<Coord>;
+		using point = dungeep::point<Coord>;
 
 	public:
 		explicit quadtree(const area& ar)
@@ -147,8 +209,8 @@ namespace dungeep {
 		quadtree(const quadtree& other);
 		quadtree(quadtree&& other) noexcept(noexcept(container(std::declval<container&&>()))) = default;
 
-		quadtree<T,Dynamicity,Container>& operator=(const quadtree<T,Dynamicity,Container>& other);
-		quadtree<T,Dynamicity,Container>& operator=(quadtree<T,Dynamicity,Container>&& other) noexcept(noexcept(container().operator=(std::declval<container&&>()))) = default;
+		quadtree<T,Dynamicity,Container,Coord>& operator=(const quadtree<T,Dynamicity,Container,Coord>& other);
+		quadtree<T,Dynamicity,Container,Coord>& operator=(quadtree<T,Dynamicity,Container,Coord>&& other) noexcept(noexcept(container().operator=(std::declval<container&&>()))) = default;
 
 		// Iterator for the whole collection
 		[[nodiscard]] iterator begin() noexcept;
@@ -183,10 +245,21 @@ namespace dungeep {
 		std::enable_if_t<std::is_invocable_v<FuncT, iterator>>
 		visit(const area& target, FuncT&& visitor) noexcept(std::is_nothrow_invocable_v<FuncT, iterator>);
 
+		/**
+		 * Thread-safe: several threads may visit the tree concurrently, as long as none of them modifies it.
+		 */
 		template <typename FuncT>
 		std::enable_if_t<std::is_invocable_v<FuncT, const_iterator>>
 		visit(const area& target, FuncT&& visitor) const noexcept(std::is_nothrow_invocable_v<FuncT, const_iterator>);
 
+		/**
+		 * Same as the const visit, but when 'target' covers a large part of a node, its children are visited by the workers of 'pool'.
+		 * The visitor may thus be called concurrently from several threads. Returns once every element has been visited.
+		 * The tree must not be modified until then.
+		 */
+		template <typename FuncT>
+		void parallel_visit(const area& target, FuncT&& visitor, thread_pool& pool) const;
+
 
 		[[nodiscard]] bool empty() const noexcept;
 
@@ -211,12 +284,47 @@ namespace dungeep {
 		 * Same as without 'pred', but the colliding element must be an argument for which pred returned true
 		 * 'pred' should take 'T&'/'const T&' as single parameter.
 		 * Elements passed to the predicate all collides
+		 * The const overload is thread-safe, as long as no thread modifies the tree meanwhile.
 		 */
 		template <typename FuncT>
 		[[nodiscard]] bool has_collision_if(const area& ar, FuncT&& pred) noexcept(std::is_nothrow_invocable_v<FuncT, T&>);
 		template <typename FuncT>
 		[[nodiscard]] bool has_collision_if(const area& ar, FuncT&& pred) const noexcept(std::is_nothrow_invocable_v<FuncT, const T&>);
 
+		/**
+		 * Same as the const has_collision_if, with the children split across the workers of 'pool' as in parallel_visit
+		 * 'pred' may be called concurrently from several threads. Once an element matches, the remaining tasks stop early.
+		 */
+		template <typename FuncT>
+		[[nodiscard]] bool parallel_has_collision_if(const area& ar, FuncT&& pred, thread_pool& pool) const;
+
+		/**
+		 * Calls 'func' once for each pair of colliding elements
+		 * The tree is traversed once: elements of a node are only tested against the other elements of the same node and against
+		 * the elements of its descendants.
+		 * 'func' should take two 'T&'/'const T&' parameters, and should not attempt to insert or remove an element.
+		 */
+		template <typename FuncT>
+		void for_each_colliding_pair(FuncT&& func) noexcept(std::is_nothrow_invocable_v<FuncT, T&, T&>);
+		template <typename FuncT>
+		void for_each_colliding_pair(FuncT&& func) const noexcept(std::is_nothrow_invocable_v<FuncT, const T&, const T&>);
+
+		/**
+		 * Returns the first element crossed by the segment going from 'from' to 'to', or end() if there is none
+		 * Only nodes crossed by the segment are walked, nearest first, and the walk stops at the first hit
+		 */
+		[[nodiscard]] iterator raycast(const point& from, const point& to) noexcept;
+		[[nodiscard]] const_iterator raycast(const point& from, const point& to) const noexcept;
+
+		/**
+		 * Same as without 'pred', but elements for which 'pred' returned false are ignored (the segment goes through them)
+		 * 'pred' should take 'T&'/'const T&' as single parameter.
+		 */
+		template <typename FuncT>
+		[[nodiscard]] iterator raycast_if(const point& from, const point& to, FuncT&& pred) noexcept(std::is_nothrow_invocable_v<FuncT, T&>);
+		template <typename FuncT>
+		[[nodiscard]] const_iterator raycast_if(const point& from, const point& to, FuncT&& pred) const noexcept(std::is_nothrow_invocable_v<FuncT, const T&>);
+
 		/**
 		 * Iterators are invalidated
 		 */
@@ -233,6 +341,22 @@ namespace dungeep {
 		void move(const T& element, const area& new_area);
 		void move(const_iterator it, const area& new_area);
 
+		/**
+		 * Walks the whole tree. Query statistics cover visit, has_collision_if and raycast calls since the last reset_stats()
+		 */
+		[[nodiscard]] quadtree_stats stats() const;
+
+		void reset_stats() noexcept;
+
+		/**
+		 * Examines the next 'tuning.node_budget' nodes, resuming where the previous call stopped, and adjusts their split
+		 * threshold and depth limit from the queries and moves they went through since their last examination:
+		 * nodes walked by costly queries split deeper, while subtrees mostly paying for elements moving across their
+		 * children are merged back (dynamic_children only). Does nothing in static_children mode.
+		 * Iterators are invalidated
+		 */
+		void adapt(const quadtree_tuning& tuning);
+
 
 	private:
 
@@ -246,7 +370,7 @@ namespace dungeep {
 			auto& operator[](std::size_t i) { return children_[i]; }
 			const auto& operator[](std::size_t i) const { return children_[i]; }
 		private:
-			std::array<quadtree<T,Dynamicity,Container>,4> children_;
+			std::array<quadtree<T,Dynamicity,Container,Coord>,4> children_;
 		};
 
 		struct dirs_struct {
@@ -271,21 +395,61 @@ namespace dungeep {
 		template <typename IteratorType>
 		IteratorType erase_impl(IteratorType);
 
+		// replaces values_[idx] by the last value
+		void erase_value_at(size_type idx);
+
 		template <typename IteratorType>
 		T extract_impl(IteratorType element);
 
 		template <typename Iterator>
 		void move_impl(Iterator it, const area& new_area);
 
+		template <typename QuadTree, typename FuncT>
+		static void colliding_pairs_impl(QuadTree& qt, FuncT& func);
+
+		template <typename QuadTree, typename Value, typename FuncT>
+		static void collide_with_descendants(QuadTree& qt, Value& value, const area& value_hitbox, FuncT& func);
+
+		// true if 'target' is worth splitting the children of this node across threads
+		[[nodiscard]] bool is_large_query(const area& target) const noexcept;
+
+		template <typename FuncT>
+		void parallel_visit_impl(const area& target, FuncT& visitor, thread_pool& pool, thread_pool::task_group& group) const;
+
+		template <typename FuncT>
+		void parallel_has_collision_impl(const area& ar, FuncT& pred, thread_pool& pool, thread_pool::task_group& group, std::atomic<bool>& found) const;
+
+		void collect_stats(quadtree_stats& stats, size_type depth) const;
+
+		// adapts this node only
+		void adapt_node(const quadtree_tuning& tuning, size_type depth);
+
+		// moves every element of the subtree to this node, and deletes the children
+		void merge_children();
+
+		// elements tested by the queries walking this subtree, and elements moving across its nodes, since its last examination
+		[[nodiscard]] std::uint64_t subtree_cost(const quadtree_tuning& tuning) const noexcept;
+
+		// 'closest' is the position along the segment of the closest hit so far, and is updated when a closer one is found
+		template <typename IteratorType, typename QuadTree, typename FuncT>
+		static IteratorType raycast_impl(QuadTree& qt, const point& from, const point& to, FuncT& pred, float& closest);
+
 		area area_;
 		point center_;
 		size_type max_size_;
 		size_type max_depth_;
 
 		container values_;
+		hitbox_soa<Coord> hitboxes_; // hitboxes_[i] is the location of values_[i]: elements are only dereferenced on a hit
 
 		std::unique_ptr<children> children_;
 
+		query_counter visits_{}; // queries that walked this node
+
+		std::uint64_t adapt_visits_{0}; // visits_ at the last examination
+		std::uint64_t relocations_{0};  // elements moved across the children of this node since the last examination
+		std::vector<unsigned> adapt_cursor_{}; // path to the next node to examine, only used by the root
+
 		friend const_iterator;
 		friend iterator;
 	};
@@ -18,14 +18,126 @@
 ///                                                                                                                                     ///
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+#include <array>
+#include <cmath>
+#include <cstdint>
 #include <memory>
 #include <random>
+#include <limits>
 #include <type_traits>
 #include <iostream>
 #include <cassert>
 
+#include "ziggurat_tables.hpp"
+
 namespace dungeep {
 
+	namespace details {
+		// full 128 bits product, computed the same way with or without compiler support for 128 bits integers
+		struct wide_product {
+			std::uint64_t high;
+			std::uint64_t low;
+		};
+
+		constexpr wide_product multiply(std::uint64_t lhs, std::uint64_t rhs) noexcept {
+#ifdef __SIZEOF_INT128__
+			__extension__ using uint128_t = unsigned __int128; // __extension__: keeps -pedantic quiet
+			const uint128_t product = static_cast<uint128_t>(lhs) * rhs;
+			return {static_cast<std::uint64_t>(product >> 64u), static_cast<std::uint64_t>(product)};
+#else
+			const std::uint64_t lhs_lo = lhs & 0xFFFFFFFFu, lhs_hi = lhs >> 32u;
+			const std::uint64_t rhs_lo = rhs & 0xFFFFFFFFu, rhs_hi = rhs >> 32u;
+			const std::uint64_t lo_lo = lhs_lo * rhs_lo;
+			const std::uint64_t hi_lo = lhs_hi * rhs_lo;
+			const std::uint64_t lo_hi = lhs_lo * rhs_hi;
+			const std::uint64_t hi_hi = lhs_hi * rhs_hi;
+			const std::uint64_t cross = (lo_lo >> 32u) + (hi_lo & 0xFFFFFFFFu) + lo_hi;
+			return {hi_hi + (hi_lo >> 32u) + (cross >> 32u), (cross << 32u) | (lo_lo & 0xFFFFFFFFu)};
+#endif
+		}
+
+		// true for generators whose outputs cover exactly all the values of a 32 or 64 bits unsigned integer
+		template <typename UniformRandomBitGenerator>
+		constexpr bool is_full_range_v = UniformRandomBitGenerator::min() == 0
+		        && (UniformRandomBitGenerator::max() == std::numeric_limits<std::uint32_t>::max()
+		            || UniformRandomBitGenerator::max() == std::numeric_limits<std::uint64_t>::max());
+
+		/**
+		 * exp and log made of +, -, *, / and exact scalings only, which IEEE 754 rounds the same way on every platform: unlike the
+		 * standard library's, which are not correctly rounded and differ from a libm to another, they give the same bits everywhere
+		 * as long as the compiler does not fuse them into multiply-adds (no -ffast-math, -ffp-contract=off on FMA targets).
+		 * Accurate to a few ulps, which is plenty for the ziggurat's acceptance tests.
+		 */
+		inline constexpr double ln2_hi = 6.93147180369123816490e-01; // low bits cleared: k * ln2_hi is exact for small k
+		inline constexpr double ln2_lo = 1.90821492927058770002e-10;
+
+		inline double portable_exp(double x) noexcept {
+			// x = k ln2 + r with |r| <= ln2 / 2, where the Taylor series below is exact to about 2^-57
+			const double k = std::floor(x * 1.44269504088896338700 + 0.5);
+			const double r = (x - k * ln2_hi) - k * ln2_lo;
+			double sum = 1.;
+			for (int n = 13 ; n > 0 ; --n) {
+				sum = 1. + sum * r / n;
+			}
+			return std::ldexp(sum, static_cast<int>(k));
+		}
+
+		// x > 0
+		inline double portable_log(double x) noexcept {
+			// x = m 2^e with m in [sqrt(1/2) ; sqrt(2)[, log(m) = 2 atanh(s), s = (m - 1) / (m + 1) being below 0.172
+			int e;
+			double m = std::frexp(x, &e);
+			if (m < 0.70710678118654752440) {
+				m *= 2.;
+				--e;
+			}
+			const double s = (m - 1.) / (m + 1.);
+			const double s2 = s * s;
+			double sum = 1. / 23.;
+			for (int n = 21 ; n > 0 ; n -= 2) {
+				sum = sum * s2 + 1. / n;
+			}
+			return e * ln2_hi + (e * ln2_lo + 2. * s * sum);
+		}
+	}
+
+	/**
+	 * Unbiased random integer in [0 ; range[, to be used instead of g() % range.
+	 * Daniel Lemire, Fast Random Integer Generation in an Interval, ACM TOMACS 2019: a multiplication and a shift, the
+	 * division only happens in the rare case where a rejection might be needed.
+	 */
+	template <typename UniformRandomBitGenerator, typename UIntType>
+	UIntType bounded_rand(UniformRandomBitGenerator& g, UIntType range) noexcept(noexcept(g.operator()())) {
+		static_assert(std::is_unsigned_v<UIntType>, "range must be an unsigned integral type");
+		static_assert(details::is_full_range_v<UniformRandomBitGenerator>, "generator must output full 32 or 64 bits integers");
+		assert(range > 0);
+
+		if constexpr (UniformRandomBitGenerator::max() == std::numeric_limits<std::uint32_t>::max()) {
+			assert(range <= std::numeric_limits<std::uint32_t>::max());
+			const auto s = static_cast<std::uint32_t>(range);
+			std::uint64_t product = std::uint64_t{g()} * s;
+			auto low = static_cast<std::uint32_t>(product);
+			if (low < s) {
+				const std::uint32_t threshold = -s % s;
+				while (low < threshold) {
+					product = std::uint64_t{g()} * s;
+					low = static_cast<std::uint32_t>(product);
+				}
+			}
+			return static_cast<UIntType>(product >> 32u);
+		} else {
+			const auto s = static_cast<std::uint64_t>(range);
+			details::wide_product product = details::multiply(std::uint64_t{g()}, s);
+			if (product.low < s) {
+				const std::uint64_t threshold = -s % s;
+				while (product.low < threshold) {
+					product = details::multiply(std::uint64_t{g()}, s);
+				}
+			}
+			return static_cast<UIntType>(product.high);
+		}
+	}
+
 	// std::normal_distribution is not portable across compilers
 	template <typename RealType = double>
 	class normal_distribution {
@@ -76,31 +188,64 @@ namespace dungeep {
 			return this->operator()(g, params);
 		}
 
-		// Marsaglia's polar method
-		// Luc Devroye, Non-Uniform Random Variate Generation, Ch. 5 Uniform and Exponential Spacings, Section 4: The polar method
-		// avail for free @ http://luc.devroye.org/rnbookindex.html
+		/**
+		 * Ziggurat method, or Marsaglia's polar method for generators that do not output full 32 or 64 bits words
+		 * The ziggurat's fast path only does a table lookup, a multiplication and a comparison per sample. Its slow paths use
+		 * details::portable_exp and portable_log: samples are the same bits whatever the compiler and standard library.
+		 * The polar method relies on std::log, and is only reproducible with a given standard library.
+		 */
 		template <typename UniformRandomBitGenerator>
 		result_type operator()(UniformRandomBitGenerator& g, const param_type& p) noexcept(noexcept(g.operator()())) {
-			if (val_avail) {
-				val_avail = false;
-				return p.mean() + val * p.stddev();
+			if constexpr (details::is_full_range_v<UniformRandomBitGenerator>) {
+				return p.mean() + static_cast<result_type>(ziggurat_sample(g, random_word(g))) * p.stddev();
+			} else {
+				return polar_sample(g, p);
 			}
+		}
 
-			result_type half_range = result_type((g.max() - g.min()) / 2);
-			result_type x, y, z;
-			do {
-				//x, y \in [-1 ; 1]
-				x = result_type(g() - g.min()) / half_range - result_type(1.0);
-				y = result_type(g() - g.min()) / half_range - result_type(1.0);
-				z = x*x + y*y;
-			} while (z > result_type(1.) || z == result_type(0.));
-
-			const result_type coeff = std::sqrt(-2 * std::log(z) / z);
-
-			val_avail = true;
-			val = y * coeff;
+		/**
+		 * Fills [first ; last[ with samples. The fast path of the ziggurat is run over blocks of samples at once, in a loop
+		 * without branches, and only the rejected samples go through the slow path afterwards.
+		 * The results are reproducible, but differ from the ones of successive calls to operator() as random words are not
+		 * consumed in the same order.
+		 */
+		template <typename ForwardIt, typename UniformRandomBitGenerator>
+		void generate(ForwardIt first, ForwardIt last, UniformRandomBitGenerator& g) noexcept(noexcept(g.operator()())) {
+			generate(first, last, g, params);
+		}
 
-			return p.mean() + x * coeff * p.stddev();
+		template <typename ForwardIt, typename UniformRandomBitGenerator>
+		void generate(ForwardIt first, ForwardIt last, UniformRandomBitGenerator& g, const param_type& p) noexcept(noexcept(g.operator()())) {
+			if constexpr (details::is_full_range_v<UniformRandomBitGenerator>) {
+				constexpr std::size_t block_size = 64;
+				std::uint64_t words[block_size];
+				double samples[block_size];
+				bool accepted[block_size];
+
+				while (first != last) {
+					std::size_t count = 0;
+					for (ForwardIt it = first ; it != last && count < block_size ; ++it) {
+						words[count++] = random_word(g);
+					}
+
+					for (std::size_t i = 0 ; i < count ; ++i) {
+						const std::uint64_t layer = words[i] & 0x7Fu;
+						const double u = static_cast<double>(words[i] >> 11u) * 0x1p-53;
+						const double x = u * details::ziggurat_x[layer];
+						accepted[i] = u < details::ziggurat_ratio[layer];
+						samples[i] = (words[i] & 0x80u) ? -x : x;
+					}
+
+					for (std::size_t i = 0 ; i < count ; ++i, ++first) {
+						const double sample = accepted[i] ? samples[i] : ziggurat_sample(g, words[i]);
+						*first = p.mean() + static_cast<result_type>(sample) * p.stddev();
+					}
+				}
+			} else {
+				for (; first != last ; ++first) {
+					*first = polar_sample(g, p);
+				}
+			}
 		}
 
 		constexpr param_type param() const noexcept {
@@ -157,6 +302,84 @@ namespace dungeep {
 		}
 
 	private:
+		// 64 random bits: 7 select the layer, 1 the sign and the upper 53 are the uniform draw in the layer
+		template <typename UniformRandomBitGenerator>
+		static std::uint64_t random_word(UniformRandomBitGenerator& g) noexcept(noexcept(g.operator()())) {
+			if constexpr (UniformRandomBitGenerator::max() == std::numeric_limits<std::uint32_t>::max()) {
+				const auto high = static_cast<std::uint64_t>(g());
+				return (high << 32u) | static_cast<std::uint64_t>(g());
+			} else {
+				return static_cast<std::uint64_t>(g());
+			}
+		}
+
+		// uniform draw in ]0 ; 1], safe to pass to log
+		template <typename UniformRandomBitGenerator>
+		static double open_uniform(UniformRandomBitGenerator& g) noexcept(noexcept(g.operator()())) {
+			return static_cast<double>((random_word(g) >> 11u) + 1) * 0x1p-53;
+		}
+
+		// standard normal sample, starting from 'word'
+		template <typename UniformRandomBitGenerator>
+		static double ziggurat_sample(UniformRandomBitGenerator& g, std::uint64_t word) noexcept(noexcept(g.operator()())) {
+			while (true) {
+				const std::uint64_t layer = word & 0x7Fu;
+				const bool negative = (word & 0x80u) != 0;
+				const double u = static_cast<double>(word >> 11u) * 0x1p-53;
+				double x = u * details::ziggurat_x[layer];
+
+				if (u < details::ziggurat_ratio[layer]) {
+					return negative ? -x : x;
+				}
+
+				if (layer == 0) {
+					// tail, beyond r (Marsaglia, Generating a variable from the tail of the normal distribution, 1964)
+					const double r = details::ziggurat_x[1];
+					double y;
+					do {
+						x = -details::portable_log(open_uniform(g)) / r;
+						y = -details::portable_log(open_uniform(g));
+					} while (y + y < x * x);
+					return negative ? -(r + x) : r + x;
+				}
+
+				// wedge between the layer's rectangle and the curve
+				const double f0 = details::ziggurat_f[layer];
+				const double f1 = details::ziggurat_f[layer + 1];
+				if (f1 + static_cast<double>(random_word(g) >> 11u) * 0x1p-53 * (f0 - f1) < details::portable_exp(-0.5 * x * x)) {
+					return negative ? -x : x;
+				}
+				word = random_word(g);
+			}
+		}
+
+		// Marsaglia's polar method
+		// Luc Devroye, Non-Uniform Random Variate Generation, Ch. 5 Uniform and Exponential Spacings, Section 4: The polar method
+		// avail for free @ http://luc.devroye.org/rnbookindex.html
+		template <typename UniformRandomBitGenerator>
+		result_type polar_sample(UniformRandomBitGenerator& g, const param_type& p) noexcept(noexcept(g.operator()())) {
+			if (val_avail) {
+				val_avail = false;
+				return p.mean() + val * p.stddev();
+			}
+
+			result_type half_range = result_type((g.max() - g.min()) / 2);
+			result_type x, y, z;
+			do {
+				//x, y \in [-1 ; 1]
+				x = result_type(g() - g.min()) / half_range - result_type(1.0);
+				y = result_type(g() - g.min()) / half_range - result_type(1.0);
+				z = x*x + y*y;
+			} while (z > result_type(1.) || z == result_type(0.));
+
+			const result_type coeff = std::sqrt(-2 * std::log(z) / z);
+
+			val_avail = true;
+			val = y * coeff;
+
+			return p.mean() + x * coeff * p.stddev();
+		}
+
 		result_type val{};
 		bool val_avail{false};
 		param_type params;
@@ -217,10 +440,17 @@ namespace dungeep {
 			using unsigned_dist_res_t = std::make_unsigned_t<result_type>;
 
 			unsigned_rng_res_t rng_range = g.max() - g.min(); // not adding 1 because of potential overflows
-			unsigned_dist_res_t dist_range = unsigned_dist_res_t(p.b() - p.a());
+			unsigned_dist_res_t dist_range = unsigned_dist_res_t(unsigned_dist_res_t(p.b()) - unsigned_dist_res_t(p.a()));
 
 			using unsigned_comm_t = std::common_type_t<unsigned_rng_res_t, unsigned_dist_res_t>;
 
+			if constexpr (details::is_full_range_v<UniformRandomBitGenerator>) {
+				if (rng_range > dist_range) {
+					const auto value = static_cast<unsigned_dist_res_t>(bounded_rand(g, unsigned_comm_t(dist_range) + 1));
+					return result_type(unsigned_dist_res_t(value + unsigned_dist_res_t(p.a())));
+				}
+			}
+
 			if (rng_range > dist_range) {
 				if (rng_range != std::numeric_limits<unsigned_rng_res_t>::max()) {
 					++rng_range;
@@ -309,7 +539,240 @@ namespace dungeep {
 		param_type params;
 	};
 
-	inline std::mt19937_64 random_engine(std::random_device{}());
+	/**
+	 * Philox4x32-10 counter based generator (Salmon et al., Parallel Random Numbers: As Easy as 1, 2, 3, SC'11)
+	 * Each block of 4 outputs is a pure function of a 64 bits key and a 128 bits counter: streams need no shared state, and
+	 * jumping ahead is O(1). The key is the seed, the counter is made of the block index and of two stream words, so that
+	 * for instance (world seed, entity id, tick) gives each entity its own reproducible stream on each tick.
+	 */
+	class philox4x32 {
+	public:
+		using result_type = std::uint32_t;
+		using counter_type = std::array<std::uint32_t, 4>;
+		using key_type = std::array<std::uint32_t, 2>;
+
+		constexpr philox4x32() noexcept : philox4x32(0u) {}
+
+		explicit constexpr philox4x32(std::uint64_t seed, std::uint32_t stream = 0, std::uint32_t sub_stream = 0) noexcept
+			: key_{static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32u)}
+			, stream_{stream, sub_stream}
+		{}
+
+		static constexpr result_type min() noexcept {
+			return 0;
+		}
+
+		static constexpr result_type max() noexcept {
+			return ~result_type{0};
+		}
+
+		constexpr void seed(std::uint64_t seed, std::uint32_t stream = 0, std::uint32_t sub_stream = 0) noexcept {
+			*this = philox4x32(seed, stream, sub_stream);
+		}
+
+		constexpr result_type operator()() noexcept {
+			if (index_ == 4) {
+				buffer_ = block({static_cast<std::uint32_t>(block_), static_cast<std::uint32_t>(block_ >> 32u), stream_[0], stream_[1]}, key_);
+				++block_;
+				index_ = 0;
+			}
+			return buffer_[index_++];
+		}
+
+		// same as calling operator() 'count' times
+		constexpr void discard(unsigned long long count) noexcept {
+			const unsigned long long buffered = 4u - index_;
+			if (count <= buffered) {
+				index_ += static_cast<unsigned int>(count);
+				return;
+			}
+			count -= buffered;
+			block_ += count / 4;
+			index_ = 4;
+			if (count % 4 != 0) {
+				operator()();
+				index_ = static_cast<unsigned int>(count % 4);
+			}
+		}
+
+		// the raw bijection: ten rounds of multiplications and xors
+		static constexpr counter_type block(counter_type counter, key_type key) noexcept {
+			for (auto round = 0u ; round < 10 ; ++round) {
+				if (round != 0) {
+					key[0] += 0x9E3779B9u;
+					key[1] += 0xBB67AE85u;
+				}
+				const std::uint64_t product_0 = std::uint64_t{0xD2511F53u} * counter[0];
+				const std::uint64_t product_1 = std::uint64_t{0xCD9E8D57u} * counter[2];
+				counter = {
+						static_cast<std::uint32_t>(product_1 >> 32u) ^ counter[1] ^ key[0],
+						static_cast<std::uint32_t>(product_1),
+						static_cast<std::uint32_t>(product_0 >> 32u) ^ counter[3] ^ key[1],
+						static_cast<std::uint32_t>(product_0)
+				};
+			}
+			return counter;
+		}
+
+		friend bool operator==(const philox4x32& lhs, const philox4x32& rhs) noexcept {
+			return lhs.key_ == rhs.key_ && lhs.stream_ == rhs.stream_ && lhs.block_ == rhs.block_ && lhs.index_ == rhs.index_;
+		}
+
+		friend bool operator!=(const philox4x32& lhs, const philox4x32& rhs) noexcept {
+			return !(lhs == rhs);
+		}
+
+	private:
+		key_type key_;
+		std::array<std::uint32_t, 2> stream_;
+		std::uint64_t block_{0};      // index of the next block to compute
+		counter_type buffer_{};
+		unsigned int index_{4};       // next output in buffer_
+	};
+
+	/**
+	 * SplitMix64 (Steele, Lea, Flood, Fast Splittable Pseudorandom Number Generators, OOPSLA'14)
+	 * Poor generator by itself, but every output of a 64 bits seed is well mixed: used to expand seeds into bigger states.
+	 */
+	class splitmix64 {
+	public:
+		using result_type = std::uint64_t;
+
+		explicit constexpr splitmix64(std::uint64_t seed = 0) noexcept : state_{seed} {}
+
+		static constexpr result_type min() noexcept {
+			return 0;
+		}
+
+		static constexpr result_type max() noexcept {
+			return ~result_type{0};
+		}
+
+		constexpr result_type operator()() noexcept {
+			std::uint64_t z = (state_ += 0x9E3779B97F4A7C15u);
+			z = (z ^ (z >> 30u)) * 0xBF58476D1CE4E5B9u;
+			z = (z ^ (z >> 27u)) * 0x94D049BB133111EBu;
+			return z ^ (z >> 31u);
+		}
+
+	private:
+		std::uint64_t state_;
+	};
+
+	/**
+	 * xoshiro256** (Blackman, Vigna, Scrambled Linear Pseudorandom Number Generators, 2018)
+	 * 32 bytes of state instead of the 2.5KB of std::mt19937_64, cheaper to seed and to copy, and faster to step.
+	 * Seeding goes through splitmix64 so that close seeds give unrelated states.
+	 */
+	class xoshiro256ss {
+	public:
+		using result_type = std::uint64_t;
+		using state_type = std::array<std::uint64_t, 4>;
+
+		constexpr xoshiro256ss() noexcept : xoshiro256ss(0u) {}
+
+		explicit constexpr xoshiro256ss(std::uint64_t seed) noexcept : state_{} {
+			this->seed(seed);
+		}
+
+		// the state must not be all zeros
+		explicit constexpr xoshiro256ss(const state_type& state) noexcept : state_{state} {
+			assert(state[0] != 0 || state[1] != 0 || state[2] != 0 || state[3] != 0);
+		}
+
+		static constexpr result_type min() noexcept {
+			return 0;
+		}
+
+		static constexpr result_type max() noexcept {
+			return ~result_type{0};
+		}
+
+		constexpr void seed(std::uint64_t seed) noexcept {
+			splitmix64 expander{seed};
+			for (std::uint64_t& word : state_) {
+				word = expander();
+			}
+		}
+
+		constexpr result_type operator()() noexcept {
+			const std::uint64_t result = rotl(state_[1] * 5, 7) * 9;
+			const std::uint64_t t = state_[1] << 17u;
+
+			state_[2] ^= state_[0];
+			state_[3] ^= state_[1];
+			state_[1] ^= state_[2];
+			state_[0] ^= state_[3];
+			state_[2] ^= t;
+			state_[3] = rotl(state_[3], 45);
+
+			return result;
+		}
+
+		constexpr void discard(unsigned long long count) noexcept {
+			while (count-- != 0) {
+				operator()();
+			}
+		}
+
+		// equivalent to 2^128 calls to operator(): gives up to 2^128 non overlapping sub-sequences, eg for worker threads
+		constexpr void jump() noexcept {
+			constexpr std::uint64_t jump_poly[] = {0x180EC6D33CFD0ABAu, 0xD5A61266F0C9392Cu, 0xA9582618E03FC9AAu, 0x39ABDC4529B1661Cu};
+
+			state_type jumped{};
+			for (std::uint64_t poly : jump_poly) {
+				for (auto bit = 0u ; bit < 64 ; ++bit) {
+					if (poly & (std::uint64_t{1} << bit)) {
+						for (auto i = 0u ; i < jumped.size() ; ++i) {
+							jumped[i] ^= state_[i];
+						}
+					}
+					operator()();
+				}
+			}
+			state_ = jumped;
+		}
+
+		[[nodiscard]] constexpr const state_type& state() const noexcept {
+			return state_;
+		}
+
+		friend bool operator==(const xoshiro256ss& lhs, const xoshiro256ss& rhs) noexcept {
+			return lhs.state_ == rhs.state_;
+		}
+
+		friend bool operator!=(const xoshiro256ss& lhs, const xoshiro256ss& rhs) noexcept {
+			return !(lhs == rhs);
+		}
+
+		template <typename CharT, typename Traits>
+		friend std::basic_ostream<CharT, Traits>& operator<<(std::basic_ostream<CharT, Traits>& os, const xoshiro256ss& engine) {
+			os << engine.state_[0] << ' ' << engine.state_[1] << ' ' << engine.state_[2] << ' ' << engine.state_[3];
+			return os;
+		}
+
+		template <typename CharT, typename Traits>
+		friend std::basic_istream<CharT, Traits>& operator>>(std::basic_istream<CharT, Traits>& is, xoshiro256ss& engine) {
+			is >> engine.state_[0] >> engine.state_[1] >> engine.state_[2] >> engine.state_[3];
+			return is;
+		}
+
+	private:
+		static constexpr std::uint64_t rotl(std::uint64_t x, unsigned int k) noexcept {
+			return (x << k) | (x >> (64u - k));
+		}
+
+		state_type state_;
+	};
+
+	// engine used throughout the game. Define DUNGEEP_MT19937_ENGINE to get back to std::mt19937_64
+#ifdef DUNGEEP_MT19937_ENGINE
+	using default_engine = std::mt19937_64;
+#else
+	using default_engine = xoshiro256ss;
+#endif
+
+	inline default_engine random_engine(std::random_device{}());
 	inline uniform_int_distribution int_distrib(0);
 	inline uniform_int_distribution<unsigned> uint_distrib(0u);
 }
@@ -34,6 +34,8 @@ namespace keys {
 		constexpr const char * crit_pl                     = "crit chance per level";
 		constexpr const char * move_speed                  = "base move speed";
 		constexpr const char * move_speed_pl               = "move speed per level";
+		constexpr const char * hp_regen                    = "base hp regen"; // optional
+		constexpr const char * hp_regen_pl                 = "hp regen per level"; // optional
 		namespace spawner {
 			constexpr const char * burst_duration          = "spawner spawn count";
 			constexpr const char * burst_inner_interval    = "spawner spawn interval";
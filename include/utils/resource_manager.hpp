@@ -94,6 +94,8 @@ public:
 		unsigned int crit_chance_per_level;
 		unsigned int base_move_speed;
 		unsigned int move_speed_per_level;
+		unsigned int base_hp_regen; // per tick
+		unsigned int hp_regen_per_level;
 
 		std::variant<player_stats, creep_stats, creep_boss_stats> other;
 	};
@@ -0,0 +1,278 @@
+#ifndef DUNGEEP_SPATIAL_GRID_HPP
+#define DUNGEEP_SPATIAL_GRID_HPP
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///                                                                                                                                     ///
+///  Copyright C 2019, Lucas Lazare                                                                                                     ///
+///  Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation         ///
+///  		files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy,  ///
+///  modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software     ///
+///  		is furnished to do so, subject to the following conditions:                                                                 ///
+///                                                                                                                                     ///
+///  The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.     ///
+///                                                                                                                                     ///
+///  The Software is provided “as is”, without warranty of any kind, express or implied, including but not limited to the               ///
+///  warranties of merchantability, fitness for a particular purpose and noninfringement. In no event shall the authors or              ///
+///  copyright holders be liable for any claim, damages or other liability, whether in an action of contract, tort or otherwise,        ///
+///  arising from, out of or in connection with the software or the use or other dealings in the Software.                              ///
+///                                                                                                                                     ///
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+#include <iterator>
+#include <utility>
+#include <atomic>
+
+#include "geometry.hpp"
+#include "hitbox_soa.hpp"
+#include "thread_pool.hpp"
+#include "quadtree.hpp"
+
+namespace dungeep {
+
+	// Uniform grid of square cells, with the same interface as quadtree
+	// Faster than the quadtree for many small elements evenly spread over the area: each element is stored in the cell holding
+	// the top left corner of its hitbox, and queries walk the cells of their area enlarged by the largest element inserted so far.
+	// Elements outside of the area are stored in the border cells.
+	// T, Container and Coord have the same requirements as for quadtree.
+	template <typename T, template <typename...> typename Container = std::vector, typename Coord = float>
+	class spatial_grid {
+		template <typename, typename, typename>
+		struct iterator_type;
+
+	public:
+
+		using container = Container<T>;
+		using value_type = typename container::value_type;
+		using allocator_type = typename container::allocator_type;
+		using size_type = typename container::size_type;
+		using difference_type = typename container::difference_type;
+		using reference = typename container::reference;
+		using const_reference = typename container::const_reference;
+		using pointer = typename container::pointer;
+		using const_pointer = typename container::const_pointer;
+		using iterator = iterator_type<spatial_grid<T,Container,Coord>, value_type, typename container::iterator>;
+		using const_iterator = iterator_type<const spatial_grid<T,Container,Coord>, const value_type, typename container::const_iterator>;
+		using reverse_iterator = std::reverse_iterator<iterator>;
+		using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+		using area = dungeep::area<Coord>;
+		using point = dungeep::point<Coord>;
+
+	public:
+		explicit spatial_grid(const area& ar) : spatial_grid(ar, 8.f) {}
+
+		spatial_grid(const area& ar, float cell_size);
+
+		// Iterator for the whole collection
+		[[nodiscard]] iterator begin() noexcept;
+		[[nodiscard]] const_iterator begin() const noexcept;
+		[[nodiscard]] const_iterator cbegin() const noexcept;
+
+		[[nodiscard]] iterator end() noexcept;
+		[[nodiscard]] const_iterator end() const noexcept;
+		[[nodiscard]] const_iterator cend() const noexcept;
+
+		/**
+		 * Inserts an element, given its '.hitbox()' location
+		 * Iterators are invalidated
+		 */
+		iterator insert(const value_type& value);
+
+		/**
+		 * Iterators are invalidated
+		 */
+		template <typename... Args>
+		iterator emplace(const area& target, Args&&... args);
+
+		/**
+		 * Visits all elements on the given area
+		 * The visitor function should not attempt to insert or remove an element in or from the collection.
+		 * If the visitor returns true, the element is safely deleted (iterators are invalidated).
+		 */
+		template <typename FuncT>
+		std::enable_if_t<std::is_invocable_v<FuncT, iterator>>
+		visit(const area& target, FuncT&& visitor) noexcept(std::is_nothrow_invocable_v<FuncT, iterator>);
+
+		/**
+		 * Thread-safe: several threads may visit the grid concurrently, as long as none of them modifies it.
+		 */
+		template <typename FuncT>
+		std::enable_if_t<std::is_invocable_v<FuncT, const_iterator>>
+		visit(const area& target, FuncT&& visitor) const noexcept(std::is_nothrow_invocable_v<FuncT, const_iterator>);
+
+		/**
+		 * Same as the const visit, but the rows of cells are visited by the workers of 'pool' when 'target' spans many cells
+		 * The visitor may thus be called concurrently from several threads. Returns once every element has been visited.
+		 */
+		template <typename FuncT>
+		void parallel_visit(const area& target, FuncT&& visitor, thread_pool& pool) const;
+
+		[[nodiscard]] bool empty() const noexcept;
+
+		[[nodiscard]] size_type size() const noexcept;
+
+		void clear() noexcept(noexcept(container().clear()));
+
+		/**
+		 * returns the element right after the erased one
+		 * Iterators are invalidated
+		 */
+		iterator erase(iterator it);
+		iterator erase(const_iterator it);
+		void erase(const T&);
+
+		/**
+		 * Returns true if at least one element is at least partially present in the given area
+		 */
+		[[nodiscard]] bool has_collision(const area& ar) const noexcept;
+
+		/**
+		 * Same as without 'pred', but the colliding element must be an argument for which pred returned true
+		 * 'pred' should take 'T&'/'const T&' as single parameter.
+		 * The const overload is thread-safe, as long as no thread modifies the grid meanwhile.
+		 */
+		template <typename FuncT>
+		[[nodiscard]] bool has_collision_if(const area& ar, FuncT&& pred) noexcept(std::is_nothrow_invocable_v<FuncT, T&>);
+		template <typename FuncT>
+		[[nodiscard]] bool has_collision_if(const area& ar, FuncT&& pred) const noexcept(std::is_nothrow_invocable_v<FuncT, const T&>);
+
+		/**
+		 * Same as the const has_collision_if, with the rows of cells split across the workers of 'pool' as in parallel_visit
+		 */
+		template <typename FuncT>
+		[[nodiscard]] bool parallel_has_collision_if(const area& ar, FuncT&& pred, thread_pool& pool) const;
+
+		/**
+		 * Calls 'func' once for each pair of colliding elements
+		 * Elements of a cell are tested against the other elements of the same cell and against the elements of the following
+		 * cells within reach of the largest element.
+		 * 'func' should take two 'T&'/'const T&' parameters, and should not attempt to insert or remove an element.
+		 */
+		template <typename FuncT>
+		void for_each_colliding_pair(FuncT&& func) noexcept(std::is_nothrow_invocable_v<FuncT, T&, T&>);
+		template <typename FuncT>
+		void for_each_colliding_pair(FuncT&& func) const noexcept(std::is_nothrow_invocable_v<FuncT, const T&, const T&>);
+
+		/**
+		 * Returns the first element crossed by the segment going from 'from' to 'to', or end() if there is none
+		 * Every cell of the bounding box of the segment is walked: prefer the quadtree for long rays.
+		 */
+		[[nodiscard]] iterator raycast(const point& from, const point& to) noexcept;
+		[[nodiscard]] const_iterator raycast(const point& from, const point& to) const noexcept;
+
+		/**
+		 * Same as without 'pred', but elements for which 'pred' returned false are ignored (the segment goes through them)
+		 */
+		template <typename FuncT>
+		[[nodiscard]] iterator raycast_if(const point& from, const point& to, FuncT&& pred) noexcept(std::is_nothrow_invocable_v<FuncT, T&>);
+		template <typename FuncT>
+		[[nodiscard]] const_iterator raycast_if(const point& from, const point& to, FuncT&& pred) const noexcept(std::is_nothrow_invocable_v<FuncT, const T&>);
+
+		/**
+		 * Iterators are invalidated
+		 */
+		[[nodiscard]] T extract(iterator element);
+		[[nodiscard]] T extract(const_iterator element);
+
+		[[nodiscard]] iterator find(const T& element) noexcept;
+		[[nodiscard]] const_iterator find(const T& element) const noexcept;
+
+		/**
+		 * Iterators are invalidated
+		 */
+		void move(iterator it, const area& new_area);
+		void move(const T& element, const area& new_area);
+		void move(const_iterator it, const area& new_area);
+
+		/**
+		 * Cells are reported as nodes of depth 0. Query statistics cover visit, has_collision_if and raycast calls since the
+		 * last reset_stats()
+		 */
+		[[nodiscard]] quadtree_stats stats() const;
+
+		void reset_stats() noexcept;
+
+		/**
+		 * The grid has no per-area parameter to tune: only there to keep the quadtree interface
+		 */
+		void adapt(const quadtree_tuning&) noexcept {}
+
+	private:
+
+		struct cell {
+			container values{};
+			hitbox_soa<Coord> hitboxes{}; // hitboxes[i] is the location of values[i]
+		};
+
+		// inclusive bounds, in cells
+		struct cell_range {
+			size_type min_x;
+			size_type min_y;
+			size_type max_x;
+			size_type max_y;
+		};
+
+		[[nodiscard]] size_type column_of(float x) const noexcept;
+		[[nodiscard]] size_type row_of(float y) const noexcept;
+
+		[[nodiscard]] size_type cell_of(const area& hitbox) const noexcept;
+
+		// cells that may hold an element colliding with 'target'
+		[[nodiscard]] cell_range cells_for(const area& target) const noexcept;
+
+		// replaces the value at 'idx' by the last value of the cell
+		void erase_value_at(cell& c, size_type idx);
+
+		template <typename IteratorType>
+		iterator erase_impl(IteratorType it);
+
+		template <typename IteratorType>
+		T extract_impl(IteratorType element);
+
+		template <typename IteratorType>
+		void move_impl(IteratorType it, const area& new_area);
+
+		template <typename IteratorType, typename Grid>
+		static IteratorType find_impl(Grid& grid, const T& element);
+
+		template <typename IteratorType, typename Grid, typename FuncT>
+		static void visit_row(Grid& grid, const cell_range& range, size_type row, const area& target, FuncT& visitor);
+
+		template <typename Grid, typename FuncT>
+		static bool has_collision_in_row(Grid& grid, const cell_range& range, size_type row, const area& ar, FuncT& pred);
+
+		template <typename Grid, typename FuncT>
+		static void colliding_pairs_impl(Grid& grid, FuncT& func);
+
+		template <typename IteratorType, typename Grid, typename FuncT>
+		static IteratorType raycast_impl(Grid& grid, const point& from, const point& to, FuncT& pred);
+
+		void count_query(const cell_range& range) const noexcept;
+
+		// true if 'range' is worth splitting across threads
+		[[nodiscard]] static bool is_large_query(const cell_range& range) noexcept;
+
+		area area_;
+		float cell_size_;
+		size_type columns_;
+		size_type rows_;
+
+		point max_extent_{}; // largest width and height inserted so far
+		size_type size_{0};
+
+		std::vector<cell> cells_; // row major
+
+		query_counter queries_{};
+		query_counter visited_cells_{};
+
+		friend const_iterator;
+		friend iterator;
+	};
+}
+
+
+#include "spatial_grid.tpp"
+
+
+#endif //DUNGEEP_SPATIAL_GRID_HPP
@@ -0,0 +1,232 @@
+#ifndef DUNGEEP_THREAD_POOL_HPP
+#define DUNGEEP_THREAD_POOL_HPP
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///                                                                                                                                     ///
+///  Copyright C 2019, Lucas Lazare                                                                                                     ///
+///  Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation         ///
+///  		files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy,  ///
+///  modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software     ///
+///  		is furnished to do so, subject to the following conditions:                                                                 ///
+///                                                                                                                                     ///
+///  The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.     ///
+///                                                                                                                                     ///
+///  The Software is provided “as is”, without warranty of any kind, express or implied, including but not limited to the               ///
+///  warranties of merchantability, fitness for a particular purpose and noninfringement. In no event shall the authors or              ///
+///  copyright holders be liable for any claim, damages or other liability, whether in an action of contract, tort or otherwise,        ///
+///  arising from, out of or in connection with the software or the use or other dealings in the Software.                              ///
+///                                                                                                                                     ///
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dungeep {
+
+	/**
+	 * Work stealing thread pool
+	 * Each worker owns a task queue: it pops tasks from the back of its own queue, and steals from the front of the others' when
+	 * it runs out of work. Tasks pushed from a worker go to its own queue, tasks pushed from other threads are spread across workers.
+	 *
+	 * Tasks are grouped in task_groups. Waiting for a group runs pending tasks instead of blocking, so that tasks may push
+	 * sub-tasks and wait for them without dead-locking the pool. An exception thrown by a task is rethrown by wait.
+	 */
+	class thread_pool {
+	public:
+		class task_group {
+		public:
+			task_group() noexcept = default;
+			task_group(const task_group&) = delete;
+			task_group& operator=(const task_group&) = delete;
+
+			[[nodiscard]] bool done() const noexcept {
+				return pending_.load(std::memory_order_acquire) == 0;
+			}
+
+		private:
+			friend thread_pool;
+
+			// keeps the first exception only
+			void fail(std::exception_ptr error) noexcept {
+				if (!failed_.exchange(true, std::memory_order_relaxed)) {
+					error_ = std::move(error);
+				}
+			}
+
+			std::atomic<std::size_t> pending_{0};
+			std::atomic<bool> failed_{false};
+			std::exception_ptr error_{}; // written before pending_ is decremented, read once it reached 0
+		};
+
+		explicit thread_pool(unsigned int worker_count = std::max(std::thread::hardware_concurrency(), 1u))
+			: queues_(std::max(worker_count, 1u))
+		{
+			for (auto& queue : queues_) {
+				queue = std::make_unique<task_queue>();
+			}
+			workers_.reserve(worker_count);
+			for (auto i = 0u ; i < worker_count ; ++i) {
+				workers_.emplace_back([this, i]() noexcept { worker_loop(i); });
+			}
+		}
+
+		thread_pool(const thread_pool&) = delete;
+		thread_pool& operator=(const thread_pool&) = delete;
+
+		~thread_pool() {
+			{
+				std::lock_guard lock{sleep_mutex_};
+				stopping_ = true;
+			}
+			wake_up_.notify_all();
+			for (std::thread& worker : workers_) {
+				worker.join();
+			}
+		}
+
+		[[nodiscard]] unsigned int worker_count() const noexcept {
+			return static_cast<unsigned int>(workers_.size());
+		}
+
+		/**
+		 * Schedules 'task', which should be callable without arguments, as part of 'group'
+		 * 'group' must outlive the task: wait for it before destroying it.
+		 */
+		template <typename FuncT>
+		void push(task_group& group, FuncT&& task) {
+			group.pending_.fetch_add(1, std::memory_order_relaxed);
+
+			// counted before being published, so that the worker running it never sees queued_ at 0
+			{
+				std::lock_guard lock{sleep_mutex_};
+				++queued_;
+			}
+			std::size_t queue_idx = current_pool == this ? current_queue : next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+			{
+				task_queue& queue = *queues_[queue_idx];
+				std::lock_guard lock{queue.mutex};
+				queue.tasks.emplace_back([&group, task = std::forward<FuncT>(task)]() mutable noexcept {
+					try {
+						task();
+					} catch (...) {
+						group.fail(std::current_exception());
+					}
+					group.pending_.fetch_sub(1, std::memory_order_release);
+				});
+			}
+			wake_up_.notify_one();
+		}
+
+		/**
+		 * Returns once every task of 'group' has been run. The calling thread runs pending tasks in the mean time.
+		 * If some tasks threw, the first exception is rethrown (once) after every task ran.
+		 */
+		void wait(task_group& group) {
+			const std::size_t queue_idx = current_pool == this ? current_queue : 0;
+			while (!group.done()) {
+				if (!try_run_one(queue_idx)) {
+					std::this_thread::yield();
+				}
+			}
+
+			if (group.failed_.load(std::memory_order_relaxed)) {
+				std::exception_ptr error = std::move(group.error_);
+				group.error_ = nullptr;
+				group.failed_.store(false, std::memory_order_relaxed);
+				std::rethrow_exception(error);
+			}
+		}
+
+	private:
+		struct task_queue {
+			std::mutex mutex{};
+			std::deque<std::function<void()>> tasks{};
+		};
+
+		bool try_run_one(std::size_t own_queue) noexcept {
+			std::function<void()> task;
+			for (auto i = 0u ; i < queues_.size() && !task ; ++i) {
+				task_queue& queue = *queues_[(own_queue + i) % queues_.size()];
+				std::lock_guard lock{queue.mutex};
+				if (!queue.tasks.empty()) {
+					if (i == 0) {
+						task = std::move(queue.tasks.back());
+						queue.tasks.pop_back();
+					} else {
+						task = std::move(queue.tasks.front());
+						queue.tasks.pop_front();
+					}
+				}
+			}
+
+			if (!task) {
+				return false;
+			}
+			{
+				std::lock_guard lock{sleep_mutex_};
+				--queued_;
+			}
+			task();
+			return true;
+		}
+
+		void worker_loop(std::size_t queue_idx) noexcept {
+			current_pool = this;
+			current_queue = queue_idx;
+
+			while (true) {
+				if (try_run_one(queue_idx)) {
+					continue;
+				}
+
+				std::unique_lock lock{sleep_mutex_};
+				wake_up_.wait(lock, [this] { return stopping_ || queued_ > 0; });
+				if (stopping_ && queued_ == 0) {
+					return;
+				}
+			}
+		}
+
+		inline static thread_local const thread_pool* current_pool{nullptr};
+		inline static thread_local std::size_t current_queue{0};
+
+		std::vector<std::unique_ptr<task_queue>> queues_;
+		std::vector<std::thread> workers_{};
+		std::atomic<std::size_t> next_queue_{0};
+
+		std::mutex sleep_mutex_{};
+		std::condition_variable wake_up_{};
+		std::size_t queued_{0};   // guarded by sleep_mutex_
+		bool stopping_{false};    // guarded by sleep_mutex_
+	};
+
+	/**
+	 * Calls 'run_strip(strip)' for each strip in [0 ; strip_count[, even strips first, then odd ones, so that two neighbouring strips
+	 * never run at the same time. Strips of a same parity run on 'pool' if 'parallel', one after the other from the calling thread
+	 * otherwise: either way, a strip sees its neighbours as they are before it runs if it is even, after if it is odd.
+	 */
+	template <typename FuncT>
+	void run_strips_by_parity(thread_pool& pool, unsigned int strip_count, bool parallel, FuncT&& run_strip) {
+		for (auto parity = 0u ; parity < 2 ; ++parity) {
+			thread_pool::task_group group;
+			for (auto strip = parity ; strip < strip_count ; strip += 2) {
+				if (parallel) {
+					pool.push(group, [&run_strip, strip] { run_strip(strip); });
+				} else {
+					run_strip(strip);
+				}
+			}
+			pool.wait(group);
+		}
+	}
+}
+
+#endif //DUNGEEP_THREAD_POOL_HPP
@@ -0,0 +1,181 @@
+#ifndef DUNGEEP_TICK_SCHEDULER_HPP
+#define DUNGEEP_TICK_SCHEDULER_HPP
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///                                                                                                                                     ///
+///  Copyright C 2019, Lucas Lazare                                                                                                     ///
+///  Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation         ///
+///  		files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy,  ///
+///  modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software     ///
+///  		is furnished to do so, subject to the following conditions:                                                                 ///
+///                                                                                                                                     ///
+///  The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.     ///
+///                                                                                                                                     ///
+///  The Software is provided “as is”, without warranty of any kind, express or implied, including but not limited to the               ///
+///  warranties of merchantability, fitness for a particular purpose and noninfringement. In no event shall the authors or              ///
+///  copyright holders be liable for any claim, damages or other liability, whether in an action of contract, tort or otherwise,        ///
+///  arising from, out of or in connection with the software or the use or other dealings in the Software.                              ///
+///                                                                                                                                     ///
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <type_traits>
+
+namespace dungeep {
+
+	// Histogram of durations, with power of two buckets: bucket i counts durations in [2^i ; 2^(i+1)[ microseconds,
+	// bucket 0 also counting shorter durations and the last bucket longer ones.
+	class duration_histogram {
+	public:
+		static constexpr unsigned int bucket_count = 16;
+
+		void add(std::chrono::nanoseconds duration) noexcept {
+			const auto micros = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(duration).count());
+			unsigned int bucket = 0;
+			while (bucket + 1 < bucket_count && (micros >> (bucket + 1)) != 0) {
+				++bucket;
+			}
+			++buckets_[bucket];
+			++count_;
+			total_ += duration;
+			if (duration > max_) {
+				max_ = duration;
+			}
+		}
+
+		void reset() noexcept {
+			*this = {};
+		}
+
+		[[nodiscard]] const std::array<std::uint64_t, bucket_count>& buckets() const noexcept {
+			return buckets_;
+		}
+
+		// lower bound of a bucket
+		[[nodiscard]] static constexpr std::chrono::microseconds bucket_floor(unsigned int bucket) noexcept {
+			return std::chrono::microseconds{bucket == 0 ? 0 : std::int64_t{1} << bucket};
+		}
+
+		[[nodiscard]] std::uint64_t count() const noexcept {
+			return count_;
+		}
+
+		[[nodiscard]] std::chrono::nanoseconds max() const noexcept {
+			return max_;
+		}
+
+		[[nodiscard]] std::chrono::nanoseconds mean() const noexcept {
+			return count_ == 0 ? std::chrono::nanoseconds{0} : total_ / static_cast<std::int64_t>(count_);
+		}
+
+		// upper bound of the bucket holding the given percentile, 'percentile' in [0 ; 1]
+		[[nodiscard]] std::chrono::microseconds percentile(float percentile) const noexcept {
+			const auto rank = static_cast<std::uint64_t>(percentile * static_cast<float>(count_));
+			std::uint64_t seen = 0;
+			for (auto bucket = 0u ; bucket + 1 < bucket_count ; ++bucket) {
+				seen += buckets_[bucket];
+				if (seen > rank) {
+					return bucket_floor(bucket + 1);
+				}
+			}
+			return std::chrono::duration_cast<std::chrono::microseconds>(max_);
+		}
+
+	private:
+		std::array<std::uint64_t, bucket_count> buckets_{};
+		std::uint64_t count_{0};
+		std::chrono::nanoseconds total_{0};
+		std::chrono::nanoseconds max_{0};
+	};
+
+	/**
+	 * Fixed timestep scheduler: converts the time elapsed between rendered frames into simulation ticks of constant length,
+	 * so that the simulation runs at the same rate whatever the frame rate, and gives the same results for the same inputs.
+	 *
+	 * When ticks take longer than their length, the backlog would keep growing: at most 'max_steps_per_frame' ticks are run per
+	 * frame, and the rest of the backlog is dropped (the simulation slows down instead of freezing the display).
+	 */
+	class tick_scheduler {
+	public:
+		using clock = std::chrono::steady_clock;
+		using duration = std::chrono::nanoseconds;
+
+		static constexpr duration default_tick_length = std::chrono::duration_cast<duration>(std::chrono::seconds{1}) / 60;
+
+		explicit tick_scheduler(duration tick_length = default_tick_length, unsigned int max_steps_per_frame = 5) noexcept
+			: tick_length_{tick_length}
+			, max_steps_{max_steps_per_frame}
+		{}
+
+		/**
+		 * Adds 'elapsed' to the time to simulate, and calls 'tick' (without arguments) once per whole tick owed.
+		 * Returns the number of ticks run.
+		 */
+		template <typename FuncT>
+		unsigned int advance(duration elapsed, FuncT&& tick) noexcept(std::is_nothrow_invocable_v<FuncT>) {
+			accumulated_ += elapsed;
+
+			unsigned int steps = 0;
+			while (accumulated_ >= tick_length_ && steps < max_steps_) {
+				const clock::time_point start = clock::now();
+				tick();
+				durations_.add(clock::now() - start);
+
+				accumulated_ -= tick_length_;
+				++steps;
+				++tick_count_;
+			}
+
+			if (accumulated_ >= tick_length_) {
+				dropped_ticks_ += static_cast<std::uint64_t>(accumulated_ / tick_length_);
+				accumulated_ %= tick_length_;
+			}
+			return steps;
+		}
+
+		// progress towards the next tick, in [0 ; 1[, to interpolate what is displayed between two ticks
+		[[nodiscard]] float interpolation() const noexcept {
+			return std::chrono::duration<float>(accumulated_) / std::chrono::duration<float>(tick_length_);
+		}
+
+		[[nodiscard]] duration tick_length() const noexcept {
+			return tick_length_;
+		}
+
+		[[nodiscard]] unsigned int max_steps_per_frame() const noexcept {
+			return max_steps_;
+		}
+
+		[[nodiscard]] std::uint64_t tick_count() const noexcept {
+			return tick_count_;
+		}
+
+		// ticks skipped because more than max_steps_per_frame() were owed
+		[[nodiscard]] std::uint64_t dropped_ticks() const noexcept {
+			return dropped_ticks_;
+		}
+
+		// time spent in each tick
+		[[nodiscard]] const duration_histogram& tick_durations() const noexcept {
+			return durations_;
+		}
+
+		void reset_stats() noexcept {
+			durations_.reset();
+			dropped_ticks_ = 0;
+		}
+
+	private:
+		duration tick_length_;
+		unsigned int max_steps_;
+		duration accumulated_{0};
+
+		std::uint64_t tick_count_{0};
+		std::uint64_t dropped_ticks_{0};
+		duration_histogram durations_{};
+	};
+}
+
+#endif //DUNGEEP_TICK_SCHEDULER_HPP
@@ -339,7 +339,7 @@ void map_tester::updateMap()
 	dungeep::random_engine.seed(m_seed);
 	separator(spdlog::info);
 	spdlog::info("Generating map {}", m_seed);
-	m_map.generate(m_map_props.size, m_map_props.rooms_props, m_map_props.hallways_props);
+	m_map_cache.generate(m_map, m_map_props.size, m_map_props.rooms_props, m_map_props.hallways_props, dungeep::random_engine());
 	spdlog::trace("Time spent generating rooms: {}ms", m_map.rooms_generation_time.count());
 	spdlog::trace("Time spent generating halls: {}ms", m_map.halls_generation_time.count());
 	spdlog::trace("Time spent generating fuzziness: {}ms", m_map.fuzzy_generation_time.count());
@@ -19,6 +19,8 @@
 #include <utils/misc.hpp>
 #include <imterm/terminal.hpp>
 #include <any>
+#include <string_view>
+#include <chrono>
 
 namespace {
 
@@ -30,7 +32,9 @@ namespace {
 			terminal_commands::command_type{"help", "show this help", terminal_commands::help, terminal_commands::no_completion},
 			terminal_commands::command_type{"print", "prints text", terminal_commands::echo, terminal_commands::no_completion},
 			terminal_commands::command_type{"print_resource", "prints resources file", terminal_commands::print_resource, terminal_commands::no_completion},
+			terminal_commands::command_type{"qtree_stats", "prints the world's spatial indexes statistics", terminal_commands::qtree_stats, terminal_commands::no_completion},
 			terminal_commands::command_type{"quit", "closes this application", terminal_commands::quit, terminal_commands::no_completion},
+			terminal_commands::command_type{"tick_stats", "prints the simulation ticks durations", terminal_commands::tick_stats, terminal_commands::no_completion},
 	};
 
 	namespace cfg_term {
@@ -396,6 +400,52 @@ void terminal_commands::print_resource(argument_type& arg) {
 	arg.term.add_formatted_err("TODO");
 }
 
+void terminal_commands::qtree_stats(argument_type& arg) {
+	if (arg.command_line.size() == 2 && arg.command_line[1] == "reset") {
+		arg.val.world.reset_objects_stats();
+		return;
+	}
+	if (arg.command_line.size() != 1) {
+		arg.term.add_formatted("usage: {} [reset]", arg.command_line[0]);
+		return;
+	}
+
+	auto print = [&arg](std::string_view name, const dungeep::quadtree_stats& stats) {
+		arg.term.add_formatted("{}: {} nodes, {} bytes, {} elements in interior nodes", name, stats.node_count, stats.allocated_bytes, stats.interior_elements);
+		arg.term.add_formatted("        {} queries, {:.2f} nodes visited per query", stats.query_count, stats.average_query_visits());
+		for (auto depth = 0u ; depth < stats.nodes_per_depth.size() ; ++depth) {
+			arg.term.add_formatted("        depth {:2} | {:6} nodes | {:6} elements", depth, stats.nodes_per_depth[depth], stats.elements_per_depth[depth]);
+		}
+	};
+
+	print("dynamic objects", arg.val.world.dynamic_objects_stats());
+	print("static objects", arg.val.world.static_objects_stats());
+}
+
 void terminal_commands::quit(argument_type& arg) {
 	arg.val.running = false;
 }
+
+void terminal_commands::tick_stats(argument_type& arg) {
+	if (arg.command_line.size() == 2 && arg.command_line[1] == "reset") {
+		arg.val.scheduler.reset_stats();
+		return;
+	}
+	if (arg.command_line.size() != 1) {
+		arg.term.add_formatted("usage: {} [reset]", arg.command_line[0]);
+		return;
+	}
+
+	using micros = std::chrono::duration<float, std::micro>;
+	const dungeep::tick_scheduler& scheduler = arg.val.scheduler;
+	const dungeep::duration_histogram& durations = scheduler.tick_durations();
+	arg.term.add_formatted("{} ticks of {:.0f}us, at most {} per frame, {} dropped", scheduler.tick_count(),
+			micros(scheduler.tick_length()).count(), scheduler.max_steps_per_frame(), scheduler.dropped_ticks());
+	arg.term.add_formatted("        mean {:.1f}us, max {:.1f}us, 99th percentile under {}us", micros(durations.mean()).count(),
+			micros(durations.max()).count(), durations.percentile(0.99f).count());
+	for (auto bucket = 0u ; bucket < dungeep::duration_histogram::bucket_count ; ++bucket) {
+		if (durations.buckets()[bucket] != 0) {
+			arg.term.add_formatted("        from {:6}us | {:8} ticks", dungeep::duration_histogram::bucket_floor(bucket).count(), durations.buckets()[bucket]);
+		}
+	}
+}
@@ -19,16 +19,56 @@
 #include <algorithm>
 #include <unordered_set>
 #include <set>
+#include <optional>
+#include <cmath>
 #include <environment/map.hpp>
 #include <chrono>
-#include <utils/quadtree.hpp>
+#include <utils/flat_quadtree.hpp>
 #include <spdlog/spdlog.h>
 
 #include "utils/random.hpp"
+#include "utils/thread_pool.hpp"
 #include "environment/map.hpp"
 
+namespace {
+	// each unit of work of the generation draws from its own engine, so that the result does not depend on the scheduling
+	enum class generation_phase : std::uint32_t {
+		planning,
+		rooms,
+		hallway_selection,
+		hallways,
+	};
+
+	dungeep::default_engine unit_engine(std::uint64_t seed, generation_phase phase, std::uint32_t unit) noexcept {
+		dungeep::splitmix64 mixer{seed ^ (static_cast<std::uint64_t>(phase) << 32u | unit)};
+		return dungeep::default_engine{mixer()};
+	}
+
+	// runs unit(0), ..., unit(count - 1) on 'pool', or in order on the calling thread if there is no pool
+	template <typename FuncT>
+	void for_each_unit(dungeep::thread_pool* pool, std::size_t count, FuncT&& unit) {
+		if (pool == nullptr) {
+			for (std::size_t i = 0 ; i < count ; ++i) {
+				unit(i);
+			}
+			return;
+		}
+
+		dungeep::thread_pool::task_group group;
+		for (std::size_t i = 0 ; i < count ; ++i) {
+			pool->push(group, [&unit, i] { unit(i); });
+		}
+		pool->wait(group);
+	}
+}
+
 std::vector<map::map_area> map::generate(size_type size, const std::vector<room_gen_properties>& rooms_properties,
-                                    const hallway_gen_properties& hgp) {
+                                         const hallway_gen_properties& hgp) {
+	return generate(size, rooms_properties, hgp, dungeep::random_engine());
+}
+
+std::vector<map::map_area> map::generate(size_type size, const std::vector<room_gen_properties>& rooms_properties,
+                                         const hallway_gen_properties& hgp, std::uint64_t seed, dungeep::thread_pool* pool) {
 	using std::chrono::duration_cast;
 	using std::chrono::system_clock;
 	using std::chrono::milliseconds;
@@ -42,14 +82,20 @@ std::vector<map::map_area> map::generate(size_type size, const std::vector<room_
 	assert(size.width > 0);
 	assert(!rooms_properties.empty());
 
-	std::vector<map_area> rooms;
-	rooms.reserve(rooms_properties.size() * static_cast<unsigned long>(rooms_properties[0].avg_rooms_n));
+	struct room_unit {
+		const room_gen_properties* properties;
+		unsigned int hole_count;
+		dungeep::default_engine rand;
+		zone_stamp room{};
+		std::vector<zone_stamp> holes{};
+	};
 
-	auto room_starting_tp = system_clock::now();
-	spdlog::debug("[Map] - Generating rooms.");
+	// planning: how many rooms, and how many holes in each room
+	std::vector<room_unit> units;
+	dungeep::default_engine planning_rand = unit_engine(seed, generation_phase::planning, 0);
 	for (const room_gen_properties& rp : rooms_properties) {
-		auto rooms_n = gen_positive(rp.avg_rooms_n, rp.rooms_n_dev);
-		auto holes_n = gen_positive(rp.avg_holes_n, rp.holes_n_dev);
+		auto rooms_n = gen_positive(rp.avg_rooms_n, rp.rooms_n_dev, planning_rand);
+		auto holes_n = gen_positive(rp.avg_holes_n, rp.holes_n_dev, planning_rand);
 
 		expected_room_count += static_cast<unsigned>(rooms_n - 0.3f) + 2;
 		expected_hole_count += static_cast<unsigned>(holes_n);
@@ -58,17 +104,39 @@ std::vector<map::map_area> map::generate(size_type size, const std::vector<room_
 
 			unsigned int hfr = std::min(
 					static_cast<unsigned int>(holes_n),
-					static_cast<unsigned int>(gen_positive(holes_n / (rooms_n - static_cast<float>(i)), 2.5f))
+					static_cast<unsigned int>(gen_positive(holes_n / (rooms_n - static_cast<float>(i)), 2.5f, planning_rand))
 			);
 
 			holes_n -= static_cast<float>(hfr);
-			map_area room = generate_holed_room(rp, hfr);
-			if (room.x != 0 && room.y != 0) {
-				++actual_room_count;
-				rooms.push_back(room);
-			}
+			units.push_back({&rp, hfr, unit_engine(seed, generation_phase::rooms, static_cast<std::uint32_t>(units.size()))});
+		}
+		units.push_back({&rp, static_cast<unsigned int>(holes_n), unit_engine(seed, generation_phase::rooms, static_cast<std::uint32_t>(units.size()))});
+	}
+
+	auto room_starting_tp = system_clock::now();
+	spdlog::debug("[Map] - Generating rooms.");
+
+	// shaping, in parallel: dimensions and fuzzy borders of the rooms and of their holes
+	for_each_unit(pool, units.size(), [&units](std::size_t idx) {
+		room_unit& unit = units[idx];
+		const dungeep::point_ui room_dim = generate_zone_dimensions(unit.properties->rooms_properties, unit.rand);
+		unit.room = generate_zone(unit.properties->rooms_properties, room_dim, tiles::walkable, unit.rand);
+
+		unit.holes.reserve(unit.hole_count);
+		for (auto i = 0u ; i < unit.hole_count ; ++i) {
+			dungeep::point_ui hole_dim = generate_zone_dimensions(unit.properties->holes_properties, unit.rand);
+			hole_dim.x = std::min(hole_dim.x, room_dim.x - 1);
+			hole_dim.y = std::min(hole_dim.y, room_dim.y - 1);
+			unit.holes.push_back(generate_zone(unit.properties->holes_properties, hole_dim, tiles::hole, unit.rand));
 		}
-		map_area room = generate_holed_room(rp, static_cast<unsigned int>(holes_n));
+	});
+	fuzzy_generation_time = duration_cast<milliseconds>(system_clock::now() - room_starting_tp);
+
+	// merging, in order: each room is placed where the previous ones left space
+	std::vector<map_area> rooms;
+	rooms.reserve(units.size());
+	for (room_unit& unit : units) {
+		map_area room = place_holed_room(unit.room, unit.holes, unit.rand);
 		if (room.x != 0 && room.y != 0) {
 			++actual_room_count;
 			rooms.push_back(room);
@@ -78,7 +146,7 @@ std::vector<map::map_area> map::generate(size_type size, const std::vector<room_
 	rooms_generation_time = duration_cast<milliseconds>(system_clock::now() - room_starting_tp);
 
 	auto halls_tp = system_clock::now();
-	ensure_pathing(rooms, hgp);
+	ensure_pathing(rooms, hgp, seed, pool);
 	halls_generation_time = duration_cast<milliseconds>(system_clock::now() - halls_tp);
 
 	total_generation_time = duration_cast<milliseconds>(system_clock::now() - starting_tp);
@@ -86,26 +154,21 @@ std::vector<map::map_area> map::generate(size_type size, const std::vector<room_
 	return rooms;
 }
 
-void map::ensure_pathing(const std::vector<map_area>& rooms, const hallway_gen_properties& properties) {
+void map::ensure_pathing(const std::vector<map_area>& rooms, const hallway_gen_properties& properties, std::uint64_t seed, dungeep::thread_pool* pool) {
 
 	spdlog::debug("[Map] - Generating hallways.");
 
 	struct collider {
-		const dungeep::area_f& hitbox() const {
+		const dungeep::area_i& hitbox() const {
 			return hitbox_;
 		}
 
-		dungeep::area_f hitbox_;
+		dungeep::area_i hitbox_;
 		dungeep::point_ui room_center;
 	};
-	dungeep::quadtree<collider, dungeep::quadtree_dynamics::static_children> qt(
-			dungeep::area_f{
-					dungeep::point_f{0.f, 0.f},
-					dungeep::point_f{static_cast<float>(size().width), static_cast<float>(size().height)}
-			},
-			3,
-			5
-	);
+	const auto width = static_cast<int>(size().width);
+	const auto height = static_cast<int>(size().height);
+	dungeep::flat_quadtree<collider, 3, std::vector, int> qt(dungeep::area_i{{0, 0}, {width, height}});
 
 	std::vector<dungeep::point_ui> rooms_center;
 	rooms_center.reserve(rooms.size());
@@ -123,64 +186,118 @@ void map::ensure_pathing(const std::vector<map_area>& rooms, const hallway_gen_p
 			distances.push_back(distance);
 		}
 
-		auto x = static_cast<float>(center_1.x);
-		auto y = static_cast<float>(center_1.y);
-		dungeep::area_f htbox{
-				dungeep::point_f{x - 1.f, y - 1.f},
-				dungeep::point_f{x + 1.f, y + 1.f}
-		};
-		qt.insert({htbox, center_1});
+		dungeep::point_i center{center_1};
+		qt.insert({{center - dungeep::point_i{1, 1}, center + dungeep::point_i{1, 1}}, center_1});
 	}
 
 	avg_distance /= static_cast<float>(rooms_center.size() * (rooms_center.size() - 1));
 	std::sort(distances.begin(), distances.end());
 
+	// selecting the pairs of rooms that should be connected
+	struct room_pair {
+		dungeep::point_ui from;
+		dungeep::point_ui to;
+		int max_depth;
+	};
+	std::vector<room_pair> pairs;
+	dungeep::default_engine selection_rand = unit_engine(seed, generation_phase::hallway_selection, 0);
+
 	float selected_distance = std::max(distances[distances.size() / 30], avg_distance / 30.f);
+	const auto selected_reach = static_cast<int>(std::ceil(selected_distance));
+	const auto selected_depth = static_cast<int>(selected_distance * 2.f);
 	for (const dungeep::point_ui& room : rooms_center) {
-		auto x = static_cast<float>(room.x);
-		auto y = static_cast<float>(room.y);
-		dungeep::area_f htbox{
-				dungeep::point_f{x - selected_distance, y - selected_distance},
-				dungeep::point_f{x + selected_distance, y + selected_distance}
+		dungeep::point_i center{room};
+		dungeep::area_i htbox{
+				center - dungeep::point_i{selected_reach, selected_reach},
+				center + dungeep::point_i{selected_reach, selected_reach}
 		};
 
-		qt.visit(htbox, [this, &properties, &room, &selected_distance](auto it) {
-			if (dungeep::random_engine() % 2) {
-				if (path_to(dungeep::point_i(room), dungeep::point_i(it->room_center), std::numeric_limits<float>::infinity(), static_cast<int>(selected_distance * 2.f)).empty()) {
-					ensure_tworoom_path(room, it->room_center, properties);
-				}
+		qt.visit(htbox, [&pairs, &selection_rand, &room, selected_depth](auto it) {
+			if (dungeep::bounded_rand(selection_rand, 2u)) {
+				pairs.push_back({room, it->room_center, selected_depth});
 			}
 		});
 	}
 
 	for (const dungeep::point_ui& room : rooms_center) {
-		auto x = static_cast<float>(room.x);
-		auto y = static_cast<float>(room.y);
-		dungeep::area_f htbox{
-				dungeep::point_f{x - static_cast<float>(size().width) / 10.f, y - static_cast<float>(size().height) / 10.f},
-				dungeep::point_f{x + static_cast<float>(size().width) / 10.f, y + static_cast<float>(size().height) / 10.f}
+		dungeep::point_i center{room};
+		dungeep::area_i htbox{
+				center - dungeep::point_i{width / 10, height / 10},
+				center + dungeep::point_i{width / 10, height / 10}
 		};
 
-		qt.visit(htbox, [this, &properties, &room, &selected_distance](auto it) {
-			if (path_to(dungeep::point_i(room), dungeep::point_i(it->room_center), std::numeric_limits<float>::infinity(), static_cast<int>(selected_distance * 2.f)).empty()) {
-				ensure_tworoom_path(room, it->room_center, properties);
-			}
+		qt.visit(htbox, [&pairs, &room, selected_depth](auto it) {
+			pairs.push_back({room, it->room_center, selected_depth});
 		});
 	}
 
 	for (auto i1 = qt.begin(), i2 = std::next(i1) ; !i2.is_at_end() && !i1.is_at_end() ; ++i1, ++i2) {
-		if (dungeep::random_engine() % 3) {
-			if (path_to(dungeep::point_i(i1->room_center), dungeep::point_i(i2->room_center),
-			            std::numeric_limits<float>::infinity()).empty()) {
-				ensure_tworoom_path(i1->room_center, i2->room_center, properties);
-			}
+		if (dungeep::bounded_rand(selection_rand, 3u)) {
+			pairs.push_back({i1->room_center, i2->room_center, std::numeric_limits<int>::max()});
+		}
+	}
+
+	// in parallel, on the map without hallways: which pairs are already connected, and the hallways of the others.
+	// Hallways only add walkable tiles, so pairs connected at this point stay connected: only the other ones need to be
+	// checked again in order, which gives the same map as checking every pair in order.
+	auto connected = [this](const room_pair& pair) {
+		return !path_to(dungeep::point_i(pair.from), dungeep::point_i(pair.to), std::numeric_limits<float>::infinity(), pair.max_depth).empty();
+	};
+
+	std::vector<char> connected_before(pairs.size());
+	std::vector<hallway> hallways(pairs.size());
+	for_each_unit(pool, pairs.size(), [&](std::size_t idx) {
+		connected_before[idx] = connected(pairs[idx]);
+		if (!connected_before[idx]) {
+			dungeep::default_engine rand = unit_engine(seed, generation_phase::hallways, static_cast<std::uint32_t>(idx));
+			hallways[idx] = plan_hallway(pairs[idx].from, pairs[idx].to, properties, rand);
+		}
+	});
+
+	for (auto i = 0u ; i < pairs.size() ; ++i) {
+		if (!connected_before[i] && !connected(pairs[i])) {
+			carve_hallway(hallways[i]);
 		}
 	}
 
 	spdlog::debug("[Map] - Generating hallways: done.");
 }
 
-void map::ensure_tworoom_path(const dungeep::point_ui& r1_center, const dungeep::point_ui& r2_center, const hallway_gen_properties& properties) {
+map::hallway map::plan_hallway(const dungeep::point_ui& r1_center, const dungeep::point_ui& r2_center, const hallway_gen_properties& properties,
+                               dungeep::default_engine& rand) {
+
+	using dungeep::point_i;
+
+	point_i dep{r1_center};
+	point_i arr{r2_center};
+
+	hallway ans;
+	ans.stop_offs.push_back(dep);
+
+	if (static_cast<float>((dep - arr).length()) >= properties.curly_min_distance) {
+		dungeep::normal_distribution curliness(0.f, std::max(properties.curliness, 0.001f));
+		dungeep::normal_distribution curly_size(properties.curly_segment_avg_size, std::max(properties.curly_segment_size_dev, 0.001f));
+		do {
+			point_i translate = arr - ans.stop_offs.back();
+			float segment_size = std::max(curly_size(rand), properties.curly_min_distance);
+			float segment_angle = curliness(rand) * static_cast<float>(M_PI) / 4;
+
+			translate.rotate(segment_angle);
+			translate.scale_to(segment_size);
+
+			ans.stop_offs.push_back(translate + ans.stop_offs.back());
+
+		} while (static_cast<float>((ans.stop_offs.back() - arr).length()) >= properties.curly_min_distance);
+	}
+
+	ans.stop_offs.push_back(arr);
+
+	dungeep::normal_distribution width(properties.avg_width, std::max(properties.width_dev, 0.001f));
+	ans.width = static_cast<int>(std::clamp(static_cast<unsigned int>(width(rand)), properties.min_width, properties.max_width));
+	return ans;
+}
+
+void map::carve_hallway(const hallway& path) {
 
 	using dungeep::point_i;
 	using dungeep::point_f;
@@ -215,139 +332,109 @@ void map::ensure_tworoom_path(const dungeep::point_ui& r1_center, const dungeep:
 		}
 	};
 
-	point_i dep{r1_center};
-	point_i arr{r2_center};
-
-	std::vector<dungeep::point_i> stop_offs;
-	stop_offs.push_back(dep);
-
-	if (static_cast<float>((dep - arr).length()) >= properties.curly_min_distance) {
-		dungeep::normal_distribution curliness(0.f, std::max(properties.curliness, 0.001f));
-		dungeep::normal_distribution curly_size(properties.curly_segment_avg_size, std::max(properties.curly_segment_size_dev, 0.001f));
-		do {
-			point_i translate = arr - stop_offs.back();
-			float segment_size = std::max(curly_size(dungeep::random_engine), properties.curly_min_distance);
-			float segment_angle = curliness(dungeep::random_engine) * static_cast<float>(M_PI) / 4;
-
-			translate.rotate(segment_angle);
-			translate.scale_to(segment_size);
-
-			stop_offs.push_back(translate + stop_offs.back());
-
-		} while (static_cast<float>((stop_offs.back() - arr).length()) >= properties.curly_min_distance);
-	}
-
-	stop_offs.push_back(arr);
-
-	dungeep::normal_distribution width(properties.avg_width, std::max(properties.width_dev, 0.001f));
-	auto w = static_cast<int>(std::clamp(static_cast<unsigned int>(width(dungeep::random_engine)), properties.min_width, properties.max_width));
-	for (auto i = 0u ; i + 1 < stop_offs.size() ; ++i) {
-		point_i start = stop_offs[i];
-		point_i end = stop_offs[i + 1];
+	for (auto i = 0u ; i + 1 < path.stop_offs.size() ; ++i) {
+		point_i start = path.stop_offs[i];
+		point_i end = path.stop_offs[i + 1];
 		point_f translate(end - start);
 		auto segment_length = translate.length();
 		translate.scale_to(1.f);
 		for (auto j = 0u ; j < static_cast<unsigned>(segment_length + 0.9f) ; ++j) {
-			point_i current = point_i(point_f(stop_offs[i]) + static_cast<float>(j) * translate);
-			place_point(current, w);
+			point_i current = point_i(point_f(start) + static_cast<float>(j) * translate);
+			place_point(current, path.width);
 		}
 	}
 }
 
-map::map_area map::generate_holed_room(const room_gen_properties& rp, unsigned int hole_count) {
-	bool failed;
-	int fail_count = 0;
-
-	dungeep::point_ui room_dim{}, room_pos{};
+map::map_area map::place_holed_room(const zone_stamp& room, const std::vector<zone_stamp>& holes, dungeep::default_engine& rand) {
+	dungeep::point_ui room_pos{};
 
+	int fail_count = 0;
 	do {
-		failed = false;
-		room_dim = generate_zone_dimensions(rp.rooms_properties);
-		room_pos = find_zone_filled_with(room_dim, tiles::empty_space);
-		if (room_pos.x == 0 && room_pos.y == 0) {
-			failed = true;
-			++fail_count;
-		}
-	} while (failed && fail_count < 30);
+		room_pos = find_zone_filled_with(room.dim, tiles::empty_space, rand);
+	} while (room_pos.x == 0 && room_pos.y == 0 && ++fail_count < 30);
 
-	if (failed) {
+	if (room_pos.x == 0 && room_pos.y == 0) {
 		return {0, 0, 0, 0};
 	}
 
-	map_area room_area{room_pos.x, room_pos.y, room_dim.x, room_dim.y};
-	generate_tiles(rp.rooms_properties, room_area, tiles::walkable);
+	map_area room_area{room_pos.x, room_pos.y, room.dim.x, room.dim.y};
+	stamp_zone(room, room_pos);
 
-	for (auto i = 0u ; i < hole_count ; ++i) {
+	for (const zone_stamp& hole : holes) {
 		fail_count = 0;
 		do {
-			dungeep::point_ui hole_dim = generate_zone_dimensions(rp.holes_properties);
-			hole_dim.x = std::min(hole_dim.x, room_area.width - 1);
-			hole_dim.y = std::min(hole_dim.y, room_area.height - 1);
-			dungeep::point_ui hole_pos = find_zone_filled_with(hole_dim, tiles::walkable, room_area);
-			if (hole_pos.x == 0 && hole_pos.y == 0) {
-				++fail_count;
-				failed = true;
-			} else {
-				generate_tiles(rp.holes_properties, {hole_pos.x, hole_pos.y, hole_dim.x, hole_dim.y}, tiles::hole);
+			dungeep::point_ui hole_pos = find_zone_filled_with(hole.dim, tiles::walkable, room_area, rand);
+			if (hole_pos.x != 0 || hole_pos.y != 0) {
+				stamp_zone(hole, hole_pos);
 				++actual_hole_count;
-				failed = false;
+				break;
 			}
-		} while (failed && fail_count < 10);
+		} while (++fail_count < 10);
 	}
 
 	return room_area;
 }
 
-void map::generate_tiles(const zone_gen_properties& rp, map_area tiles_area, tiles tile) {
+map::zone_stamp map::generate_zone(const zone_gen_properties& rp, dungeep::point_ui dim, tiles tile, dungeep::default_engine& rand) {
 	dungeep::normal_distribution zone_fuzziness(0.f, std::max(rp.borders_fuzzy_deviation, 0.001f));
 
-	auto array_shift = static_cast<unsigned int>(rp.borders_fuzzinness + rp.borders_fuzzy_deviation * 4) * 2;
-	std::vector<std::vector<tiles>> generated_room{
-			tiles_area.width + array_shift,
+	zone_stamp zone;
+	zone.dim = dim;
+	zone.margin = static_cast<unsigned int>(rp.borders_fuzzinness + rp.borders_fuzzy_deviation * 4) * 2;
+	zone.grid = {
+			dim.x + zone.margin,
 			std::vector<tiles>{
-					tiles_area.height + array_shift,
+					dim.y + zone.margin,
 					tiles::none
 			}
 	};
 
-	for (auto i = 0u ; i < tiles_area.width ; ++i) {
-		for (auto j = 0u ; j < tiles_area.height ; ++j) {
-			generated_room[i + array_shift][j + array_shift] = tile;
+	for (auto i = 0u ; i < dim.x ; ++i) {
+		for (auto j = 0u ; j < dim.y ; ++j) {
+			zone.grid[i + zone.margin][j + zone.margin] = tile;
 		}
 	}
 
 	map_area ar{};
-	ar.x = ar.y = array_shift;
-	ar.width = tiles_area.width;
-	ar.height = tiles_area.height;
+	ar.x = ar.y = zone.margin;
+	ar.width = dim.x;
+	ar.height = dim.y;
 
-	auto tp = std::chrono::system_clock::now();
-	add_fuzziness(generated_room, rp, ar, tile, zone_fuzziness);
-	fuzzy_generation_time += std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - tp);
+	add_fuzziness(zone.grid, rp, ar, tile, zone_fuzziness, rand);
+	return zone;
+}
 
-	unsigned int min_i = array_shift > tiles_area.x ? array_shift - tiles_area.x : 0u;
-	unsigned int min_j = array_shift > tiles_area.y ? array_shift - tiles_area.y : 0u;
+void map::stamp_zone(const zone_stamp& zone, dungeep::point_ui pos) {
+	const unsigned int array_shift = zone.margin;
+	unsigned int min_i = array_shift > pos.x ? array_shift - pos.x : 0u;
+	unsigned int min_j = array_shift > pos.y ? array_shift - pos.y : 0u;
 
-	for (auto i = min_i ; i < generated_room.size() && tiles_area.x + i < m_tiles.size() + array_shift ; ++i) {
-		for (auto j = min_j ; j < generated_room[i].size() && tiles_area.y + j < m_tiles[i].size() + array_shift; ++j) {
-			if (generated_room[i][j] != tiles::none) {
-				m_tiles[i + tiles_area.x - array_shift][j + tiles_area.y - array_shift] = generated_room[i][j];
+	for (auto i = min_i ; i < zone.grid.size() && pos.x + i < m_tiles.size() + array_shift ; ++i) {
+		for (auto j = min_j ; j < zone.grid[i].size() && pos.y + j < m_tiles[i].size() + array_shift; ++j) {
+			if (zone.grid[i][j] != tiles::none) {
+				m_tiles[i + pos.x - array_shift][j + pos.y - array_shift] = zone.grid[i][j];
 			}
 		}
 	}
 }
 
 void map::add_fuzziness(std::vector<std::vector<tiles>>& generated_room, const zone_gen_properties& rp, const map_area& tiles_area,
-                        tiles tile, dungeep::normal_distribution<float>& zone_fuzziness) {
+                        tiles tile, dungeep::normal_distribution<float>& zone_fuzziness, dungeep::default_engine& rand) {
 
 	float current_delta = 0.f;
 	float delta_step = 0.f;
+	std::vector<float> fuzziness;
 
 	auto generate_fuzziness = [&](unsigned int min, unsigned int max, float delta_max, auto&& assigner) {
 
+		// one target every borders_fuzzy_distance tiles, drawn at once
+		fuzziness.resize(max > min ? (max - min + rp.borders_fuzzy_distance - 1) / rp.borders_fuzzy_distance : 0u);
+		zone_fuzziness.generate(fuzziness.begin(), fuzziness.end(), rand);
+		auto next_fuzziness = fuzziness.cbegin();
+
 		for (auto i = min; i < max ; ++i) {
 			if ((i % rp.borders_fuzzy_distance) == (min % rp.borders_fuzzy_distance)) {
-				float target_delta = std::clamp(zone_fuzziness(dungeep::random_engine) * rp.borders_fuzzinness, -delta_max, delta_max);
+				float target_delta = std::clamp(*next_fuzziness++ * rp.borders_fuzzinness, -delta_max, delta_max);
 				delta_step = (target_delta - current_delta) / static_cast<float>(rp.borders_fuzzy_distance);
 			}
 			current_delta += delta_step;
@@ -399,7 +486,7 @@ void map::add_fuzziness(std::vector<std::vector<tiles>>& generated_room, const z
 }
 
 dungeep::point_ui
-map::find_zone_filled_with(dungeep::point_ui zone_dim, tiles tile, map_area area) const noexcept {
+map::find_zone_filled_with(dungeep::point_ui zone_dim, tiles tile, map_area area, dungeep::default_engine& rand) const noexcept {
 
 	assert(zone_dim.x < area.width);
 	assert(zone_dim.y < area.height);
@@ -431,8 +518,8 @@ map::find_zone_filled_with(dungeep::point_ui zone_dim, tiles tile, map_area area
 
 	int fail_count = 0;
 	do {
-		ans.x = uid_x(dungeep::random_engine);
-		ans.y = uid_y(dungeep::random_engine);
+		ans.x = uid_x(rand);
+		ans.y = uid_y(rand);
 	} while(!is_good_spot(ans) && fail_count++ < 100);
 
 	if (fail_count >= 100) {
@@ -442,25 +529,23 @@ map::find_zone_filled_with(dungeep::point_ui zone_dim, tiles tile, map_area area
 	return ans;
 }
 
-float map::gen_positive(float avg, float dev) {
+float map::gen_positive(float avg, float dev, dungeep::default_engine& rand) {
 	dungeep::normal_distribution dist{avg, std::max(dev, 0.001f)};
-	float nbr = dist(dungeep::random_engine);
+	float nbr = dist(rand);
 	return nbr > 0 ? nbr : 0.f;
 }
 
-dungeep::point_ui map::generate_zone_dimensions(const zone_gen_properties& zgp) {
-	std::mt19937_64 random_engine;
-
+dungeep::point_ui map::generate_zone_dimensions(const zone_gen_properties& zgp, dungeep::default_engine& rand) {
 	auto min_area = zgp.min_height;
 	min_area *= min_area;
 	auto max_area = zgp.max_height;
 	max_area *= max_area;
 
-	float room_area = std::clamp(gen_positive(zgp.avg_size, zgp.size_deviation), static_cast<float>(min_area), static_cast<float>(max_area));
+	float room_area = std::clamp(gen_positive(zgp.avg_size, zgp.size_deviation, rand), static_cast<float>(min_area), static_cast<float>(max_area));
 
 	float avg_room_dim = static_cast<float>(zgp.max_height + zgp.min_height) / 2.f;
 	dungeep::point_ui room_dim{};
-	room_dim.x = std::clamp(static_cast<unsigned int>(gen_positive(avg_room_dim, 0.4f * avg_room_dim)), zgp.min_height, zgp.max_height);
+	room_dim.x = std::clamp(static_cast<unsigned int>(gen_positive(avg_room_dim, 0.4f * avg_room_dim, rand)), zgp.min_height, zgp.max_height);
 	room_dim.y = static_cast<unsigned int>(room_area / static_cast<float>(room_dim.x));
 
 	return room_dim;
@@ -634,3 +719,46 @@ map::path_to_pt(const dungeep::point_i& source, const dungeep::point_i& destinat
 	}
 	return poss;
 }
+
+float map::cast_ray(const dungeep::point_f& from, const dungeep::point_f& to) const noexcept {
+	auto blocks_sight = [this](int x, int y) {
+		if (x < 0 || y < 0 || static_cast<unsigned>(x) >= size().width || static_cast<unsigned>(y) >= size().height) {
+			return true;
+		}
+		tiles tile = m_tiles[static_cast<unsigned>(x)][static_cast<unsigned>(y)];
+		return tile == tiles::wall || tile == tiles::empty_space;
+	};
+
+	// Amanatides & Woo's grid traversal: hopping from a tile border to the next one
+	const dungeep::point_f delta = to - from;
+	constexpr float inf = std::numeric_limits<float>::infinity();
+
+	auto x = static_cast<int>(std::floor(from.x));
+	auto y = static_cast<int>(std::floor(from.y));
+	const int step_x = delta.x < 0.f ? -1 : 1;
+	const int step_y = delta.y < 0.f ? -1 : 1;
+
+	const float t_delta_x = std::abs(delta.x) > 0.f ? 1.f / std::abs(delta.x) : inf;
+	const float t_delta_y = std::abs(delta.y) > 0.f ? 1.f / std::abs(delta.y) : inf;
+	float t_next_x = delta.x > 0.f ? (static_cast<float>(x + 1) - from.x) * t_delta_x
+	               : delta.x < 0.f ? (from.x - static_cast<float>(x)) * t_delta_x : inf;
+	float t_next_y = delta.y > 0.f ? (static_cast<float>(y + 1) - from.y) * t_delta_y
+	               : delta.y < 0.f ? (from.y - static_cast<float>(y)) * t_delta_y : inf;
+
+	float t = 0.f;
+	while (t <= 1.f) {
+		if (blocks_sight(x, y)) {
+			return t;
+		}
+		if (t_next_x < t_next_y) {
+			t = t_next_x;
+			t_next_x += t_delta_x;
+			x += step_x;
+		} else {
+			t = t_next_y;
+			t_next_y += t_delta_y;
+			y += step_y;
+		}
+	}
+	return 1.f;
+}
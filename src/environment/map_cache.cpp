@@ -0,0 +1,123 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///                                                                                                                                     ///
+///  Copyright C 2019, Lucas Lazare                                                                                                     ///
+///  Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation         ///
+///  		files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy,  ///
+///  modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software     ///
+///  		is furnished to do so, subject to the following conditions:                                                                 ///
+///                                                                                                                                     ///
+///  The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.     ///
+///                                                                                                                                     ///
+///  The Software is provided “as is”, without warranty of any kind, express or implied, including but not limited to the               ///
+///  warranties of merchantability, fitness for a particular purpose and noninfringement. In no event shall the authors or              ///
+///  copyright holders be liable for any claim, damages or other liability, whether in an action of contract, tort or otherwise,        ///
+///  arising from, out of or in connection with the software or the use or other dealings in the Software.                              ///
+///                                                                                                                                     ///
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <spdlog/spdlog.h>
+
+#include "utils/hash.hpp"
+#include "utils/random.hpp"
+#include "environment/map_cache.hpp"
+#include "environment/map_snapshot.hpp"
+
+namespace {
+	void hash_zone(dungeep::fnv1a& hash, const zone_gen_properties& zgp) noexcept {
+		hash.add(zgp.avg_size).add(zgp.size_deviation).add(zgp.borders_fuzzinness).add(zgp.borders_fuzzy_deviation)
+		    .add(zgp.borders_fuzzy_distance).add(zgp.min_height).add(zgp.max_height);
+	}
+}
+
+std::uint64_t map_cache::key(std::uint64_t seed, map::size_type size, const std::vector<room_gen_properties>& rooms_properties,
+                             const hallway_gen_properties& hgp) noexcept {
+	dungeep::fnv1a hash;
+	hash.add(generator_version).add(std::is_same_v<dungeep::default_engine, dungeep::xoshiro256ss>);
+	hash.add(seed).add(size.width).add(size.height);
+
+	hash.add(rooms_properties.size());
+	for (const room_gen_properties& rp : rooms_properties) {
+		hash_zone(hash, rp.rooms_properties);
+		hash_zone(hash, rp.holes_properties);
+		hash.add(rp.avg_rooms_n).add(rp.rooms_n_dev).add(rp.avg_holes_n).add(rp.holes_n_dev);
+	}
+
+	hash.add(hgp.curliness).add(hgp.curly_min_distance).add(hgp.curly_segment_avg_size).add(hgp.curly_segment_size_dev)
+	    .add(hgp.avg_width).add(hgp.width_dev).add(hgp.min_width).add(hgp.max_width);
+	return hash.value();
+}
+
+std::optional<std::vector<map::map_area>> map_cache::load(std::uint64_t key, map& target) const {
+	const std::filesystem::path path = file_of(key);
+	std::error_code err;
+	if (!std::filesystem::exists(path, err)) {
+		return {};
+	}
+
+	const map_snapshot snapshot{path};
+	if (!snapshot.is_valid() || !snapshot.checksum_matches() || snapshot.tag() != key) {
+		spdlog::warn("[Map cache] - Ignoring corrupted file {}.", path.string());
+		return {};
+	}
+
+	snapshot.load_into(target);
+	std::vector<map::map_area> rooms = snapshot.rooms();
+	target.expected_room_count = target.actual_room_count = static_cast<unsigned int>(rooms.size());
+	target.expected_hole_count = target.actual_hole_count = 0;
+	return rooms;
+}
+
+void map_cache::store(std::uint64_t key, const map& generated, const std::vector<map::map_area>& rooms) const {
+	const std::string data = map_snapshot::serialize(generated, rooms, map_snapshot::tile_encoding::run_length, key);
+
+	std::error_code err;
+	std::filesystem::create_directories(m_directory, err);
+	const std::filesystem::path path = file_of(key);
+	std::filesystem::path tmp_path = path;
+	tmp_path += "." + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + ".tmp";
+	{
+		std::ofstream file(tmp_path, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+		file.write(data.data(), static_cast<std::streamsize>(data.size()));
+		if (!file) {
+			spdlog::warn("[Map cache] - Failed to write {}.", tmp_path.string());
+			std::filesystem::remove(tmp_path, err);
+			return;
+		}
+	}
+	std::filesystem::rename(tmp_path, path, err);
+	if (err) {
+		spdlog::warn("[Map cache] - Failed to write {}: {}.", path.string(), err.message());
+		std::filesystem::remove(tmp_path, err);
+	}
+}
+
+std::vector<map::map_area> map_cache::generate(map& target, map::size_type size, const std::vector<room_gen_properties>& rooms_properties,
+                                               const hallway_gen_properties& hgp, std::uint64_t seed, dungeep::thread_pool* pool) const {
+	const std::uint64_t map_key = key(seed, size, rooms_properties, hgp);
+
+	const auto starting_tp = std::chrono::system_clock::now();
+	if (std::optional<std::vector<map::map_area>> rooms = load(map_key, target)) {
+		target.rooms_generation_time = target.halls_generation_time = target.fuzzy_generation_time = std::chrono::milliseconds{0};
+		target.total_generation_time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now() - starting_tp);
+		spdlog::debug("[Map cache] - Loaded map {:016x}.", map_key);
+		return *std::move(rooms);
+	}
+
+	std::vector<map::map_area> rooms = target.generate(size, rooms_properties, hgp, seed, pool);
+	store(map_key, target, rooms);
+	return rooms;
+}
+
+std::filesystem::path map_cache::file_of(std::uint64_t key) const {
+	char name[17];
+	constexpr char digits[] = "0123456789abcdef";
+	for (auto i = 0 ; i < 16 ; ++i) {
+		name[15 - i] = digits[(key >> (4u * static_cast<unsigned>(i))) & 0xFu];
+	}
+	name[16] = '\0';
+	return m_directory / (std::string{name} + ".dgm");
+}
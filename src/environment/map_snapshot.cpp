@@ -0,0 +1,222 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///                                                                                                                                     ///
+///  Copyright C 2019, Lucas Lazare                                                                                                     ///
+///  Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation         ///
+///  		files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy,  ///
+///  modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software     ///
+///  		is furnished to do so, subject to the following conditions:                                                                 ///
+///                                                                                                                                     ///
+///  The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.     ///
+///                                                                                                                                     ///
+///  The Software is provided “as is”, without warranty of any kind, express or implied, including but not limited to the               ///
+///  warranties of merchantability, fitness for a particular purpose and noninfringement. In no event shall the authors or              ///
+///  copyright holders be liable for any claim, damages or other liability, whether in an action of contract, tort or otherwise,        ///
+///  arising from, out of or in connection with the software or the use or other dealings in the Software.                              ///
+///                                                                                                                                     ///
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+#include "utils/hash.hpp"
+#include "environment/map_snapshot.hpp"
+
+namespace {
+	constexpr char magic[4] = {'D', 'G', 'M', 'S'};
+
+	template <typename UInt>
+	void write_uint(std::string& out, UInt value) {
+		for (auto i = 0u ; i < sizeof(UInt) ; ++i) {
+			out.push_back(static_cast<char>(value & 0xFFu));
+			value = static_cast<UInt>(value >> 8u);
+		}
+	}
+
+	template <typename UInt>
+	void write_uint_at(std::string& out, std::size_t pos, UInt value) {
+		for (auto i = 0u ; i < sizeof(UInt) ; ++i) {
+			out[pos + i] = static_cast<char>(value & 0xFFu);
+			value = static_cast<UInt>(value >> 8u);
+		}
+	}
+
+	template <typename UInt>
+	UInt read_uint(const unsigned char* data) noexcept {
+		UInt value = 0;
+		for (auto i = 0u ; i < sizeof(UInt) ; ++i) {
+			value = static_cast<UInt>(value | static_cast<UInt>(static_cast<UInt>(data[i]) << (8u * i)));
+		}
+		return value;
+	}
+
+	constexpr std::size_t room_size = 4 * sizeof(std::uint32_t);
+	constexpr std::size_t run_size = sizeof(std::uint32_t) + sizeof(std::uint8_t);
+}
+
+std::string map_snapshot::serialize(const map& source, const std::vector<map::map_area>& rooms, tile_encoding encoding, std::uint64_t tag) {
+	const map::size_type size = source.size();
+
+	std::string data{std::begin(magic), std::end(magic)};
+	write_uint(data, format_version);
+	write_uint(data, static_cast<std::uint16_t>(header_size));
+	write_uint(data, std::uint32_t{size.width});
+	write_uint(data, std::uint32_t{size.height});
+	write_uint(data, static_cast<std::uint32_t>(rooms.size()));
+	write_uint(data, static_cast<std::uint8_t>(encoding));
+	data.append(3, '\0');
+	write_uint(data, tag);
+	const std::size_t checksum_pos = data.size();
+	write_uint(data, std::uint64_t{0});
+	assert(data.size() == header_size);
+
+	for (const map::map_area& room : rooms) {
+		write_uint(data, std::uint32_t{room.x});
+		write_uint(data, std::uint32_t{room.y});
+		write_uint(data, std::uint32_t{room.width});
+		write_uint(data, std::uint32_t{room.height});
+	}
+
+	if (encoding == tile_encoding::raw) {
+		data.reserve(data.size() + std::size_t{size.width} * size.height);
+		for (auto x = 0u ; x < size.width ; ++x) {
+			for (tiles tile : source[x]) {
+				data.push_back(static_cast<char>(tile));
+			}
+		}
+	} else {
+		std::uint32_t run = 0;
+		tiles current = source[0][0];
+		for (auto x = 0u ; x < size.width ; ++x) {
+			for (tiles tile : source[x]) {
+				if (tile != current) {
+					write_uint(data, run);
+					write_uint(data, static_cast<std::uint8_t>(current));
+					current = tile;
+					run = 0;
+				}
+				++run;
+			}
+		}
+		write_uint(data, run);
+		write_uint(data, static_cast<std::uint8_t>(current));
+	}
+
+	write_uint_at(data, checksum_pos, dungeep::fnv1a{}.add(std::string_view{data}.substr(header_size)).value());
+	return data;
+}
+
+map_snapshot::map_snapshot(const unsigned char* data, std::size_t size) noexcept
+	: m_data{data}
+	, m_data_size{size}
+{
+	m_valid = parse();
+}
+
+map_snapshot::map_snapshot(const std::filesystem::path& path) noexcept
+	: m_file{path}
+	, m_data{m_file.data()}
+	, m_data_size{m_file.size()}
+{
+	m_valid = m_file.is_open() && parse();
+}
+
+bool map_snapshot::parse() noexcept {
+	if (m_data_size < header_size || !std::equal(std::begin(magic), std::end(magic), m_data, [](char lhs, unsigned char rhs) {
+		return static_cast<unsigned char>(lhs) == rhs;
+	})) {
+		return false;
+	}
+
+	m_version = read_uint<std::uint16_t>(m_data + 4);
+	if (m_version == 0 || m_version > format_version || read_uint<std::uint16_t>(m_data + 6) != header_size) {
+		return false;
+	}
+	m_size.width = read_uint<std::uint32_t>(m_data + 8);
+	m_size.height = read_uint<std::uint32_t>(m_data + 12);
+	m_room_count = read_uint<std::uint32_t>(m_data + 16);
+	const std::uint8_t encoding = m_data[20];
+	m_tag = read_uint<std::uint64_t>(m_data + 24);
+	m_checksum = read_uint<std::uint64_t>(m_data + 32);
+
+	if (m_size.width == 0 || m_size.height == 0 || encoding > static_cast<std::uint8_t>(tile_encoding::run_length)) {
+		return false;
+	}
+	m_encoding = static_cast<tile_encoding>(encoding);
+
+	const std::size_t remaining = m_data_size - header_size;
+	if (m_room_count > remaining / room_size) {
+		return false;
+	}
+	m_tiles = m_data + header_size + m_room_count * room_size;
+	const std::size_t tiles_bytes = remaining - m_room_count * room_size;
+	const std::uint64_t tile_count = std::uint64_t{m_size.width} * m_size.height;
+
+	constexpr auto last_tile = static_cast<std::uint8_t>(tiles::none);
+	if (m_encoding == tile_encoding::raw) {
+		// so that tile() never returns an unknown tile
+		return tiles_bytes == tile_count && std::all_of(m_tiles, m_tiles + tiles_bytes, [](unsigned char tile) {
+			return tile <= last_tile;
+		});
+	}
+
+	// runs must cover the map exactly
+	if (tiles_bytes % run_size != 0) {
+		return false;
+	}
+	std::uint64_t covered = 0;
+	for (const unsigned char* run = m_tiles ; run != m_tiles + tiles_bytes ; run += run_size) {
+		const auto length = read_uint<std::uint32_t>(run);
+		if (length == 0 || length > tile_count - covered || run[sizeof(std::uint32_t)] > last_tile) {
+			return false;
+		}
+		covered += length;
+	}
+	return covered == tile_count;
+}
+
+bool map_snapshot::checksum_matches() const noexcept {
+	assert(m_valid);
+	std::string_view payload{reinterpret_cast<const char*>(m_data + header_size), m_data_size - header_size};
+	return dungeep::fnv1a{}.add(payload).value() == m_checksum;
+}
+
+std::vector<map::map_area> map_snapshot::rooms() const {
+	assert(m_valid);
+	std::vector<map::map_area> ans;
+	ans.reserve(m_room_count);
+	for (const unsigned char* room = m_data + header_size ; room != m_tiles ; room += room_size) {
+		ans.push_back({
+				read_uint<std::uint32_t>(room),
+				read_uint<std::uint32_t>(room + 4),
+				read_uint<std::uint32_t>(room + 8),
+				read_uint<std::uint32_t>(room + 12)
+		});
+	}
+	return ans;
+}
+
+void map_snapshot::load_into(map& target) const {
+	assert(m_valid);
+	std::vector<std::vector<tiles>> grid(m_size.width, std::vector<tiles>(m_size.height));
+
+	if (m_encoding == tile_encoding::raw) {
+		const unsigned char* column_tiles = m_tiles;
+		for (std::vector<tiles>& column : grid) {
+			std::transform(column_tiles, column_tiles + m_size.height, column.begin(), [](unsigned char tile) {
+				return static_cast<tiles>(tile);
+			});
+			column_tiles += m_size.height;
+		}
+	} else {
+		std::uint64_t filled = 0;
+		for (const unsigned char* run = m_tiles ; filled < std::uint64_t{m_size.width} * m_size.height ; run += run_size) {
+			const auto tile = static_cast<tiles>(run[sizeof(std::uint32_t)]);
+			for (auto length = read_uint<std::uint32_t>(run) ; length != 0 ; --length, ++filled) {
+				grid[filled / m_size.height][filled % m_size.height] = tile;
+			}
+		}
+	}
+
+	target.m_tiles = std::move(grid);
+}
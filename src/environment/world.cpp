@@ -15,58 +15,119 @@
 ///                                                                                                                                     ///
 ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+#include <array>
+#include <deque>
+#include <future>
+#include <iterator>
+
 #include "utils/random.hpp"
 #include "environment/world_objects/chest.hpp"
 #include "utils/constants.hpp"
 #include "utils/resource_manager.hpp"
 #include "environment/world_objects/mob.hpp"
+#include "environment/world_objects/player.hpp"
 #include "environment/world.hpp"
+#include "environment/world_proxy.hpp"
 
 namespace {
-	unsigned short chest_count_rand(dungeep::uniform_int_distribution<unsigned short>& dist, resources::chest_count cc, std::mt19937_64& rand) {
+	unsigned short chest_count_rand(dungeep::uniform_int_distribution<unsigned short>& dist, resources::chest_count cc, dungeep::default_engine& rand) {
 		dist.param(dungeep::uniform_int_distribution<unsigned short>::param_type{cc.min, cc.max});
 		return dist(rand);
 	}
 }
 
+world::~world() {
+	cancel_level_generation();
+}
+
 void world::generate_next_level() {
+	std::unique_ptr<level> next;
+	try {
+		if (next_level) {
+			const std::unique_ptr<level_generation> generation = std::move(next_level);
+			next = generation->result.get(); // rethrows what build_level threw
+		}
+		if (!next) {
+			const std::atomic<bool> never_cancelled{false};
+			next = build_level(current_level, shared_random(), level_cache, &tick_pool, never_cancelled);
+		}
+	} catch (const level_generation_error& error) {
+		spdlog::error("{} Aborting.", error.what());
+		std::exit(0);
+	}
+
+	// Setting Quadtrees working area
+	auto size = next->terrain.size();
+	dungeep::area_f map_area{{0.f, 0.f}, {static_cast<float>(size.width), static_cast<float>(size.height)}};
+
+	players.clear();
+	drowsy_creatures.clear();
+	dynamic_objects = decltype(dynamic_objects)(map_area);
+	static_objects = decltype(static_objects)(map_area);
+	sleeping_objects = decltype(sleeping_objects)(map_area);
+	shared_map = std::move(next->terrain);
+	spawn_objects(*next);
+
+	start_level_generation();
+}
+
+void world::start_level_generation() {
+	cancel_level_generation();
+
+	next_level = std::make_unique<level_generation>();
+	next_level->result = std::async(std::launch::async, [this, level_number = current_level, seed = shared_random(), &cancelled = next_level->cancelled] {
+		return build_level(level_number, seed, level_cache, nullptr, cancelled);
+	});
+}
+
+void world::cancel_level_generation() noexcept {
+	if (next_level) {
+		next_level->cancelled.store(true, std::memory_order_relaxed);
+		next_level.reset(); // waits for the generation to notice
+	}
+}
+
+std::unique_ptr<world::level> world::build_level(unsigned int level_number, std::uint64_t seed, const map_cache& cache, dungeep::thread_pool* pool,
+                                                 const std::atomic<bool>& cancelled) {
+	dungeep::default_engine rand{seed};
+	auto lvl = std::make_unique<level>();
+	lvl->number = level_number;
 
 	// retrieving map settings
 	const std::unordered_map<std::string, resources::map_info>& map_list = resources::manager->get_map_list();
-	const auto& selected_map = *std::next(map_list.begin(), static_cast<unsigned>(shared_random() % map_list.size()));
+	const auto& selected_map = *std::next(map_list.begin(), static_cast<unsigned>(dungeep::bounded_rand(rand, map_list.size())));
 
 	const auto& map_properties = resources::manager->get_map(selected_map.first);
-	std::vector<map::map_area> room_list = shared_map.generate(
-			  map_properties.size
+	std::vector<map::map_area> room_list = cache.generate(
+			  lvl->terrain
+			, map_properties.size
 			, map_properties.rooms_props
 			, map_properties.hallways_props
+			, rand()
+			, pool
     );
 
-	std::vector<std::pair<std::string_view, resources::mob_map_rinfo>> mobs = resources::manager->get_creatures_for_level(current_level, selected_map.first);
+	std::vector<std::pair<std::string_view, resources::mob_map_rinfo>> mobs = resources::manager->get_creatures_for_level(level_number, selected_map.first);
 
 	if (mobs.empty()) {
-		spdlog::error("No creature available for level {} on map {}. Aborting.", current_level, selected_map.first);
-		std::exit(0);
+		throw level_generation_error("No creature available for level " + std::to_string(level_number) + " on map " + selected_map.first + ".");
 	}
 
-	// Setting Quadtrees working area
-	auto size = shared_map.size();
-	dungeep::area_f map_area{{0.f, 0.f}, {static_cast<float>(size.width), static_cast<float>(size.height)}};
-
-	dynamic_objects = decltype(dynamic_objects)(map_area);
-	static_objects = decltype(static_objects)(map_area);
-
+	if (cancelled.load(std::memory_order_relaxed)) {
+		return nullptr;
+	}
 
 	// TODO: objets statiques (boutons, …) (avant les mobs)
 	dungeep::uniform_int_distribution<unsigned short> c_dist;
-	put_n_chest(chest_level::rubbish, chest_count_rand(c_dist, map_properties.rubbish_chest, shared_random), room_list);
-	put_n_chest(chest_level::wooden, chest_count_rand(c_dist, map_properties.wooden_chest, shared_random), room_list);
-	put_n_chest(chest_level::magic, chest_count_rand(c_dist, map_properties.magic_chest, shared_random), room_list);
-	put_n_chest(chest_level::iron, chest_count_rand(c_dist, map_properties.iron_chest, shared_random), room_list);
+	put_n_chest(*lvl, chest_level::rubbish, chest_count_rand(c_dist, map_properties.rubbish_chest, rand), room_list, rand);
+	put_n_chest(*lvl, chest_level::wooden, chest_count_rand(c_dist, map_properties.wooden_chest, rand), room_list, rand);
+	put_n_chest(*lvl, chest_level::magic, chest_count_rand(c_dist, map_properties.magic_chest, rand), room_list, rand);
+	put_n_chest(*lvl, chest_level::iron, chest_count_rand(c_dist, map_properties.iron_chest, rand), room_list, rand);
 
 
 
-	unsigned int density = mobs_per_100_tiles();
+	unsigned int density = mobs_per_100_tiles(level_number);
 
 	// Probability : sum of pop factors (preparing mob generation)
 	const unsigned int total_pop_factor = std::accumulate(mobs.begin(), mobs.end(), 0u,
@@ -79,10 +140,14 @@ void world::generate_next_level() {
 	// Placing mobs
 	dungeep::area_f mob_pos;
 	for (const map::map_area& room : room_list) {
+		if (cancelled.load(std::memory_order_relaxed)) {
+			return nullptr;
+		}
+
 		for (unsigned int mob_count = density * room.height * room.width / 100 ; mob_count != 0 ; --mob_count) {
 
 			// selecting a random mob
-			const unsigned int selected_mob_pop = mob_distribution(shared_random);
+			const unsigned int selected_mob_pop = mob_distribution(rand);
 			unsigned int selected_mob_idx = 0;
 			for (unsigned int sum = mobs[0].second.populate_factor ; selected_mob_idx < mobs.size() && sum < selected_mob_pop ; ++selected_mob_idx) {
 				sum += mobs[selected_mob_idx].second.populate_factor;
@@ -90,16 +155,201 @@ void world::generate_next_level() {
 
 			// trying to place it
 			const resources::creature_info& cinfo = resources::manager->read_creature(mobs[selected_mob_idx].first);
-			if (try_gen_pos(room, mob_pos, cinfo.size)) {
-				dynamic_objects.emplace(mob_pos, std::make_unique<mob>(cinfo, current_level));
+			if (try_gen_pos(*lvl, room, mob_pos, cinfo.size, rand)) {
+				lvl->mobs.push_back({mob_pos, mobs[selected_mob_idx].first});
 			}
 		}
 	}
 
 	// TODO: sortie et entrée du niveau
+	return lvl;
+}
+
+void world::spawn_objects(const level& lvl) {
+	for (const chest_spawn& spawn : lvl.chests) {
+		static_objects.emplace(spawn.hitbox, std::make_unique<chest>(spawn.quality));
+	}
+	for (const mob_spawn& spawn : lvl.mobs) {
+		dynamic_objects.emplace(spawn.hitbox, std::make_unique<mob>(resources::manager->read_creature(spawn.name), lvl.number));
+	}
 }
 
-bool world::try_gen_pos(const map::map_area& room, dungeep::area_f& /* out */ generated_area, dungeep::dim_uc dim) {
+void world::next_tick() {
+	creature_components::instance().regenerate();
+
+	const float strip_width = std::max(static_cast<float>(shared_map.size().width), 1.f) / tick_strip_count;
+
+	std::array<std::vector<dynamic_object*>, tick_strip_count> strips;
+	for (auto& object : dynamic_objects) {
+		const float x = object->hitbox().center().x;
+		const auto strip = static_cast<unsigned int>(std::clamp(x / strip_width, 0.f, static_cast<float>(tick_strip_count - 1)));
+		strips[strip].push_back(object.get().get());
+	}
+
+	// seeds are drawn in strip order, before any object ticks
+	std::deque<world_proxy> proxies;
+	for (auto i = 0u ; i < tick_strip_count ; ++i) {
+		proxies.emplace_back(*this, shared_random());
+	}
+
+	auto tick_strip = [&strips, &proxies](unsigned int strip) {
+		for (dynamic_object* object : strips[strip]) {
+			object->tick(proxies[strip]);
+		}
+	};
+
+	dungeep::run_strips_by_parity(tick_pool, tick_strip_count, dynamic_objects.size() >= parallel_tick_threshold, tick_strip);
+
+	// objects are only added, damaged and removed once every object ticked, so that the iteration above stays valid
+	world_proxy requests{*this};
+	for (world_proxy& proxy : proxies) {
+		std::move(proxy.new_objects.begin(), proxy.new_objects.end(), std::back_inserter(requests.new_objects));
+		requests.deleted_objects.insert(requests.deleted_objects.end(), proxy.deleted_objects.begin(), proxy.deleted_objects.end());
+		requests.damages.append(proxy.damages);
+	}
+
+	for (creature* dead : requests.damages.resolve()) {
+		if (!is_player(dead)) {
+			requests.deleted_objects.push_back(dead->ref());
+		} else {
+			spdlog::info("A player died.");
+		}
+	}
+	apply_requests(requests);
+	update_sleep();
+	++tick_number;
+
+	dynamic_objects.adapt(dungeep::quadtree_tuning{});
+}
+
+void world::apply_requests(world_proxy& proxy) {
+	// erased in request order, so that the indexes end up the same from a run to another
+	for (const dungeep::pool_ref<world_object>& deleted : proxy.deleted_objects) {
+		const world_object* object = deleted.get();
+		if (!object) {
+			continue; // requested more than once, and already erased
+		}
+
+		auto is_deleted = [object](auto it) { return it->value.get() == object; };
+		const dungeep::area_f hitbox = object->hitbox();
+		dynamic_objects.visit(hitbox, is_deleted);
+		sleeping_objects.visit(hitbox, is_deleted);
+		static_objects.visit(hitbox, is_deleted);
+	}
+	if (!proxy.deleted_objects.empty()) {
+		players.erase(std::remove_if(players.begin(), players.end(), [](const auto& p) { return !p.get(); }), players.end());
+		drowsy_creatures.erase(std::remove_if(drowsy_creatures.begin(), drowsy_creatures.end(), [](const auto& drowsy) {
+			return !drowsy.first.get();
+		}), drowsy_creatures.end());
+	}
+
+	// spawned objects are built here, on the calling thread and in request order
+	for (auto& request : proxy.new_objects) {
+		std::unique_ptr<world_object> created = std::holds_alternative<world_proxy::object_factory>(request)
+		                                        ? std::get<world_proxy::object_factory>(request)()
+		                                        : std::move(std::get<std::unique_ptr<world_object>>(request));
+		const dungeep::area_f hitbox = created->hitbox();
+		if (auto* dynamic = dynamic_cast<dynamic_object*>(created.get())) {
+			created.release();
+			dynamic_objects.emplace(hitbox, std::unique_ptr<dynamic_object>(dynamic));
+		} else {
+			static_objects.emplace(hitbox, std::move(created));
+		}
+	}
+}
+
+void world::add_player(std::unique_ptr<player>&& new_player) {
+	players.push_back(dungeep::pool_ref<player>::to(*new_player));
+	const dungeep::area_f hitbox = new_player->hitbox();
+	dynamic_objects.emplace(hitbox, std::move(new_player));
+}
+
+void world::update_sleep() {
+	const dungeep::point_f reach{sleep_radius, sleep_radius};
+
+	std::vector<dynamic_object*> woken;
+	for (const dungeep::pool_ref<player>& p : players) {
+		const dungeep::point_f center = p.get()->hitbox().center();
+		sleeping_objects.visit(dungeep::area_f{center - reach, center + reach}, [&woken](dynamic_index::const_iterator it) {
+			woken.push_back(it->value.get());
+		});
+	}
+	for (dynamic_object* object : woken) {
+		// an object close to several players is visited once per player
+		transfer(sleeping_objects, dynamic_objects, object);
+	}
+
+	auto drowsy_it = drowsy_creatures.begin();
+	while (drowsy_it != drowsy_creatures.end()) {
+		if (is_near_player(drowsy_it->first.get()->hitbox())) {
+			drowsy_it = drowsy_creatures.erase(drowsy_it);
+		} else if (drowsy_it->second-- <= 0) {
+			transfer(dynamic_objects, sleeping_objects, drowsy_it->first.get());
+			drowsy_it = drowsy_creatures.erase(drowsy_it);
+		} else {
+			++drowsy_it;
+		}
+	}
+
+	if (ticks_before_sleep_check-- != 0) {
+		return;
+	}
+	ticks_before_sleep_check = sleep_check_interval;
+
+	std::vector<creature*> falling_asleep;
+	for (const auto& object : dynamic_objects) {
+		if (is_near_player(object.hitbox())) {
+			continue;
+		}
+		auto* c = dynamic_cast<creature*>(object.value.get());
+		const bool is_drowsy = std::any_of(drowsy_creatures.begin(), drowsy_creatures.end(), [c](const auto& drowsy) { return drowsy.first.get() == c; });
+		if (c && !is_drowsy && !is_player(c)) {
+			falling_asleep.push_back(c);
+		}
+	}
+	for (creature* c : falling_asleep) {
+		const int forced_ticks = c->sleep();
+		if (forced_ticks > 0) {
+			drowsy_creatures.emplace_back(c->ref(), forced_ticks);
+		} else {
+			transfer(dynamic_objects, sleeping_objects, c);
+		}
+	}
+}
+
+bool world::is_near_player(const dungeep::area_f& hitbox) const noexcept {
+	const dungeep::point_f reach{sleep_radius, sleep_radius};
+	return std::any_of(players.begin(), players.end(), [&hitbox, &reach](const dungeep::pool_ref<player>& p) {
+		const dungeep::point_f center = p.get()->hitbox().center();
+		return hitbox.collides_with(dungeep::area_f{center - reach, center + reach});
+	});
+}
+
+bool world::is_player(const world_object* object) const noexcept {
+	return std::any_of(players.begin(), players.end(), [object](const dungeep::pool_ref<player>& p) {
+		return p.get() == object;
+	});
+}
+
+bool world::transfer(dynamic_index& from, dynamic_index& to, const world_object* object) {
+	std::unique_ptr<dynamic_object> moved;
+	const dungeep::area_f hitbox = object->hitbox();
+	from.visit(hitbox, [&moved, object](dynamic_index::iterator it) {
+		if (it->value.get() != object) {
+			return false;
+		}
+		moved = std::move(it->value);
+		return true;
+	});
+	if (!moved) {
+		return false;
+	}
+	to.emplace(hitbox, std::move(moved));
+	return true;
+}
+
+bool world::try_gen_pos(const level& lvl, const map::map_area& room, dungeep::area_f& /* out */ generated_area, dungeep::dim_uc dim,
+                        dungeep::default_engine& rand) {
 	assert(room.x >= 0 && room.y >= 0);
 	if (room.width <= dim.x || room.height <= dim.y) {
 		return false;
@@ -108,21 +358,23 @@ bool world::try_gen_pos(const map::map_area& room, dungeep::area_f& /* out */ ge
 	unsigned int i = 5;
 	bool valid_pos;
 	do {
-		generated_area.top_left.x = static_cast<float>(shared_random() % (room.width - dim.x) + room.x);
-		generated_area.top_left.y = static_cast<float>(shared_random() % (room.height - dim.y) + room.y);
+		generated_area.top_left.x = static_cast<float>(dungeep::bounded_rand(rand, room.width - dim.x) + room.x);
+		generated_area.top_left.y = static_cast<float>(dungeep::bounded_rand(rand, room.height - dim.y) + room.y);
 		generated_area.bot_right.x = generated_area.top_left.x + static_cast<float>(dim.x);
 		generated_area.bot_right.y = generated_area.top_left.y + static_cast<float>(dim.y);
 		valid_pos = true;
 		for (auto j = static_cast<unsigned>(generated_area.top_left.x) ; j < generated_area.bot_right.x && valid_pos ; ++j) {
 			for (auto k = static_cast<unsigned>(generated_area.top_left.y) ; k < generated_area.bot_right.y ; ++k) {
-				if (shared_map[j][k] != tiles::walkable) {
+				if (lvl.terrain[j][k] != tiles::walkable) {
 					valid_pos = false;
 					break;
 				}
 			}
 		}
 		if (valid_pos) {
-			valid_pos = !static_objects.has_collision(generated_area);
+			valid_pos = std::none_of(lvl.chests.begin(), lvl.chests.end(), [&generated_area](const chest_spawn& spawn) {
+				return spawn.hitbox.collides_with(generated_area);
+			});
 		}
 
 	} while (!valid_pos && i--);
@@ -131,15 +383,16 @@ bool world::try_gen_pos(const map::map_area& room, dungeep::area_f& /* out */ ge
 }
 
 
-void world::put_n_chest(chest_level lvl, unsigned short count, const std::vector<map::map_area>& room_list) {
+void world::put_n_chest(level& lvl, chest_level chest_lvl, unsigned short count, const std::vector<map::map_area>& room_list,
+                        dungeep::default_engine& rand) {
 	dungeep::area_f location;
 
 	while (count--) {
 		unsigned int i = 0;
 		do {
-			map::map_area target_room = room_list[shared_random() % room_list.size()];
-			if (try_gen_pos(target_room, location, constants::chests::size)) {
-				static_objects.emplace(location, std::make_unique<chest>(lvl));
+			map::map_area target_room = room_list[dungeep::bounded_rand(rand, room_list.size())];
+			if (try_gen_pos(lvl, target_room, location, constants::chests::size, rand)) {
+				lvl.chests.push_back({location, chest_lvl});
 				return;
 			}
 		} while (++i < 5);
@@ -27,59 +27,61 @@
 #include "iconned/dynamic.hpp"
 
 
-creature::creature(std::string_view name_) noexcept
+creature::creature(std::string_view name_)
 	: name{name_}
+	, entity{creature_components::instance().create()}
 	, sprites{resources::manager->get_creature_sprite(name)}
 {
 }
 
+creature::~creature() {
+	creature_components::instance().destroy(entity);
+}
+
 void creature::magical_hit(int damage, int resist_ignore) noexcept {
-//	std::vector<std::unique_ptr<fixed_effect>> fixed_buffs{};
-//	std::vector<std::unique_ptr<dynamic_effect>> dynamic_buffs{}; // TODO -> pas les fixed_buffs parcontre [ils sont déjà cachés dans 'resist' à priori
-	current_health -= compute_damage_reduction(damage, resist - resist_ignore);
+	damage = filter_input_damage(damage_type::magical, damage);
+	stat(stat_id::current_health) -= compute_damage_reduction(damage, stat(stat_id::resist) + buffs.bonuses().resist - resist_ignore);
 }
 
 void creature::physical_hit(int damage, int armor_ignore) noexcept {
-//	std::vector<std::unique_ptr<fixed_effect>> fixed_buffs{};
-//	std::vector<std::unique_ptr<dynamic_effect>> dynamic_buffs{}; // TODO -> pas les fixed_buffs parcontre [ils sont déjà cachés dans 'armor' à priori
-	current_health -= compute_damage_reduction(damage, armor - armor_ignore);
+	damage = filter_input_damage(damage_type::physical, damage);
+	stat(stat_id::current_health) -= compute_damage_reduction(damage, stat(stat_id::armor) + buffs.bonuses().armor - armor_ignore);
 }
 
 void creature::add_effect(std::unique_ptr<fixed_effect>&& effect) noexcept {
-	if (effect->is_dynamic()) {
-		auto dyn_effect = dynamic_cast<dynamic_effect*>(effect.release());
-		assert(dyn_effect);
-		dynamic_buffs.emplace_back(dyn_effect);
-	} else {
-		fixed_buffs.emplace_back(std::move(effect));
-	}
+	buffs.add(std::move(effect));
+	stat(stat_id::health_bonus) = buffs.bonuses().hp;
 }
 
 void creature::remove_effect(fixed_effect* effect) noexcept {
-
-	auto remove = [](auto& vect, typename std::remove_reference_t<decltype(vect)>::value_type::pointer value) {
-		auto it = std::find_if(vect.begin(), vect.end(), [value](const auto& u_ptr) {
-			return u_ptr.get() == value;
-		});
-		if (it != vect.end()) {
-			if (std::next(it) != vect.end()) {
-				*it = std::move(vect.back());
-			}
-			vect.pop_back();
-		}
-	};
-
-	if (effect->is_dynamic()) {
-		auto dyn_effect = dynamic_cast<dynamic_effect*>(effect);
-		assert(dyn_effect);
-		remove(dynamic_buffs, dyn_effect);
-	} else {
-		remove(fixed_buffs, effect);
+	if (buffs.remove(effect)) {
+		stat(stat_id::health_bonus) = buffs.bonuses().hp;
 	}
 }
 
 void creature::true_hit(int damage) noexcept {
-	current_health -= damage;
+	stat(stat_id::current_health) -= filter_input_damage(damage_type::true_damage, damage);
+}
+
+int creature::filter_input_damage(damage_type type, int damage) noexcept {
+	switch (type) {
+		case damage_type::physical:
+			for (dynamic_effect* buff : hooked_buffs(effect_hook::input_physical_damage)) {
+				damage = buff->update_input_physical_damage(damage);
+			}
+			break;
+		case damage_type::magical:
+			for (dynamic_effect* buff : hooked_buffs(effect_hook::input_magical_damage)) {
+				damage = buff->update_input_magical_damage(damage);
+			}
+			break;
+		case damage_type::true_damage:
+			for (dynamic_effect* buff : hooked_buffs(effect_hook::input_true_damage)) {
+				damage = buff->update_input_true_damage(damage);
+			}
+			break;
+	}
+	return damage;
 }
 
 void creature::print(sf::RenderWindow& rw) const noexcept {
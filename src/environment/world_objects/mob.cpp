@@ -27,18 +27,19 @@
 #include "iconned/fixed.hpp"
 #include "iconned/dynamic.hpp"
 
-mob::mob(const resources::creature_info& infos, unsigned int level) noexcept :
+mob::mob(const resources::creature_info& infos, unsigned int level) :
 		creature(infos.name)
 {
 	current_direction = dungeep::direction::none;
 
 	const resources::creature_info& me = resources::manager->read_creature(name);
-	max_health = std::max(static_cast<int>(me.base_hp + me.hp_per_level * level), 1);
-	attack_power = std::max(static_cast<int>(me.base_physical_power + me.physical_power_per_level * level), 1);
-	armor = std::max(static_cast<int>(me.base_armor + me.armor_per_level * level), 1);
-	resist = std::max(static_cast<int>(me.base_resist + me.resist_per_level * level), 1);
-	move_speed = std::max(static_cast<int>(me.base_move_speed + me.move_speed_per_level * level), 1);
-	crit_chance = std::max(static_cast<int>(me.base_crit_chance + me.crit_chance_per_level * level), 1);
+	stat(stat_id::max_health) = std::max(static_cast<int>(me.base_hp + me.hp_per_level * level), 1);
+	stat(stat_id::attack_power) = std::max(static_cast<int>(me.base_physical_power + me.physical_power_per_level * level), 1);
+	stat(stat_id::armor) = std::max(static_cast<int>(me.base_armor + me.armor_per_level * level), 1);
+	stat(stat_id::resist) = std::max(static_cast<int>(me.base_resist + me.resist_per_level * level), 1);
+	stat(stat_id::move_speed) = std::max(static_cast<int>(me.base_move_speed + me.move_speed_per_level * level), 1);
+	stat(stat_id::crit_chance) = std::max(static_cast<int>(me.base_crit_chance + me.crit_chance_per_level * level), 1);
+	stat(stat_id::health_regen) = static_cast<int>(me.base_hp_regen + me.hp_regen_per_level * level);
 }
 
 void mob::tick(world_proxy& /*world*/) noexcept {
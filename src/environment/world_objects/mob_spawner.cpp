@@ -22,7 +22,7 @@
 #include "environment/world_proxy.hpp"
 #include "utils/resource_keys.hpp"
 
-mob_spawner::mob_spawner(const resources::creature_info& infos_, int level_) noexcept
+mob_spawner::mob_spawner(const resources::creature_info& infos_, int level_)
 		: creature(infos_.name + values::creature::spawner_suffix)
 		, infos(infos_)
 		, level(level_)
@@ -37,7 +37,7 @@ void mob_spawner::tick(world_proxy& world) noexcept {
 	if (creature_count < max_creature_count) {
 		if (cooldown == 0u) {
 			cooldown = max_cooldown;
-			world.create_entity(std::make_unique<mob>(infos, level));
+			world.spawn<mob>(infos, static_cast<unsigned int>(level));
 			++creature_count;
 		} else {
 			cooldown--;
@@ -26,6 +26,7 @@
 #include <SFML/Graphics/Texture.hpp>
 
 #include <map>
+#include <chrono>
 #include <utils/random.hpp>
 #include <display/proba_tester.hpp>
 
@@ -103,7 +104,10 @@ int main()
 			}
 		}
 
-		ImGui::SFML::Update(window, deltaClock.restart());
+		const sf::Time frame_time = deltaClock.restart();
+		prgm.scheduler.advance(std::chrono::microseconds{frame_time.asMicroseconds()}, [&prgm] { prgm.world.next_tick(); });
+
+		ImGui::SFML::Update(window, frame_time);
 
 		showMainDockSpace(tester);
 		tester.showViewerWindow();
@@ -353,6 +353,12 @@ void resources::parse_creatures() noexcept {
 			try_assign(current_creature, keys::creature::crit_pl,       inf.crit_chance_per_level,    name);
 			try_assign(current_creature, keys::creature::move_speed,    inf.base_move_speed,          name);
 			try_assign(current_creature, keys::creature::move_speed_pl, inf.move_speed_per_level,     name);
+			if (current_creature.isMember(keys::creature::hp_regen)) {
+				try_assign(current_creature, keys::creature::hp_regen,    inf.base_hp_regen,            name);
+			}
+			if (current_creature.isMember(keys::creature::hp_regen_pl)) {
+				try_assign(current_creature, keys::creature::hp_regen_pl, inf.hp_regen_per_level,       name);
+			}
 
 			std::string type;
 			try_assign(current_creature, keys::creature::type, type, name);
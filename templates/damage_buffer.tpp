@@ -0,0 +1,72 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///                                                                                                                                     ///
+///  Copyright C 2019, Lucas Lazare                                                                                                     ///
+///  Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation         ///
+///  		files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy,  ///
+///  modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software     ///
+///  		is furnished to do so, subject to the following conditions:                                                                 ///
+///                                                                                                                                     ///
+///  The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.     ///
+///                                                                                                                                     ///
+///  The Software is provided “as is”, without warranty of any kind, express or implied, including but not limited to the               ///
+///  warranties of merchantability, fitness for a particular purpose and noninfringement. In no event shall the authors or              ///
+///  copyright holders be liable for any claim, damages or other liability, whether in an action of contract, tort or otherwise,        ///
+///  arising from, out of or in connection with the software or the use or other dealings in the Software.                              ///
+///                                                                                                                                     ///
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cstdlib>
+
+template <typename Target>
+void basic_damage_buffer<Target>::append(basic_damage_buffer& other) {
+	events.insert(events.end(), other.events.begin(), other.events.end());
+	other.events.clear();
+}
+
+template <typename Target>
+std::vector<Target*> basic_damage_buffer<Target>::resolve() {
+	// stable: events of a target keep their order, in which its buffs' hooks see them
+	std::stable_sort(events.begin(), events.end(), [](const event& lhs, const event& rhs) {
+		return lhs.target->entity_id() < rhs.target->entity_id();
+	});
+
+	const std::size_t count = events.size();
+	amounts.resize(count);
+	defenses.resize(count);
+	reduced.resize(count);
+	for (std::size_t i = 0 ; i < count ; ++i) {
+		const event& e = events[i];
+		amounts[i] = e.target->filter_input_damage(e.type, e.amount);
+		defenses[i] = e.type == damage_type::true_damage ? 0 : e.target->defense_against(e.type) - e.penetration;
+	}
+	reduce_all(amounts.data(), defenses.data(), reduced.data(), count);
+
+	std::vector<Target*> dead;
+	std::size_t i = 0;
+	while (i < count) {
+		Target* target = events[i].target;
+		int total = 0;
+		for (; i < count && events[i].target == target ; ++i) {
+			total += reduced[i];
+		}
+		target->lose_health(total);
+		if (target->get_hp() <= 0) {
+			dead.push_back(target);
+		}
+	}
+
+	events.clear();
+	return dead;
+}
+
+template <typename Target>
+void basic_damage_buffer<Target>::reduce_all(const int* damages, const int* defenses, int* out, std::size_t count) noexcept {
+	// the quotients are exact in double precision and truncated like the integer ones
+	for (std::size_t i = 0 ; i < count ; ++i) {
+		const int damage = damages[i];
+		const int defense = defenses[i];
+		const auto quotient = static_cast<int>(static_cast<double>(damage * 1000) / static_cast<double>(1000 + std::abs(defense)));
+		out[i] = defense >= 0 ? quotient : damage * 2 - quotient;
+	}
+}
@@ -0,0 +1,451 @@
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///                                                                                                                                     ///
+///  Copyright C 2019, Lucas Lazare                                                                                                     ///
+///  Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation         ///
+///  		files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy,  ///
+///  modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software     ///
+///  		is furnished to do so, subject to the following conditions:                                                                 ///
+///                                                                                                                                     ///
+///  The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.     ///
+///                                                                                                                                     ///
+///  The Software is provided “as is”, without warranty of any kind, express or implied, including but not limited to the               ///
+///  warranties of merchantability, fitness for a particular purpose and noninfringement. In no event shall the authors or              ///
+///  copyright holders be liable for any claim, damages or other liability, whether in an action of contract, tort or otherwise,        ///
+///  arising from, out of or in connection with the software or the use or other dealings in the Software.                              ///
+///                                                                                                                                     ///
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <cassert>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <algorithm>
+
+namespace dungeep {
+
+template <typename T, unsigned int D, template <typename...> typename C, typename Coord>
+template <typename Tree, typename Value, typename SubIterator>
+struct flat_quadtree<T,D,C,Coord>::iterator_type {
+
+	using difference_type = std::ptrdiff_t;
+	using value_type = Value;
+	using pointer = Value*;
+	using reference = Value&;
+	using iterator_category = std::bidirectional_iterator_tag;
+
+	iterator_type() noexcept : tree_{nullptr}, node_{0}, current_{} {}
+
+	explicit iterator_type(Tree& tree) noexcept : tree_{&tree}, node_{0}, current_{tree.nodes_.front().values.begin()} {
+		skip_empty_nodes();
+	}
+
+	iterator_type(Tree& tree, std::size_t node, SubIterator current) noexcept : tree_{&tree}, node_{node}, current_{current} {}
+
+	iterator_type operator++(int) noexcept {
+		iterator_type tmp(*this);
+		++*this;
+		return tmp;
+	}
+
+	iterator_type& operator++() noexcept {
+		assert(!is_at_end());
+		++current_;
+		skip_empty_nodes();
+		return *this;
+	}
+
+	iterator_type operator--(int) noexcept {
+		iterator_type tmp(*this);
+		--*this;
+		return tmp;
+	}
+
+	iterator_type& operator--() noexcept {
+		assert(tree_);
+		while (node_ == tree_->nodes_.size() || current_ == tree_->nodes_[node_].values.begin()) {
+			assert(node_ > 0);
+			--node_;
+			current_ = tree_->nodes_[node_].values.end();
+		}
+		--current_;
+		return *this;
+	}
+
+	// end == end, end == {}
+	bool operator==(const iterator_type& other) const noexcept {
+		if (is_at_end() || other.is_at_end()) {
+			return is_at_end() && other.is_at_end();
+		}
+		return tree_ == other.tree_ && node_ == other.node_ && current_ == other.current_;
+	}
+
+	bool operator!=(const iterator_type& other) const noexcept {
+		return !(*this == other);
+	}
+
+	Value& operator*() const noexcept {
+		assert(!is_at_end());
+		return *current_;
+	}
+
+	Value* operator->() const noexcept {
+		assert(!is_at_end());
+		return &*current_;
+	}
+
+	bool is_at_end() const noexcept {
+		return tree_ == nullptr || node_ == tree_->nodes_.size();
+	}
+
+private:
+	friend flat_quadtree<T,D,C,Coord>;
+
+	void skip_empty_nodes() noexcept {
+		while (current_ == tree_->nodes_[node_].values.end()) {
+			if (++node_ == tree_->nodes_.size()) {
+				return;
+			}
+			current_ = tree_->nodes_[node_].values.begin();
+		}
+	}
+
+	Tree* tree_;
+	std::size_t node_;
+	SubIterator current_;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename T, unsigned int Depth, template <typename...> typename Container, typename Coord>
+flat_quadtree<T, Depth, Container, Coord>::flat_quadtree(const area& ar)
+	: area_{ar}
+	, scale_{
+		ar.width() > 0 ? static_cast<float>(1u << Depth) / static_cast<float>(ar.width()) : 0.f,
+		ar.height() > 0 ? static_cast<float>(1u << Depth) / static_cast<float>(ar.height()) : 0.f
+	}
+	, nodes_(node_count)
+{}
+
+template <typename T, unsigned int Depth, template <typename...> typename Container, typename Coord>
+auto flat_quadtree<T, Depth, Container, Coord>::begin() noexcept -> iterator {
+	return iterator{*this};
+}
+
+template <typename T, unsigned int Depth, template <typename...> typename Container, typename Coord>
+auto flat_quadtree<T, Depth, Container, Coord>::begin() const noexcept -> const_iterator {
+	return const_iterator{*this};
+}
+
+template <typename T, unsigned int Depth, template <typename...> typename Container, typename Coord>
+auto flat_quadtree<T, Depth, Container, Coord>::cbegin() const noexcept -> const_iterator {
+	return const_iterator{*this};
+}
+
+template <typename T, unsigned int Depth, template <typename...> typename Container, typename Coord>
+auto flat_quadtree<T, Depth, Container, Coord>::end() noexcept -> iterator {
+	return iterator{};
+}
+
+template <typename T, unsigned int Depth, template <typename...> typename Container, typename Coord>
+auto flat_quadtree<T, Depth, Container, Coord>::end() const noexcept -> const_iterator {
+	return const_iterator{};
+}
+
+template <typename T, unsigned int Depth, template <typename...> typename Container, typename Coord>
+auto flat_quadtree<T, Depth, Container, Coord>::cend() const noexcept -> const_iterator {
+	return const_iterator{};
+}
+
+template <typename T, unsigned int Depth, template <typename...> typename Container, typename Coord>
+auto flat_quadtree<T, Depth, Container, Coord>::insert(const value_type& value) -> iterator {
+	return emplace(value.hitbox(), value);
+}
+
+template <typename T, unsigned int Depth, template <typename...> typename Container, typename Coord>
+template <typename... Args>
+auto flat_quadtree<T, Depth, Container, Coord>::emplace(const area& target, Args&&... args) -> iterator {
+	const size_type node_idx = node_of(target);
+	node& n = nodes_[node_idx];
+	n.values.emplace_back(std::forward<Args>(args)...);
+	n.hitboxes.push_back(target);
+	++size_;
+	return {*this, node_idx, std::prev(n.values.end())};
+}
+
+template <typename T, unsigned int Depth, template <typename...> typename Container, typename Coord>
+template <typename FuncT>
+std::enable_if_t<std::is_invocable_v<FuncT, typename flat_quadtree<T, Depth, Container, Coord>::iterator>>
+flat_quadtree<T, Depth, Container, Coord>::visit(const area& target, FuncT&& visitor) noexcept(std::is_nothrow_invocable_v<FuncT, iterator>) {
+	visit_impl<iterator>(*this, target, visitor);
+}
+
+template <typename T, unsigned int Depth, template <typename...> typename Container, typename Coord>
+template <typename FuncT>
+std::enable_if_t<std::is_invocable_v<FuncT, typename flat_quadtree<T, Depth, Container, Coord>::const_iterator>>
+flat_quadtree<T, Depth, Container, Coord>::visit(const area& target, FuncT&& visitor) const noexcept(std::is_nothrow_invocable_v<FuncT, const_iterator>) {
+	visit_impl<const_iterator>(*this, target, visitor);
+}
+
+template <typename T, unsigned int Depth, template <typename...> typename Container, typename Coord>
+bool flat_quadtree<T, Depth, Container, Coord>::empty() const noexcept {
+	return size_ == 0;
+}
+
+template <typename T, unsigned int Depth, template <typename...> typename Container, typename Coord>
+auto flat_quadtree<T, Depth, Container, Coord>::size() const noexcept -> size_type {
+	return size_;
+}
+
+template <typename T, unsigned int Depth, template <typename...> typename Container, typename Coord>
+void flat_quadtree<T, Depth, Container, Coord>::clear() noexcept(noexcept(container().clear())) {
+	for (node& n : nodes_) {
+		n.values.clear();
+		n.hitboxes.clear();
+	}
+	size_ = 0;
+}
+
+template <typename T, unsigned int Depth, template <typename...> typename Container, typename Coord>
+auto flat_quadtree<T, Depth, Container, Coord>::erase(iterator it) -> iterator {
+	return erase_impl(it);
+}
+
+template <typename T, unsigned int Depth, template <typename...> typename Container, typename Coord>
+auto flat_quadtree<T, Depth, Container, Coord>::erase(const_iterator it) -> iterator {
+	return erase_impl(it);
+}
+
+template <typename T, unsigned int Depth, template <typename...> typename Container, typename Coord>
+void flat_quadtree<T, Depth, Container, Coord>::erase(const T& t) {
+	iterator it = find(t);
+	if (it != end()) {
+		erase_impl(it);
+	}
+}
+
+template <typename T, unsigned int Depth, template <typename...> typename Container, typename Coord>
+bool flat_quadtree<T, Depth, Container, Coord>::has_collision(const area& ar) const noexcept {
+	return has_collision_if(ar, [](auto&&) { return true; });
+}
+
+template <typename T, unsigned int Depth, template <typename...> typename Container, typename Coord>
+template <typename FuncT>
+bool flat_quadtree<T, Depth, Container, Coord>::has_collision_if(const area& ar, FuncT&& pred) noexcept(std::is_nothrow_invocable_v<FuncT, T&>) {
+	return has_collision_impl(*this, ar, pred);
+}
+
+template <typename T, unsigned int Depth, template <typename...> typename Container, typename Coord>
+template <typename FuncT>
+bool flat_quadtree<T, Depth, Container, Coord>::has_collision_if(const area& ar, FuncT&& pred) const noexcept(std::is_nothrow_invocable_v<FuncT, const T&>) {
+	return has_collision_impl(*this, ar, pred);
+}
+
+template <typename T, unsigned int Depth, template <typename...> typename Container, typename Coord>
+T flat_quadtree<T, Depth, Container, Coord>::extract(iterator element) {
+	return extract_impl(element);
+}
+
+template <typename T, unsigned int Depth, template <typename...> typename Container, typename Coord>
+T flat_quadtree<T, Depth, Container, Coord>::extract(const_iterator element) {
+	return extract_impl(element);
+}
+
+template <typename T, unsigned int Depth, template <typename...> typename Container, typename Coord>
+auto flat_quadtree<T, Depth, Container, Coord>::find(const T& element) noexcept -> iterator {
+	return find_impl<iterator>(*this, element);
+}
+
+template <typename T, unsigned int Depth, template <typename...> typename Container, typename Coord>
+auto flat_quadtree<T, Depth, Container, Coord>::find(const T& element) const noexcept -> const_iterator {
+	return find_impl<const_iterator>(*this, element);
+}
+
+template <typename T, unsigned int Depth, template <typename...> typename Container, typename Coord>
+void flat_quadtree<T, Depth, Container, Coord>::move(iterator it, const area& new_area) {
+	move_impl(it, new_area);
+}
+
+template <typename T, unsigned int Depth, template <typename...> typename Container, typename Coord>
+void flat_quadtree<T, Depth, Container, Coord>::move(const T& element, const area& new_area) {
+	iterator it = find(element);
+	if (it != end()) {
+		move_impl(it, new_area);
+	}
+}
+
+template <typename T, unsigned int Depth, template <typename...> typename Container, typename Coord>
+void flat_quadtree<T, Depth, Container, Coord>::move(const_iterator it, const area& new_area) {
+	move_impl(it, new_area);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename T, unsigned int Depth, template <typename...> typename Container, typename Coord>
+auto flat_quadtree<T, Depth, Container, Coord>::cells_of(const area& ar) const noexcept -> cell_range {
+	auto cell = [](float pos) -> size_type {
+		constexpr size_type last = (size_type{1} << Depth) - 1;
+		if (!(pos > 0.f)) {
+			return 0;
+		}
+		return pos < static_cast<float>(last) ? static_cast<size_type>(pos) : last;
+	};
+
+	// computed as floats, so that unsigned coordinates do not wrap around
+	auto offset = [](Coord pos, Coord origin) {
+		return static_cast<float>(pos) - static_cast<float>(origin);
+	};
+	return {
+		cell(offset(ar.top_left.x, area_.top_left.x) * scale_.x),
+		cell(offset(ar.top_left.y, area_.top_left.y) * scale_.y),
+		cell(offset(ar.bot_right.x, area_.top_left.x) * scale_.x),
+		cell(offset(ar.bot_right.y, area_.top_left.y) * scale_.y)
+	};
+}
+
+template <typename T, unsigned int Depth, template <typename...> typename Container, typename Coord>
+auto flat_quadtree<T, Depth, Container, Coord>::node_of(const area& hitbox) const noexcept -> size_type {
+	const cell_range cells = cells_of(hitbox);
+
+	// the corners share their ancestors from the level at which the bits in which their positions differ are shifted out
+	size_type diff = (cells.min_x ^ cells.max_x) | (cells.min_y ^ cells.max_y);
+	unsigned int shift = 0;
+	while (diff != 0) {
+		diff >>= 1u;
+		++shift;
+	}
+
+	const unsigned int level = Depth - shift;
+	return level_begin(level) + (cells.min_y >> shift) * (size_type{1} << level) + (cells.min_x >> shift);
+}
+
+template <typename T, unsigned int Depth, template <typename...> typename Container, typename Coord>
+void flat_quadtree<T, Depth, Container, Coord>::erase_value_at(node& n, size_type idx) {
+	assert(n.values.size() == n.hitboxes.size());
+	auto it = std::next(n.values.begin(), static_cast<difference_type>(idx));
+	if (it + 1 != n.values.end()) {
+		*it = std::move_if_noexcept(n.values.back());
+	}
+	n.values.pop_back();
+	n.hitboxes.erase_by_swap(idx);
+	--size_;
+}
+
+template <typename T, unsigned int Depth, template <typename...> typename Container, typename Coord>
+template <typename IteratorType>
+auto flat_quadtree<T, Depth, Container, Coord>::erase_impl(IteratorType it) -> iterator {
+	assert(!it.is_at_end());
+	node& n = nodes_[it.node_];
+	const auto idx = static_cast<size_type>(it.current_ - n.values.begin());
+	erase_value_at(n, idx);
+
+	// the last value of the node was moved to idx
+	iterator next{*this, it.node_, std::next(n.values.begin(), static_cast<difference_type>(idx))};
+	next.skip_empty_nodes();
+	return next;
+}
+
+template <typename T, unsigned int Depth, template <typename...> typename Container, typename Coord>
+template <typename IteratorType>
+T flat_quadtree<T, Depth, Container, Coord>::extract_impl(IteratorType element) {
+	assert(!element.is_at_end());
+	node& n = nodes_[element.node_];
+	const auto idx = static_cast<size_type>(element.current_ - n.values.begin());
+	T return_value = std::move_if_noexcept(*std::next(n.values.begin(), static_cast<difference_type>(idx)));
+	erase_value_at(n, idx);
+	return return_value;
+}
+
+template <typename T, unsigned int Depth, template <typename...> typename Container, typename Coord>
+template <typename IteratorType>
+void flat_quadtree<T, Depth, Container, Coord>::move_impl(IteratorType it, const area& new_area) {
+	assert(!it.is_at_end());
+	if (node_of(new_area) == it.node_) {
+		node& n = nodes_[it.node_];
+		const auto idx = static_cast<size_type>(it.current_ - n.values.begin());
+		std::next(n.values.begin(), static_cast<difference_type>(idx))->set_hitbox(new_area);
+		n.hitboxes.set(idx, new_area);
+		return;
+	}
+
+	T val = extract(it);
+	val.set_hitbox(new_area);
+	emplace(new_area, std::move_if_noexcept(val));
+}
+
+template <typename T, unsigned int Depth, template <typename...> typename Container, typename Coord>
+template <typename IteratorType, typename Tree>
+IteratorType flat_quadtree<T, Depth, Container, Coord>::find_impl(Tree& tree, const T& element) {
+	const size_type node_idx = tree.node_of(element.hitbox());
+	auto& values = tree.nodes_[node_idx].values;
+	auto it = std::find(values.begin(), values.end(), element);
+	if (it == values.end()) {
+		return {};
+	}
+	return {tree, node_idx, it};
+}
+
+template <typename T, unsigned int Depth, template <typename...> typename Container, typename Coord>
+template <typename IteratorType, typename Tree, typename FuncT>
+void flat_quadtree<T, Depth, Container, Coord>::visit_impl(Tree& tree, const area& target, FuncT& visitor) {
+	const cell_range cells = tree.cells_of(target);
+
+	// the nodes of each level crossed by target form a rectangle
+	for (unsigned int level = 0 ; level <= Depth ; ++level) {
+		const unsigned int shift = Depth - level;
+		const size_type side = size_type{1} << level;
+
+		for (size_type y = cells.min_y >> shift ; y <= cells.max_y >> shift ; ++y) {
+			for (size_type x = cells.min_x >> shift ; x <= cells.max_x >> shift ; ++x) {
+				const size_type node_idx = level_begin(level) + y * side + x;
+				auto& n = tree.nodes_[node_idx];
+
+				auto idx = n.hitboxes.find_collision(target, 0);
+				while (idx < n.values.size()) {
+					IteratorType it{tree, node_idx, std::next(n.values.begin(), static_cast<difference_type>(idx))};
+					// if non const context AND visitor returns a boolean
+					if constexpr (std::is_same_v<IteratorType, iterator>) {
+						if constexpr (std::is_same_v<std::invoke_result_t<FuncT, iterator>, bool>) {
+							if (visitor(it)) {
+								// last value is moved to idx, which thus needs to be tested again
+								tree.erase_value_at(n, idx);
+								idx = n.hitboxes.find_collision(target, idx);
+								continue;
+							}
+						} else {
+							visitor(it);
+						}
+					} else {
+						visitor(it);
+					}
+					idx = n.hitboxes.find_collision(target, idx + 1);
+				}
+			}
+		}
+	}
+}
+
+template <typename T, unsigned int Depth, template <typename...> typename Container, typename Coord>
+template <typename Tree, typename FuncT>
+bool flat_quadtree<T, Depth, Container, Coord>::has_collision_impl(Tree& tree, const area& ar, FuncT& pred) {
+	const cell_range cells = tree.cells_of(ar);
+
+	for (unsigned int level = 0 ; level <= Depth ; ++level) {
+		const unsigned int shift = Depth - level;
+		const size_type side = size_type{1} << level;
+
+		for (size_type y = cells.min_y >> shift ; y <= cells.max_y >> shift ; ++y) {
+			for (size_type x = cells.min_x >> shift ; x <= cells.max_x >> shift ; ++x) {
+				auto& n = tree.nodes_[level_begin(level) + y * side + x];
+				for (auto idx = n.hitboxes.find_collision(ar, 0) ; idx < n.values.size() ; idx = n.hitboxes.find_collision(ar, idx + 1)) {
+					if (pred(*std::next(n.values.begin(), static_cast<difference_type>(idx)))) {
+						return true;
+					}
+				}
+			}
+		}
+	}
+	return false;
+}
+
+}
@@ -230,7 +230,39 @@ template <typename T>
 constexpr bool dungeep::area<T>::collides_with(const area& other) const noexcept {
 	this->assert_well_formed();
 	other.assert_well_formed();
-	return other.bot_right.is_in(*this) || other.top_left.is_in(*this) || this->bot_right.is_in(other);
+	return top_left.x <= other.bot_right.x && other.top_left.x <= bot_right.x
+	       && top_left.y <= other.bot_right.y && other.top_left.y <= bot_right.y;
+}
+
+template <typename T>
+constexpr float dungeep::area<T>::segment_entry(const point<T>& from, const point<T>& to) const noexcept {
+	this->assert_well_formed();
+
+	float entry = 0.f;
+	float exit = 1.f;
+
+	// slab method: clipping [0 ; 1] against each axis
+	auto clip = [&entry, &exit](float start, float delta, float min, float max) {
+		if (!(delta < 0.f || delta > 0.f)) { // parallel to the slab (std::abs is not constexpr)
+			return min <= start && start <= max;
+		}
+		float t1 = (min - start) / delta;
+		float t2 = (max - start) / delta;
+		if (t1 > t2) {
+			float tmp = t1;
+			t1 = t2;
+			t2 = tmp;
+		}
+		entry = t1 > entry ? t1 : entry;
+		exit = t2 < exit ? t2 : exit;
+		return entry <= exit;
+	};
+
+	const bool crosses = clip(static_cast<float>(from.x), static_cast<float>(to.x) - static_cast<float>(from.x),
+	                          static_cast<float>(top_left.x), static_cast<float>(bot_right.x))
+	                  && clip(static_cast<float>(from.y), static_cast<float>(to.y) - static_cast<float>(from.y),
+	                          static_cast<float>(top_left.y), static_cast<float>(bot_right.y));
+	return crosses ? entry : -1.f;
 }
 
 template <typename T>
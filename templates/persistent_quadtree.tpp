@@ -0,0 +1,281 @@
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///                                                                                                                                     ///
+///  Copyright C 2019, Lucas Lazare                                                                                                     ///
+///  Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation         ///
+///  		files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy,  ///
+///  modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software     ///
+///  		is furnished to do so, subject to the following conditions:                                                                 ///
+///                                                                                                                                     ///
+///  The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.     ///
+///                                                                                                                                     ///
+///  The Software is provided “as is”, without warranty of any kind, express or implied, including but not limited to the               ///
+///  warranties of merchantability, fitness for a particular purpose and noninfringement. In no event shall the authors or              ///
+///  copyright holders be liable for any claim, damages or other liability, whether in an action of contract, tort or otherwise,        ///
+///  arising from, out of or in connection with the software or the use or other dealings in the Software.                              ///
+///                                                                                                                                     ///
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <unordered_set>
+
+namespace dungeep {
+
+template <typename T, typename Coord>
+persistent_quadtree<T, Coord>::persistent_quadtree(const area& ar, size_type max_depth, size_type max_size)
+	: root_{std::make_shared<node>(ar, max_depth)}
+	, max_size_{max_size}
+{}
+
+template <typename T, typename Coord>
+void persistent_quadtree<T, Coord>::insert(const value_type& value) {
+	insert_in(root_, value, value.hitbox());
+}
+
+template <typename T, typename Coord>
+bool persistent_quadtree<T, Coord>::erase(const value_type& value) {
+	const area hitbox = value.hitbox();
+
+	// looked up first, so that a missing element does not duplicate shared nodes
+	const node* n = root_.get();
+	for (unsigned int idx = child_index(*n, hitbox) ; idx < 4 ; idx = child_index(*n, hitbox)) {
+		n = n->children[idx].get();
+	}
+	if (std::find(n->values.begin(), n->values.end(), value) == n->values.end()) {
+		return false;
+	}
+
+	erase_in(root_, value, hitbox);
+	return true;
+}
+
+template <typename T, typename Coord>
+bool persistent_quadtree<T, Coord>::move(const value_type& element, const area& new_area) {
+	T moved{element}; // 'element' may live in this tree
+	if (!erase(moved)) {
+		return false;
+	}
+	moved.set_hitbox(new_area);
+	insert(moved);
+	return true;
+}
+
+template <typename T, typename Coord>
+template <typename FuncT>
+void persistent_quadtree<T, Coord>::visit(const area& target, FuncT&& visitor) const noexcept(std::is_nothrow_invocable_v<FuncT, const T&>) {
+	visit_impl(*root_, target, visitor);
+}
+
+template <typename T, typename Coord>
+bool persistent_quadtree<T, Coord>::has_collision(const area& ar) const noexcept {
+	return has_collision_if(ar, [](const T&) noexcept { return true; });
+}
+
+template <typename T, typename Coord>
+template <typename FuncT>
+bool persistent_quadtree<T, Coord>::has_collision_if(const area& ar, FuncT&& pred) const noexcept(std::is_nothrow_invocable_v<FuncT, const T&>) {
+	return has_collision_impl(*root_, ar, pred);
+}
+
+template <typename T, typename Coord>
+void persistent_quadtree<T, Coord>::clear() {
+	root_ = std::make_shared<node>(root_->box, root_->max_depth);
+}
+
+template <typename T, typename Coord>
+auto persistent_quadtree<T, Coord>::shared_node_count(const persistent_quadtree& other) const -> size_type {
+	std::unordered_set<const node*> other_nodes;
+	std::vector<const node*> pending{other.root_.get()};
+	while (!pending.empty()) {
+		const node* n = pending.back();
+		pending.pop_back();
+		other_nodes.insert(n);
+		for (const auto& child : n->children) {
+			if (child) {
+				pending.push_back(child.get());
+			}
+		}
+	}
+
+	size_type count = 0;
+	pending.push_back(root_.get());
+	while (!pending.empty()) {
+		const node* n = pending.back();
+		pending.pop_back();
+		count += other_nodes.count(n);
+		for (const auto& child : n->children) {
+			if (child) {
+				pending.push_back(child.get());
+			}
+		}
+	}
+	return count;
+}
+
+template <typename T, typename Coord>
+auto persistent_quadtree<T, Coord>::own(std::shared_ptr<node>& ptr) -> node& {
+	assert(ptr);
+	if (ptr.use_count() != 1) {
+		// the clone shares the children, which will in turn be cloned if the walk goes through them
+		ptr = std::make_shared<node>(*ptr);
+	} else {
+		// use_count() is a relaxed load: synchronises with the release of the last reference held by another thread,
+		// so that its reads of the node happen before our writes
+		std::atomic_thread_fence(std::memory_order_acquire);
+	}
+	return *ptr;
+}
+
+template <typename T, typename Coord>
+unsigned int persistent_quadtree<T, Coord>::child_index(const node& n, const area& hitbox) noexcept {
+	if (!n.children[0]) {
+		return 4;
+	}
+	for (auto i = 0u ; i < 4 ; ++i) {
+		if (n.children[i]->box.contains(hitbox)) {
+			return i;
+		}
+	}
+	return 4;
+}
+
+template <typename T, typename Coord>
+void persistent_quadtree<T, Coord>::insert_in(std::shared_ptr<node>& ptr, const value_type& value, const area& hitbox) {
+	node& n = own(ptr);
+
+	const unsigned int idx = child_index(n, hitbox);
+	if (idx < 4) {
+		insert_in(n.children[idx], value, hitbox);
+	} else {
+		n.values.push_back(value);
+		n.hitboxes.push_back(hitbox);
+	}
+	++n.subtree_size;
+
+	if (!n.children[0] && n.values.size() > max_size_ && n.max_depth > 0) {
+		split(n);
+	}
+}
+
+template <typename T, typename Coord>
+void persistent_quadtree<T, Coord>::erase_in(std::shared_ptr<node>& ptr, const value_type& value, const area& hitbox) {
+	node& n = own(ptr);
+
+	const unsigned int idx = child_index(n, hitbox);
+	if (idx < 4) {
+		erase_in(n.children[idx], value, hitbox);
+	} else {
+		auto it = std::find(n.values.begin(), n.values.end(), value);
+		assert(it != n.values.end());
+		const auto value_idx = static_cast<size_type>(it - n.values.begin());
+		if (value_idx + 1 != n.values.size()) {
+			*it = std::move_if_noexcept(n.values.back());
+		}
+		n.values.pop_back();
+		n.hitboxes.erase_by_swap(value_idx);
+	}
+	--n.subtree_size;
+
+	if (n.children[0] && n.subtree_size <= max_size_ / 2) {
+		merge(n);
+	}
+}
+
+template <typename T, typename Coord>
+void persistent_quadtree<T, Coord>::split(node& n) {
+	const point& tl = n.box.top_left;
+	const point& br = n.box.bot_right;
+	const point center{(tl.x + br.x) / 2, (tl.y + br.y) / 2};
+	const std::array<area, 4> boxes{
+			area{tl, center},
+			area{{center.x, tl.y}, {br.x, center.y}},
+			area{center, br},
+			area{{tl.x, center.y}, {center.x, br.y}}
+	};
+	for (auto i = 0u ; i < 4 ; ++i) {
+		n.children[i] = std::make_shared<node>(boxes[i], n.max_depth - 1);
+	}
+
+	size_type idx = 0;
+	while (idx < n.values.size()) {
+		const area hitbox = n.hitboxes[idx];
+		const unsigned int child = child_index(n, hitbox);
+		if (child == 4) {
+			++idx;
+			continue;
+		}
+
+		node& target = *n.children[child];
+		target.values.push_back(std::move_if_noexcept(n.values[idx]));
+		target.hitboxes.push_back(hitbox);
+		++target.subtree_size;
+
+		if (idx + 1 != n.values.size()) {
+			n.values[idx] = std::move_if_noexcept(n.values.back());
+		}
+		n.values.pop_back();
+		n.hitboxes.erase_by_swap(idx);
+	}
+}
+
+template <typename T, typename Coord>
+void persistent_quadtree<T, Coord>::merge(node& n) {
+	// descendants may be shared with other copies: their elements are copied, not moved
+	std::vector<const node*> pending;
+	for (const auto& child : n.children) {
+		pending.push_back(child.get());
+	}
+	while (!pending.empty()) {
+		const node* descendant = pending.back();
+		pending.pop_back();
+		for (size_type i = 0 ; i < descendant->values.size() ; ++i) {
+			n.values.push_back(descendant->values[i]);
+			n.hitboxes.push_back(descendant->hitboxes[i]);
+		}
+		if (descendant->children[0]) {
+			for (const auto& child : descendant->children) {
+				pending.push_back(child.get());
+			}
+		}
+	}
+	n.children = {};
+}
+
+template <typename T, typename Coord>
+template <typename FuncT>
+void persistent_quadtree<T, Coord>::visit_impl(const node& n, const area& target, FuncT& visitor) {
+	const size_type sz = n.hitboxes.size();
+	for (size_type i = n.hitboxes.find_collision(target, 0) ; i < sz ; i = n.hitboxes.find_collision(target, i + 1)) {
+		visitor(n.values[i]);
+	}
+	if (n.children[0]) {
+		for (const auto& child : n.children) {
+			if (child->box.collides_with(target)) {
+				visit_impl(*child, target, visitor);
+			}
+		}
+	}
+}
+
+template <typename T, typename Coord>
+template <typename FuncT>
+bool persistent_quadtree<T, Coord>::has_collision_impl(const node& n, const area& target, FuncT& pred) {
+	const size_type sz = n.hitboxes.size();
+	for (size_type i = n.hitboxes.find_collision(target, 0) ; i < sz ; i = n.hitboxes.find_collision(target, i + 1)) {
+		if (pred(n.values[i])) {
+			return true;
+		}
+	}
+	if (n.children[0]) {
+		for (const auto& child : n.children) {
+			if (child->box.collides_with(target) && has_collision_impl(*child, target, pred)) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+}
@@ -21,12 +21,14 @@
 #include <type_traits>
 #include <utility>
 #include <algorithm>
+#include <array>
+#include <limits>
 
 namespace dungeep {
 
-template <typename T,quadtree_dynamics D, template <typename...> typename U>
+template <typename T,quadtree_dynamics D, template <typename...> typename U, typename Coord>
 template <typename QuadTree, typename Value, typename SubIterator>
-struct quadtree<T,D,U>::iterator_type {
+struct quadtree<T,D,U,Coord>::iterator_type {
 
 	using difference_type = std::size_t;
 	using value_type = Value;
@@ -90,7 +92,7 @@ struct quadtree<T,D,U>::iterator_type {
 	}
 
 private:
-	friend quadtree<T,D,U>;
+	friend quadtree<T,D,U,Coord>;
 
 	void seek_last() noexcept {
 		current_ = std::next(qt_->values_.begin(), static_cast<long>(qt_->values_.size() - 1));
@@ -101,10 +103,11 @@ private:
 		if (qt_->children_) {
 			for (auto i = 0u ; i < 4 ; ++i) {
 				if (!(*qt_->children_)[i].empty()) {
-					return std::make_unique<pair_type>(i + 1, (*qt_->children_)[i].begin());
+					// children_ does not propagate constness: iterators are built directly, so that const trees yield const iterators
+					return std::make_unique<pair_type>(i + 1, iterator_type{(*qt_->children_)[i]});
 				}
 			}
-			return std::make_unique<pair_type>(4, (*qt_->children_)[3].end());
+			return std::make_unique<pair_type>(4, iterator_type{});
 		} else {
 			return {nullptr};
 		}
@@ -116,17 +119,17 @@ private:
 
 };
 
-template <typename T, quadtree_dynamics D, template <typename...> typename U>
+template <typename T, quadtree_dynamics D, template <typename...> typename U, typename Coord>
 template <typename Q, typename V, typename S>
-quadtree<T,D,U>::iterator_type<Q,V,S>::iterator_type(const iterator_type<Q,V,S>& other)
+quadtree<T,D,U,Coord>::iterator_type<Q,V,S>::iterator_type(const iterator_type<Q,V,S>& other)
 		: qt_{other.qt_}
 		, current_{other.current_}
 		, child_it_{other.child_it_ == nullptr ? nullptr : std::make_unique<pair_type>(*other.child_it_)}
 {}
 
-template <typename T, quadtree_dynamics D, template <typename...> typename U>
+template <typename T, quadtree_dynamics D, template <typename...> typename U, typename Coord>
 template <typename Q, typename V, typename S>
-auto quadtree<T,D,U>::iterator_type<Q,V,S>::operator=(const iterator_type& other) -> iterator_type& {
+auto quadtree<T,D,U,Coord>::iterator_type<Q,V,S>::operator=(const iterator_type& other) -> iterator_type& {
 	this->qt_ = other.qt_;
 	this->current_ = other.current_;
 
@@ -140,17 +143,17 @@ auto quadtree<T,D,U>::iterator_type<Q,V,S>::operator=(const iterator_type& other
 
 
 
-template <typename T, quadtree_dynamics D, template <typename...> typename U>
+template <typename T, quadtree_dynamics D, template <typename...> typename U, typename Coord>
 template <typename Q, typename V, typename S>
-auto quadtree<T,D,U>::iterator_type<Q,V,S>::operator++(int) const noexcept -> iterator_type {
+auto quadtree<T,D,U,Coord>::iterator_type<Q,V,S>::operator++(int) const noexcept -> iterator_type {
         iterator_type<Q,V,S> tmp(*this);
 		return ++tmp;
 }
 
 
-template <typename T, quadtree_dynamics D, template <typename...> typename U>
+template <typename T, quadtree_dynamics D, template <typename...> typename U, typename Coord>
 template <typename Q, typename V, typename S>
-auto quadtree<T,D,U>::iterator_type<Q,V,S>::operator++() noexcept -> iterator_type& {
+auto quadtree<T,D,U,Coord>::iterator_type<Q,V,S>::operator++() noexcept -> iterator_type& {
 	assert(qt_);
 	if (current_ == qt_->values_.end()) {
 		assert(child_it_);
@@ -171,16 +174,16 @@ auto quadtree<T,D,U>::iterator_type<Q,V,S>::operator++() noexcept -> iterator_ty
 }
 
 
-template <typename T, quadtree_dynamics D, template <typename...> typename U>
+template <typename T, quadtree_dynamics D, template <typename...> typename U, typename Coord>
 template <typename Q, typename V, typename S>
-auto quadtree<T,D,U>::iterator_type<Q,V,S>::operator--(int) const noexcept -> iterator_type {
+auto quadtree<T,D,U,Coord>::iterator_type<Q,V,S>::operator--(int) const noexcept -> iterator_type {
 	iterator_type<Q,V,S> tmp(*this);
 	return --tmp;
 }
 
-template <typename T, quadtree_dynamics D, template <typename...> typename U>
+template <typename T, quadtree_dynamics D, template <typename...> typename U, typename Coord>
 template <typename Q, typename V, typename S>
-auto quadtree<T,D,U>::iterator_type<Q,V,S>::operator--() noexcept -> iterator_type& {
+auto quadtree<T,D,U,Coord>::iterator_type<Q,V,S>::operator--() noexcept -> iterator_type& {
 	assert(qt_);
 	if (current_ == qt_->values_.end() && child_it_) {
 		if (!child_it_->second.is_at_beg()) {
@@ -206,9 +209,9 @@ auto quadtree<T,D,U>::iterator_type<Q,V,S>::operator--() noexcept -> iterator_ty
 }
 
 // test end == end, beg == beg, end == {}
-template <typename T, quadtree_dynamics D, template <typename...> typename U>
+template <typename T, quadtree_dynamics D, template <typename...> typename U, typename Coord>
 template <typename Q, typename V, typename S>
-bool quadtree<T,D,U>::iterator_type<Q,V,S>::operator==(const iterator_type& other) const noexcept {
+bool quadtree<T,D,U,Coord>::iterator_type<Q,V,S>::operator==(const iterator_type& other) const noexcept {
 	if (other.qt_ == nullptr) {
 		return this->is_at_end();
 	} else if (this->qt_ == nullptr) {
@@ -225,15 +228,15 @@ bool quadtree<T,D,U>::iterator_type<Q,V,S>::operator==(const iterator_type& othe
 	}
 }
 
-template <typename T, quadtree_dynamics D, template <typename...> typename U>
+template <typename T, quadtree_dynamics D, template <typename...> typename U, typename Coord>
 template <typename Q, typename V, typename S>
-bool quadtree<T,D,U>::iterator_type<Q,V,S>::operator!=(const iterator_type& other) const noexcept {
+bool quadtree<T,D,U,Coord>::iterator_type<Q,V,S>::operator!=(const iterator_type& other) const noexcept {
 	return !(*this == other);
 }
 
-template <typename T, quadtree_dynamics D, template <typename...> typename U>
+template <typename T, quadtree_dynamics D, template <typename...> typename U, typename Coord>
 template <typename Q, typename V, typename S>
-bool quadtree<T,D,U>::iterator_type<Q,V,S>::operator>(const iterator_type& other) const noexcept {
+bool quadtree<T,D,U,Coord>::iterator_type<Q,V,S>::operator>(const iterator_type& other) const noexcept {
 	if (this->current_ != other.current_) {
 		return this->current_ > other.current_;
 	}
@@ -252,9 +255,9 @@ bool quadtree<T,D,U>::iterator_type<Q,V,S>::operator>(const iterator_type& other
 	}
 }
 
-template <typename T, quadtree_dynamics D, template <typename...> typename U>
+template <typename T, quadtree_dynamics D, template <typename...> typename U, typename Coord>
 template <typename Q, typename V, typename S>
-bool quadtree<T,D,U>::iterator_type<Q,V,S>::operator>=(const iterator_type& other) const noexcept {
+bool quadtree<T,D,U,Coord>::iterator_type<Q,V,S>::operator>=(const iterator_type& other) const noexcept {
 	if (this->current_ != other.current_) {
 		return this->current_ >= other.current_;
 	}
@@ -273,21 +276,21 @@ bool quadtree<T,D,U>::iterator_type<Q,V,S>::operator>=(const iterator_type& othe
 	}
 }
 
-template <typename T, quadtree_dynamics D, template <typename...> typename U>
+template <typename T, quadtree_dynamics D, template <typename...> typename U, typename Coord>
 template <typename Q, typename V, typename S>
-bool quadtree<T,D,U>::iterator_type<Q,V,S>::operator<(const iterator_type& other) const noexcept {
+bool quadtree<T,D,U,Coord>::iterator_type<Q,V,S>::operator<(const iterator_type& other) const noexcept {
 	return !(*this >= other);
 }
 
-template <typename T, quadtree_dynamics D,template <typename...> typename U>
+template <typename T, quadtree_dynamics D,template <typename...> typename U, typename Coord>
 template <typename Q, typename V, typename S>
-bool quadtree<T,D,U>::iterator_type<Q,V,S>::operator<=(const iterator_type& other) const noexcept {
+bool quadtree<T,D,U,Coord>::iterator_type<Q,V,S>::operator<=(const iterator_type& other) const noexcept {
 	return !(*this > other);
 }
 
-template <typename T, quadtree_dynamics D, template <typename...> typename U>
+template <typename T, quadtree_dynamics D, template <typename...> typename U, typename Coord>
 template <typename Q, typename V, typename S>
-auto quadtree<T,D,U>::iterator_type<Q,V,S>::operator*() noexcept -> value_type& {
+auto quadtree<T,D,U,Coord>::iterator_type<Q,V,S>::operator*() noexcept -> value_type& {
 	assert(qt_);
 	if (current_ != qt_->values_.end()) {
 		return *current_;
@@ -297,9 +300,9 @@ auto quadtree<T,D,U>::iterator_type<Q,V,S>::operator*() noexcept -> value_type&
 	}
 }
 
-template <typename T, quadtree_dynamics D, template <typename...> typename U>
+template <typename T, quadtree_dynamics D, template <typename...> typename U, typename Coord>
 template <typename Q, typename V, typename S>
-auto quadtree<T,D,U>::iterator_type<Q,V,S>::operator*() const noexcept -> const value_type& {
+auto quadtree<T,D,U,Coord>::iterator_type<Q,V,S>::operator*() const noexcept -> const value_type& {
 	assert(qt_);
 	if (current_ != qt_->values_.end()) {
 		return *current_;
@@ -308,9 +311,9 @@ auto quadtree<T,D,U>::iterator_type<Q,V,S>::operator*() const noexcept -> const
 	}
 }
 
-template <typename T, quadtree_dynamics D, template <typename...> typename U>
+template <typename T, quadtree_dynamics D, template <typename...> typename U, typename Coord>
 template <typename Q, typename V, typename S>
-auto quadtree<T,D,U>::iterator_type<Q,V,S>::operator->() noexcept -> value_type* {
+auto quadtree<T,D,U,Coord>::iterator_type<Q,V,S>::operator->() noexcept -> value_type* {
 	assert(qt_);
 	if (current_ != qt_->values_.end()) {
 		return &*current_;
@@ -319,9 +322,9 @@ auto quadtree<T,D,U>::iterator_type<Q,V,S>::operator->() noexcept -> value_type*
 	}
 }
 
-template <typename T, quadtree_dynamics D, template <typename...> typename U>
+template <typename T, quadtree_dynamics D, template <typename...> typename U, typename Coord>
 template <typename Q, typename V, typename S>
-auto quadtree<T,D,U>::iterator_type<Q,V,S>::operator->() const noexcept -> const value_type* {
+auto quadtree<T,D,U,Coord>::iterator_type<Q,V,S>::operator->() const noexcept -> const value_type* {
 	if (current_ != qt_->values_.end()) {
 		return &*current_;
 	} else {
@@ -331,14 +334,15 @@ auto quadtree<T,D,U>::iterator_type<Q,V,S>::operator->() const noexcept -> const
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-template<typename T,quadtree_dynamics Dynamicity, template <typename...> typename Container>
-quadtree<T, Dynamicity, Container>::quadtree(const area& ar, size_type max_depth, size_type max_size)
+template<typename T,quadtree_dynamics Dynamicity, template <typename...> typename Container, typename Coord>
+quadtree<T, Dynamicity, Container, Coord>::quadtree(const area& ar, size_type max_depth, size_type max_size)
 	noexcept(Dynamicity != quadtree_dynamics::static_children && noexcept(container()))
 	: area_{ar}
 	, center_{(area_.top_left + area_.bot_right) / 2}
 	, max_size_{max_size}
 	, max_depth_{max_depth}
 	, values_{}
+	, hitboxes_{}
 	, children_{nullptr}
 {
 	if constexpr (Dynamicity == quadtree_dynamics::static_children) {
@@ -347,70 +351,73 @@ quadtree<T, Dynamicity, Container>::quadtree(const area& ar, size_type max_depth
 		}
 	}
 	values_.reserve(max_size);
+	hitboxes_.reserve(max_size);
 }
 
 
-template<typename T, quadtree_dynamics Dynamicity, template <typename...> typename Container>
-quadtree<T, Dynamicity, Container>::quadtree(const quadtree& other)
+template<typename T, quadtree_dynamics Dynamicity, template <typename...> typename Container, typename Coord>
+quadtree<T, Dynamicity, Container, Coord>::quadtree(const quadtree& other)
 	: area_{other.area_}
 	, center_{other.center_}
 	, max_size_{other.max_size_}
 	, max_depth_{other.max_depth_}
 	, values_{other.values_}
-	, children_{std::make_unique<children>(other.children_)}
+	, hitboxes_{other.hitboxes_}
+	, children_{other.children_ ? std::make_unique<children>(*other.children_) : nullptr}
 {}
 
-template<typename T, quadtree_dynamics Dynamicity, template <typename...> typename Container>
-auto quadtree<T, Dynamicity, Container>::operator=(const quadtree<T, Dynamicity, Container>& other) -> quadtree& {
+template<typename T, quadtree_dynamics Dynamicity, template <typename...> typename Container, typename Coord>
+auto quadtree<T, Dynamicity, Container, Coord>::operator=(const quadtree<T, Dynamicity, Container, Coord>& other) -> quadtree& {
 	this->area_ = other.area_;
 	this->center_ = other.center_;
 	this->max_size_ = other.max_size_;
 	this->max_depth_ = other.max_depth_;
 	this->values_ = other.values_;
-	this->children_ = std::make_unique<children>(other.children_);
+	this->hitboxes_ = other.hitboxes_;
+	this->children_ = other.children_ ? std::make_unique<children>(*other.children_) : nullptr;
 	return *this;
 }
 
-template<typename T,quadtree_dynamics D, template <typename...> typename Container>
-auto quadtree<T, D, Container>::begin() noexcept -> iterator {
+template<typename T,quadtree_dynamics D, template <typename...> typename Container, typename Coord>
+auto quadtree<T, D, Container, Coord>::begin() noexcept -> iterator {
 	return iterator{*this};
 }
 
-template<typename T,quadtree_dynamics D, template <typename...> typename Container>
-auto quadtree<T, D, Container>::begin() const noexcept -> const_iterator {
-	return iterator{*this};
+template<typename T,quadtree_dynamics D, template <typename...> typename Container, typename Coord>
+auto quadtree<T, D, Container, Coord>::begin() const noexcept -> const_iterator {
+	return const_iterator{*this};
 }
 
-template<typename T,quadtree_dynamics D, template <typename...> typename Container>
-auto quadtree<T, D, Container>::cbegin() const noexcept -> const_iterator {
+template<typename T,quadtree_dynamics D, template <typename...> typename Container, typename Coord>
+auto quadtree<T, D, Container, Coord>::cbegin() const noexcept -> const_iterator {
 	return const_iterator{*this};
 }
 
-template<typename T,quadtree_dynamics D, template <typename...> typename Container>
-auto quadtree<T, D, Container>::end() noexcept -> iterator {
+template<typename T,quadtree_dynamics D, template <typename...> typename Container, typename Coord>
+auto quadtree<T, D, Container, Coord>::end() noexcept -> iterator {
 	return iterator{};
 }
 
-template<typename T,quadtree_dynamics D, template <typename...> typename Container>
-auto quadtree<T, D, Container>::end() const noexcept -> const_iterator {
+template<typename T,quadtree_dynamics D, template <typename...> typename Container, typename Coord>
+auto quadtree<T, D, Container, Coord>::end() const noexcept -> const_iterator {
 	return const_iterator{};
 }
 
-template<typename T,quadtree_dynamics D, template <typename...> typename Container>
-auto quadtree<T, D, Container>::cend() const noexcept -> const_iterator {
+template<typename T,quadtree_dynamics D, template <typename...> typename Container, typename Coord>
+auto quadtree<T, D, Container, Coord>::cend() const noexcept -> const_iterator {
 	return const_iterator{};
 }
 
-template<typename T,quadtree_dynamics D, template <typename...> typename Container>
-auto quadtree<T, D, Container>::insert(const value_type& value) -> iterator {
+template<typename T,quadtree_dynamics D, template <typename...> typename Container, typename Coord>
+auto quadtree<T, D, Container, Coord>::insert(const value_type& value) -> iterator {
 	return emplace(value.hitbox(), value);
 }
 
-template<typename T,quadtree_dynamics D, template <typename...> typename Container>
+template<typename T,quadtree_dynamics D, template <typename...> typename Container, typename Coord>
 template<typename... Args>
-auto quadtree<T, D, Container>::emplace(const area& target, Args&& ... args) -> iterator {
+auto quadtree<T, D, Container, Coord>::emplace(const area& target, Args&& ... args) -> iterator {
 
-	if (values_.size() == max_size_) {
+	if (values_.size() >= max_size_) { // adapt may have lowered max_size_ below the current size
 		create_children();
 	}
 
@@ -422,6 +429,7 @@ auto quadtree<T, D, Container>::emplace(const area& target, Args&& ... args) ->
 	iterator it{*this};
 	if (target_pos == dirs::none) {
 		values_.emplace_back(std::forward<Args>(args)...);
+		hitboxes_.push_back(target);
 		it.current_ = std::prev(values_.end());
 	} else {
 		it.current_ = values_.end();
@@ -431,8 +439,8 @@ auto quadtree<T, D, Container>::emplace(const area& target, Args&& ... args) ->
 	return it;
 }
 
-template<typename T,quadtree_dynamics D, template <typename...> typename Container>
-bool quadtree<T, D, Container>::empty() const noexcept {
+template<typename T,quadtree_dynamics D, template <typename...> typename Container, typename Coord>
+bool quadtree<T, D, Container, Coord>::empty() const noexcept {
 	if (!values_.empty()) {
 		return false;
 	}
@@ -443,8 +451,8 @@ bool quadtree<T, D, Container>::empty() const noexcept {
 	return (*children_)[0].empty() && (*children_)[1].empty() && (*children_)[2].empty() && (*children_)[3].empty();
 }
 
-template<typename T,quadtree_dynamics D, template <typename...> typename Container>
-auto quadtree<T, D, Container>::size() const noexcept -> size_type {
+template<typename T,quadtree_dynamics D, template <typename...> typename Container, typename Coord>
+auto quadtree<T, D, Container, Coord>::size() const noexcept -> size_type {
 	if (!children_) {
 		return values_.size();
 	}
@@ -455,9 +463,10 @@ auto quadtree<T, D, Container>::size() const noexcept -> size_type {
 	return size;
 }
 
-template<typename T,quadtree_dynamics D, template <typename...> typename Container>
-void quadtree<T, D, Container>::clear() noexcept(noexcept(container().clear())) {
+template<typename T,quadtree_dynamics D, template <typename...> typename Container, typename Coord>
+void quadtree<T, D, Container, Coord>::clear() noexcept(noexcept(container().clear())) {
 	values_.clear();
+	hitboxes_.clear();
 	if (children_) {
 		for (auto i = 0u ; i < 4 ; ++i) {
 			(*children_)[i].clear();
@@ -465,18 +474,18 @@ void quadtree<T, D, Container>::clear() noexcept(noexcept(container().clear()))
 	}
 }
 
-template<typename T,quadtree_dynamics D, template <typename...> typename Container>
-auto quadtree<T, D, Container>::erase(iterator it) -> iterator {
+template<typename T,quadtree_dynamics D, template <typename...> typename Container, typename Coord>
+auto quadtree<T, D, Container, Coord>::erase(iterator it) -> iterator {
 	return erase_impl(it);
 }
 
-template<typename T,quadtree_dynamics D, template <typename...> typename Container>
-auto quadtree<T, D, Container>::erase(const_iterator it) -> iterator {
+template<typename T,quadtree_dynamics D, template <typename...> typename Container, typename Coord>
+auto quadtree<T, D, Container, Coord>::erase(const_iterator it) -> iterator {
 	return erase_impl(it);
 }
 
-template<typename T,quadtree_dynamics D, template <typename...> typename Container>
-void quadtree<T, D, Container>::erase(const T& t) {
+template<typename T,quadtree_dynamics D, template <typename...> typename Container, typename Coord>
+void quadtree<T, D, Container, Coord>::erase(const T& t) {
 	auto dir = find_dir(t.hitbox());
 
 	if (children_ && dir != dirs::none) {
@@ -488,25 +497,34 @@ void quadtree<T, D, Container>::erase(const T& t) {
 
 	auto it = std::find_if(values_.begin(), values_.end(), [&t](const T& t2) { return t == t2; });
 	if (it != values_.end()) {
-		if (it + 1 != values_.end()) {
-			*it = std::move_if_noexcept(values_.back());
-		}
-		values_.pop_back();
+		erase_value_at(static_cast<size_type>(it - values_.begin()));
+	}
+}
+
+template<typename T,quadtree_dynamics D, template <typename...> typename Container, typename Coord>
+void quadtree<T, D, Container, Coord>::erase_value_at(size_type idx) {
+	assert(values_.size() == hitboxes_.size());
+	auto it = std::next(values_.begin(), static_cast<difference_type>(idx));
+	if (it + 1 != values_.end()) {
+		*it = std::move_if_noexcept(values_.back());
 	}
+	values_.pop_back();
+	hitboxes_.erase_by_swap(idx);
 }
 
-template<typename T,quadtree_dynamics D, template <typename...> typename Container>
-bool quadtree<T, D, Container>::has_collision(const area& ar) const noexcept {
+template<typename T,quadtree_dynamics D, template <typename...> typename Container, typename Coord>
+bool quadtree<T, D, Container, Coord>::has_collision(const area& ar) const noexcept {
 	return has_collision_if(ar, [](auto&&) { return true; });
 }
 
 #define DUNGEEP_QTREE_HASCOLLISIONIF_IMPL(ar, pred) \
+	visits_.add();\
 	if (!ar.collides_with(this->area_)) {\
 		return false;\
 	}\
 	\
-	for (auto&& val : values_) {\
-		if (ar.collides_with(val.hitbox()) && pred(val)) {\
+	for (auto idx = hitboxes_.find_collision(ar, 0) ; idx < values_.size() ; idx = hitboxes_.find_collision(ar, idx + 1)) {\
+		if (pred(*std::next(values_.begin(), static_cast<difference_type>(idx)))) {\
 			return true;\
 		}\
 	}\
@@ -521,22 +539,197 @@ bool quadtree<T, D, Container>::has_collision(const area& ar) const noexcept {
 	\
 	return false;
 
-template<typename T,quadtree_dynamics D, template <typename...> typename Container>
+template<typename T,quadtree_dynamics D, template <typename...> typename Container, typename Coord>
 template <typename FuncT>
-bool quadtree<T,D,Container>::has_collision_if(const area& ar, FuncT&& pred) noexcept(std::is_nothrow_invocable_v<FuncT, T&>) {
+bool quadtree<T,D,Container,Coord>::has_collision_if(const area& ar, FuncT&& pred) noexcept(std::is_nothrow_invocable_v<FuncT, T&>) {
 	DUNGEEP_QTREE_HASCOLLISIONIF_IMPL(ar, pred)
 }
 
-template<typename T,quadtree_dynamics D, template <typename...> typename Container>
+template<typename T,quadtree_dynamics D, template <typename...> typename Container, typename Coord>
 template <typename FuncT>
-bool quadtree<T,D,Container>::has_collision_if(const area& ar, FuncT&& pred) const noexcept(std::is_nothrow_invocable_v<FuncT, const T&>) {
+bool quadtree<T,D,Container,Coord>::has_collision_if(const area& ar, FuncT&& pred) const noexcept(std::is_nothrow_invocable_v<FuncT, const T&>) {
 	DUNGEEP_QTREE_HASCOLLISIONIF_IMPL(ar, pred)
 }
 
 #undef DUNGEEP_QTREE_HASCOLLISIONIF_IMPL
 
-template<typename T,quadtree_dynamics D, template <typename...> typename Container>
-auto quadtree<T, D, Container>::find_dir(const area& target) const -> dirs {
+template<typename T,quadtree_dynamics D, template <typename...> typename Container, typename Coord>
+template <typename FuncT>
+bool quadtree<T,D,Container,Coord>::parallel_has_collision_if(const area& ar, FuncT&& pred, thread_pool& pool) const {
+	std::atomic<bool> found{false};
+	thread_pool::task_group group;
+	parallel_has_collision_impl(ar, pred, pool, group, found);
+	pool.wait(group);
+	return found.load(std::memory_order_relaxed);
+}
+
+template<typename T,quadtree_dynamics D, template <typename...> typename Container, typename Coord>
+template <typename FuncT>
+void quadtree<T,D,Container,Coord>::parallel_has_collision_impl(const area& ar, FuncT& pred, thread_pool& pool, thread_pool::task_group& group, std::atomic<bool>& found) const {
+	if (found.load(std::memory_order_relaxed) || !ar.collides_with(area_)) {
+		return;
+	}
+
+	if (!children_ || !is_large_query(ar)) {
+		if (has_collision_if(ar, [&found, &pred](const T& value) { return found.load(std::memory_order_relaxed) || pred(value); })) {
+			found.store(true, std::memory_order_relaxed);
+		}
+		return;
+	}
+
+	visits_.add();
+	for (auto i = 0u ; i < 4 ; ++i) {
+		pool.push(group, [&child = (*children_)[i], &ar, &pred, &pool, &group, &found] {
+			child.parallel_has_collision_impl(ar, pred, pool, group, found);
+		});
+	}
+
+	for (auto idx = hitboxes_.find_collision(ar, 0) ; idx < values_.size() ; idx = hitboxes_.find_collision(ar, idx + 1)) {
+		if (found.load(std::memory_order_relaxed) || pred(*std::next(values_.begin(), static_cast<difference_type>(idx)))) {
+			found.store(true, std::memory_order_relaxed);
+			return;
+		}
+	}
+}
+
+template<typename T,quadtree_dynamics D, template <typename...> typename Container, typename Coord>
+template <typename FuncT>
+void quadtree<T,D,Container,Coord>::for_each_colliding_pair(FuncT&& func) noexcept(std::is_nothrow_invocable_v<FuncT, T&, T&>) {
+	colliding_pairs_impl(*this, func);
+}
+
+template<typename T,quadtree_dynamics D, template <typename...> typename Container, typename Coord>
+template <typename FuncT>
+void quadtree<T,D,Container,Coord>::for_each_colliding_pair(FuncT&& func) const noexcept(std::is_nothrow_invocable_v<FuncT, const T&, const T&>) {
+	colliding_pairs_impl(*this, func);
+}
+
+template<typename T,quadtree_dynamics D, template <typename...> typename Container, typename Coord>
+template <typename QuadTree, typename FuncT>
+void quadtree<T,D,Container,Coord>::colliding_pairs_impl(QuadTree& qt, FuncT& func) {
+	for (size_type first = 0 ; first < qt.values_.size() ; ++first) {
+		const area first_hitbox = qt.hitboxes_[first];
+		auto& first_value = *std::next(qt.values_.begin(), static_cast<difference_type>(first));
+
+		for (auto second = qt.hitboxes_.find_collision(first_hitbox, first + 1) ; second < qt.values_.size()
+				; second = qt.hitboxes_.find_collision(first_hitbox, second + 1)) {
+			func(first_value, *std::next(qt.values_.begin(), static_cast<difference_type>(second)));
+		}
+
+		if (qt.children_) {
+			for (auto i = 0u ; i < 4 ; ++i) {
+				collide_with_descendants((*qt.children_)[i], first_value, first_hitbox, func);
+			}
+		}
+	}
+
+	// elements of two different children are on both sides of the center: they can't collide
+	if (qt.children_) {
+		for (auto i = 0u ; i < 4 ; ++i) {
+			colliding_pairs_impl((*qt.children_)[i], func);
+		}
+	}
+}
+
+template<typename T,quadtree_dynamics D, template <typename...> typename Container, typename Coord>
+template <typename QuadTree, typename Value, typename FuncT>
+void quadtree<T,D,Container,Coord>::collide_with_descendants(QuadTree& qt, Value& value, const area& value_hitbox, FuncT& func) {
+	if (!value_hitbox.collides_with(qt.area_)) {
+		return;
+	}
+
+	for (auto idx = qt.hitboxes_.find_collision(value_hitbox, 0) ; idx < qt.values_.size()
+			; idx = qt.hitboxes_.find_collision(value_hitbox, idx + 1)) {
+		func(value, *std::next(qt.values_.begin(), static_cast<difference_type>(idx)));
+	}
+
+	if (qt.children_) {
+		for (auto i = 0u ; i < 4 ; ++i) {
+			collide_with_descendants((*qt.children_)[i], value, value_hitbox, func);
+		}
+	}
+}
+
+template<typename T,quadtree_dynamics D, template <typename...> typename Container, typename Coord>
+auto quadtree<T,D,Container,Coord>::raycast(const point& from, const point& to) noexcept -> iterator {
+	return raycast_if(from, to, [](auto&&) { return true; });
+}
+
+template<typename T,quadtree_dynamics D, template <typename...> typename Container, typename Coord>
+auto quadtree<T,D,Container,Coord>::raycast(const point& from, const point& to) const noexcept -> const_iterator {
+	return raycast_if(from, to, [](auto&&) { return true; });
+}
+
+template<typename T,quadtree_dynamics D, template <typename...> typename Container, typename Coord>
+template <typename FuncT>
+auto quadtree<T,D,Container,Coord>::raycast_if(const point& from, const point& to, FuncT&& pred) noexcept(std::is_nothrow_invocable_v<FuncT, T&>) -> iterator {
+	float closest = std::numeric_limits<float>::infinity();
+	return raycast_impl<iterator>(*this, from, to, pred, closest);
+}
+
+template<typename T,quadtree_dynamics D, template <typename...> typename Container, typename Coord>
+template <typename FuncT>
+auto quadtree<T,D,Container,Coord>::raycast_if(const point& from, const point& to, FuncT&& pred) const noexcept(std::is_nothrow_invocable_v<FuncT, const T&>) -> const_iterator {
+	float closest = std::numeric_limits<float>::infinity();
+	return raycast_impl<const_iterator>(*this, from, to, pred, closest);
+}
+
+template<typename T,quadtree_dynamics D, template <typename...> typename Container, typename Coord>
+template <typename IteratorType, typename QuadTree, typename FuncT>
+IteratorType quadtree<T,D,Container,Coord>::raycast_impl(QuadTree& qt, const point& from, const point& to, FuncT& pred, float& closest) {
+	qt.visits_.add();
+	const float entry = qt.area_.segment_entry(from, to);
+	if (entry < 0.f || entry >= closest) {
+		return {};
+	}
+
+	IteratorType it{qt};
+	bool hit = false;
+	for (size_type idx = 0 ; idx < qt.values_.size() ; ++idx) {
+		const float val_entry = qt.hitboxes_[idx].segment_entry(from, to);
+		if (val_entry >= 0.f && val_entry < closest) {
+			auto val = std::next(qt.values_.begin(), static_cast<difference_type>(idx));
+			if (pred(*val)) {
+				closest = val_entry;
+				it.current_ = val;
+				hit = true;
+			}
+		}
+	}
+
+	if (qt.children_) {
+		// children are walked front to back, so that farther ones are usually skipped
+		std::array<std::pair<float, unsigned>, 4> order{};
+		for (auto i = 0u ; i < 4 ; ++i) {
+			order[i] = {(*qt.children_)[i].area_.segment_entry(from, to), i};
+		}
+		std::sort(order.begin(), order.end());
+
+		for (const auto& [child_entry, i] : order) {
+			if (child_entry < 0.f) {
+				continue;
+			}
+			if (child_entry >= closest) {
+				break;
+			}
+			IteratorType child_hit = raycast_impl<IteratorType>((*qt.children_)[i], from, to, pred, closest);
+			if (child_hit != IteratorType{}) {
+				it.current_ = qt.values_.end();
+				it.child_it_->first = i + 1;
+				it.child_it_->second = std::move(child_hit);
+				hit = true;
+			}
+		}
+	}
+
+	if (!hit) {
+		return {};
+	}
+	return it;
+}
+
+template<typename T,quadtree_dynamics D, template <typename...> typename Container, typename Coord>
+auto quadtree<T, D, Container, Coord>::find_dir(const area& target) const -> dirs {
 
 	if (center_.x < target.top_left.x) {
 		if (center_.y < target.top_left.y) {
@@ -554,17 +747,16 @@ auto quadtree<T, D, Container>::find_dir(const area& target) const -> dirs {
 	return dirs::none;
 }
 
-template<typename T,quadtree_dynamics D, template <typename...> typename Container>
+template<typename T,quadtree_dynamics D, template <typename...> typename Container, typename Coord>
 template <typename IteratorType>
-IteratorType quadtree<T, D, Container>::erase_impl(IteratorType it) {
+IteratorType quadtree<T, D, Container, Coord>::erase_impl(IteratorType it) {
 	assert(it.qt_ == this);
 
 	if (it.current_ != values_.end()) {
 		if (it.current_ + 1 != values_.end()) {
-			*it.current_ = std::move_if_noexcept(values_.back());
-			values_.pop_back();
+			erase_value_at(static_cast<size_type>(it.current_ - values_.begin()));
 		} else {
-			values_.pop_back();
+			erase_value_at(values_.size() - 1);
 			it.current_ = values_.end();
 		}
 
@@ -585,35 +777,33 @@ IteratorType quadtree<T, D, Container>::erase_impl(IteratorType it) {
 }
 
 #define DUNGEEP_QTREE_VISIT_IMPL(iterator_type, target, visitor) \
+	visits_.add(); \
 	if (!target.collides_with(this->area_)) { \
 		return; \
 	} \
 	\
 	{ \
 		iterator_type it{*this}; \
-		while (it.current_ != this->values_.end()) { \
-			if (target.collides_with(it->hitbox())) { \
-				/* if non const context AND visitor returns a boolean */\
-				if constexpr (std::is_same_v<iterator_type, iterator>) { \
-                    if constexpr (std::is_same_v<std::invoke_result_t<FuncT, iterator>, bool>) { \
-                        if (visitor(it)) { \
-                            if (it.current_ + 1 != this->values_.end()) { \
-                                *it.current_ = this->values_.back(); \
-                                this->values_.pop_back(); \
-                            } else { \
-                                this->values_.pop_back(); \
-                                it.current_ = values_.end(); /* it is otherwise invalid and thus cannot be safely compared to .end() */ \
-                            } \
-                            continue; \
-                        } \
-                    } else { \
-                        visitor(it); \
+		/* hitboxes are tested from hitboxes_, values are only dereferenced by the visitor, on a hit */ \
+		auto idx = this->hitboxes_.find_collision(target, 0); \
+		while (idx < this->values_.size()) { \
+			it.current_ = std::next(this->values_.begin(), static_cast<difference_type>(idx)); \
+			/* if non const context AND visitor returns a boolean */\
+			if constexpr (std::is_same_v<iterator_type, iterator>) { \
+                if constexpr (std::is_same_v<std::invoke_result_t<FuncT, iterator>, bool>) { \
+                    if (visitor(it)) { \
+                        /* last value is moved to idx, which thus needs to be tested again */ \
+                        this->erase_value_at(idx); \
+                        idx = this->hitboxes_.find_collision(target, idx); \
+                        continue; \
                     } \
-				} else { \
-					visitor(it); \
-				} \
+                } else { \
+                    visitor(it); \
+                } \
+			} else { \
+				visitor(it); \
 			} \
-			++it; \
+			idx = this->hitboxes_.find_collision(target, idx + 1); \
 		} \
 	} \
 	\
@@ -623,51 +813,89 @@ IteratorType quadtree<T, D, Container>::erase_impl(IteratorType it) {
 		} \
 	}
 
-template<typename T,quadtree_dynamics D, template <typename...> typename Container>
+template<typename T,quadtree_dynamics D, template <typename...> typename Container, typename Coord>
 template <typename FuncT>
-std::enable_if_t<std::is_invocable_v<FuncT, typename quadtree<T,D,Container>::iterator>>
-quadtree<T, D, Container>::visit(const area& target, FuncT&& visitor) noexcept(std::is_nothrow_invocable_v<FuncT, iterator>) {
+std::enable_if_t<std::is_invocable_v<FuncT, typename quadtree<T,D,Container,Coord>::iterator>>
+quadtree<T, D, Container, Coord>::visit(const area& target, FuncT&& visitor) noexcept(std::is_nothrow_invocable_v<FuncT, iterator>) {
 	DUNGEEP_QTREE_VISIT_IMPL(iterator, target, visitor);
 }
 
-template<typename T,quadtree_dynamics D, template <typename...> typename Container>
+template<typename T,quadtree_dynamics D, template <typename...> typename Container, typename Coord>
 template <typename FuncT>
-std::enable_if_t<std::is_invocable_v<FuncT, typename quadtree<T,D,Container>::const_iterator>>
-quadtree<T, D, Container>::visit(const area& target, FuncT&& visitor) const noexcept(std::is_nothrow_invocable_v<FuncT, const_iterator>) {
+std::enable_if_t<std::is_invocable_v<FuncT, typename quadtree<T,D,Container,Coord>::const_iterator>>
+quadtree<T, D, Container, Coord>::visit(const area& target, FuncT&& visitor) const noexcept(std::is_nothrow_invocable_v<FuncT, const_iterator>) {
 	DUNGEEP_QTREE_VISIT_IMPL(const_iterator, target, visitor)
 }
 
 #undef DUNGEEP_QTREE_VISIT_IMPL
 
-template<typename T, quadtree_dynamics Dynamicity, template <typename...> typename Container>
-void quadtree<T, Dynamicity, Container>::create_children() {
+template<typename T,quadtree_dynamics D, template <typename...> typename Container, typename Coord>
+template <typename FuncT>
+void quadtree<T, D, Container, Coord>::parallel_visit(const area& target, FuncT&& visitor, thread_pool& pool) const {
+	thread_pool::task_group group;
+	parallel_visit_impl(target, visitor, pool, group);
+	pool.wait(group);
+}
+
+template<typename T,quadtree_dynamics D, template <typename...> typename Container, typename Coord>
+template <typename FuncT>
+void quadtree<T, D, Container, Coord>::parallel_visit_impl(const area& target, FuncT& visitor, thread_pool& pool, thread_pool::task_group& group) const {
+	if (!target.collides_with(area_)) {
+		return;
+	}
+
+	if (!children_ || !is_large_query(target)) {
+		visit(target, visitor);
+		return;
+	}
+
+	// 'target', 'visitor' and 'group' outlive the tasks: parallel_visit waits for all of them
+	visits_.add();
+	for (auto i = 0u ; i < 4 ; ++i) {
+		pool.push(group, [&child = (*children_)[i], &target, &visitor, &pool, &group] {
+			child.parallel_visit_impl(target, visitor, pool, group);
+		});
+	}
+
+	const_iterator it{*this};
+	for (auto idx = hitboxes_.find_collision(target, 0) ; idx < values_.size() ; idx = hitboxes_.find_collision(target, idx + 1)) {
+		it.current_ = std::next(values_.begin(), static_cast<difference_type>(idx));
+		visitor(it);
+	}
+}
+
+template<typename T,quadtree_dynamics D, template <typename...> typename Container, typename Coord>
+bool quadtree<T, D, Container, Coord>::is_large_query(const area& target) const noexcept {
+	// splitting is worth it when the target covers at least a quarter of the node: most of the children will be walked anyway
+	const auto width = static_cast<float>(std::min(target.bot_right.x, area_.bot_right.x) - std::max(target.top_left.x, area_.top_left.x));
+	const auto height = static_cast<float>(std::min(target.bot_right.y, area_.bot_right.y) - std::max(target.top_left.y, area_.top_left.y));
+	return width * height * 4 >= static_cast<float>(area_.width()) * static_cast<float>(area_.height());
+}
+
+template<typename T, quadtree_dynamics Dynamicity, template <typename...> typename Container, typename Coord>
+void quadtree<T, Dynamicity, Container, Coord>::create_children() {
 	if constexpr (Dynamicity != quadtree_dynamics::static_children) {
 		if (!children_ && max_depth_ > 0) {
 			children_ = std::make_unique<children>(area_, max_depth_ - 1, max_size_);
 
-			auto it = values_.begin();
-			while (it != values_.end()) {
-				dirs dir = find_dir(it->hitbox());
+			size_type idx = 0;
+			while (idx < values_.size()) {
+				const area hitbox = hitboxes_[idx];
+				dirs dir = find_dir(hitbox);
 				if (dir != dirs::none) {
-					(*children_)[dir].emplace(it->hitbox(), std::move_if_noexcept(*it));
-					if (it + 1 != values_.end()) {
-						*it = std::move_if_noexcept(values_.back());
-						values_.pop_back();
-					} else {
-						values_.pop_back();
-						it = values_.end(); // it is otherwise invalid and thus cannot be safely compared to .end()
-					}
+					(*children_)[dir].emplace(hitbox, std::move_if_noexcept(*std::next(values_.begin(), static_cast<difference_type>(idx))));
+					erase_value_at(idx);
 				} else {
-					++it;
+					++idx;
 				}
 			}
 		}
 	}
 }
 
-template<typename T, quadtree_dynamics Dynamicity, template <typename...> typename Container>
+template<typename T, quadtree_dynamics Dynamicity, template <typename...> typename Container, typename Coord>
 template<typename IteratorType>
-void quadtree<T, Dynamicity, Container>::delete_children(IteratorType& it) {
+void quadtree<T, Dynamicity, Container, Coord>::delete_children(IteratorType& it) {
 	if constexpr (Dynamicity == quadtree_dynamics::dynamic_children) {
 		if (!children_ || values_.size() > max_size_ / 3) {
 			return;
@@ -684,30 +912,27 @@ void quadtree<T, Dynamicity, Container>::delete_children(IteratorType& it) {
 	}
 }
 
-template<typename T, quadtree_dynamics Dynamicity, template <typename...> typename Container>
-T quadtree<T, Dynamicity, Container>::extract(iterator element) {
+template<typename T, quadtree_dynamics Dynamicity, template <typename...> typename Container, typename Coord>
+T quadtree<T, Dynamicity, Container, Coord>::extract(iterator element) {
 	return extract_impl(element);
 }
 
 
-template<typename T, quadtree_dynamics Dynamicity, template <typename...> typename Container>
-T quadtree<T, Dynamicity, Container>::extract(const_iterator element) {
+template<typename T, quadtree_dynamics Dynamicity, template <typename...> typename Container, typename Coord>
+T quadtree<T, Dynamicity, Container, Coord>::extract(const_iterator element) {
 	return extract_impl(element);
 }
 
-template<typename T, quadtree_dynamics Dynamicity, template <typename...> typename Container>
+template<typename T, quadtree_dynamics Dynamicity, template <typename...> typename Container, typename Coord>
 template<typename IteratorType>
-T quadtree<T, Dynamicity, Container>::extract_impl(IteratorType element) {
+T quadtree<T, Dynamicity, Container, Coord>::extract_impl(IteratorType element) {
 	IteratorType* runner = &element;
 	while (runner->current_ == runner->qt_->values_.end()) {
 		runner = &runner->child_it_->second;
 	}
 
 	T return_value = std::move_if_noexcept(*runner->current_);
-	if (runner->current_ + 1 != runner->qt_->values_.end()) {
-		*runner->current_ = runner->qt_->values_.back();
-	}
-	runner->qt_->values_.pop_back();
+	runner->qt_->erase_value_at(static_cast<size_type>(runner->current_ - runner->qt_->values_.begin()));
 
 	IteratorType null_it{};
 	delete_children(null_it);
@@ -716,7 +941,7 @@ T quadtree<T, Dynamicity, Container>::extract_impl(IteratorType element) {
 }
 
 #define DUNGEEP_QTREE_FIND_IMPL(iterator_type) \
-	dirs dir = find_dir(element.hitbox()); \
+	dirs dir = children_ ? find_dir(element.hitbox()) : dirs::none; \
 	\
 	iterator_type it{*this}; \
 	if (dir == dirs::none) { \
@@ -731,63 +956,190 @@ T quadtree<T, Dynamicity, Container>::extract_impl(IteratorType element) {
 	} \
 	return it; \
 
-template<typename T, quadtree_dynamics Dynamicity, template <typename...> typename Container>
-auto quadtree<T, Dynamicity, Container>::find(const T& element) noexcept -> iterator {
+template<typename T, quadtree_dynamics Dynamicity, template <typename...> typename Container, typename Coord>
+auto quadtree<T, Dynamicity, Container, Coord>::find(const T& element) noexcept -> iterator {
 	DUNGEEP_QTREE_FIND_IMPL(iterator)
 }
 
-template<typename T, quadtree_dynamics Dynamicity, template <typename...> typename Container>
-auto quadtree<T, Dynamicity, Container>::find(const T& element) const noexcept -> const_iterator {
+template<typename T, quadtree_dynamics Dynamicity, template <typename...> typename Container, typename Coord>
+auto quadtree<T, Dynamicity, Container, Coord>::find(const T& element) const noexcept -> const_iterator {
 	DUNGEEP_QTREE_FIND_IMPL(const_iterator)
 }
 
 #undef DUNGEEP_QTREE_FIND_IMPL
 
-template<typename T, quadtree_dynamics Dynamicity, template <typename...> typename Container>
-void quadtree<T, Dynamicity, Container>::move(iterator it, const area& new_area) {
+template<typename T, quadtree_dynamics Dynamicity, template <typename...> typename Container, typename Coord>
+void quadtree<T, Dynamicity, Container, Coord>::move(iterator it, const area& new_area) {
 	move_impl(it, new_area);
 }
 
-template<typename T, quadtree_dynamics Dynamicity, template <typename...> typename Container>
-void quadtree<T, Dynamicity, Container>::move(const T& element, const area& new_area) {
+template<typename T, quadtree_dynamics Dynamicity, template <typename...> typename Container, typename Coord>
+void quadtree<T, Dynamicity, Container, Coord>::move(const T& element, const area& new_area) {
 	iterator it = find(element);
 	if (it != this->end()) {
 		move_impl(it, new_area);
 	}
 }
 
-template<typename T, quadtree_dynamics Dynamicity, template <typename...> typename Container>
-void quadtree<T, Dynamicity, Container>::move(const_iterator it, const area& new_area) {
+template<typename T, quadtree_dynamics Dynamicity, template <typename...> typename Container, typename Coord>
+void quadtree<T, Dynamicity, Container, Coord>::move(const_iterator it, const area& new_area) {
 	move_impl(it, new_area);
 }
 
-template<typename T, quadtree_dynamics Dynamicity, template <typename...> typename Container>
+template<typename T, quadtree_dynamics Dynamicity, template <typename...> typename Container, typename Coord>
 template<typename Iterator>
-void quadtree<T, Dynamicity, Container>::move_impl(Iterator it, const area& new_area) {
-	if (!children_) {
-		// moving from this->values_ to this->values_
-		return;
-	}
+void quadtree<T, Dynamicity, Container, Coord>::move_impl(Iterator it, const area& new_area) {
+	const dirs new_area_dir = children_ ? find_dir(new_area) : dirs::none;
 
-	dirs new_area_dir = find_dir(new_area);
-	dirs current_area_dir = find_dir(it->hitbox());
-
-	if (current_area_dir == new_area_dir) {
+	if (it.current_ != values_.end()) {
+		if (new_area_dir == dirs::none) {
+			// moving from this->values_ to this->values_
+			it.current_->set_hitbox(new_area);
+			hitboxes_.set(static_cast<size_type>(it.current_ - values_.begin()), new_area);
+			return;
+		}
+	} else if (it.child_it_->first - 1 == new_area_dir) {
 		(*children_)[new_area_dir].move(it.child_it_->second, new_area);
 		return;
 	}
 
+	++relocations_;
 	T val = extract(it);
 	val.set_hitbox(new_area);
 	emplace(new_area, std::move_if_noexcept(val));
 }
 
+template<typename T, quadtree_dynamics Dynamicity, template <typename...> typename Container, typename Coord>
+quadtree_stats quadtree<T, Dynamicity, Container, Coord>::stats() const {
+	quadtree_stats stats{};
+	stats.allocated_bytes = sizeof(*this);
+	stats.query_count = visits_.get();
+	collect_stats(stats, 0);
+	return stats;
+}
+
+template<typename T, quadtree_dynamics Dynamicity, template <typename...> typename Container, typename Coord>
+void quadtree<T, Dynamicity, Container, Coord>::reset_stats() noexcept {
+	visits_.reset();
+	if (children_) {
+		for (auto i = 0u ; i < 4 ; ++i) {
+			(*children_)[i].reset_stats();
+		}
+	}
+}
+
+template<typename T, quadtree_dynamics Dynamicity, template <typename...> typename Container, typename Coord>
+void quadtree<T, Dynamicity, Container, Coord>::adapt(const quadtree_tuning& tuning) {
+	if constexpr (Dynamicity != quadtree_dynamics::static_children) {
+		for (size_type budget = tuning.node_budget ; budget > 0 ; --budget) {
+			// the tree may have changed since the cursor was set: it is followed as far as possible
+			quadtree* node = this;
+			size_type depth = 0;
+			while (depth < adapt_cursor_.size() && node->children_) {
+				node = &(*node->children_)[adapt_cursor_[depth++]];
+			}
+			adapt_cursor_.resize(depth);
+
+			node->adapt_node(tuning, depth);
+
+			// next node, in pre-order
+			if (node->children_) {
+				adapt_cursor_.push_back(0);
+				continue;
+			}
+			while (!adapt_cursor_.empty() && adapt_cursor_.back() == 3) {
+				adapt_cursor_.pop_back();
+			}
+			if (adapt_cursor_.empty()) {
+				// the whole tree was examined: the next call starts over from the root
+				return;
+			}
+			++adapt_cursor_.back();
+		}
+	}
+}
+
+template<typename T, quadtree_dynamics Dynamicity, template <typename...> typename Container, typename Coord>
+void quadtree<T, Dynamicity, Container, Coord>::adapt_node(const quadtree_tuning& tuning, size_type depth) {
+	const std::uint64_t visits = visits_.get() - adapt_visits_;
+	const std::uint64_t query_cost = visits * values_.size();
+	const std::uint64_t move_cost = relocations_ * tuning.move_cost;
+
+	if (query_cost > tuning.split_cost && query_cost > move_cost) {
+		max_size_ = std::max(max_size_ / 2, tuning.min_size);
+		if (depth + max_depth_ < tuning.max_depth) {
+			++max_depth_;
+		}
+		if (!children_ && values_.size() > max_size_) {
+			create_children();
+		}
+	} else if (children_ && (move_cost > query_cost || subtree_cost(tuning) < tuning.merge_cost)) {
+		max_size_ = std::min(max_size_ * 2, tuning.max_size);
+		if constexpr (Dynamicity == quadtree_dynamics::dynamic_children) {
+			if (size() <= max_size_) {
+				merge_children();
+			}
+		}
+	}
+
+	adapt_visits_ = visits_.get();
+	relocations_ = 0;
+}
+
+template<typename T, quadtree_dynamics Dynamicity, template <typename...> typename Container, typename Coord>
+std::uint64_t quadtree<T, Dynamicity, Container, Coord>::subtree_cost(const quadtree_tuning& tuning) const noexcept {
+	std::uint64_t cost = (visits_.get() - adapt_visits_) * values_.size() + relocations_ * tuning.move_cost;
+	if (children_) {
+		for (auto i = 0u ; i < 4 ; ++i) {
+			cost += (*children_)[i].subtree_cost(tuning);
+		}
+	}
+	return cost;
+}
+
+template<typename T, quadtree_dynamics Dynamicity, template <typename...> typename Container, typename Coord>
+void quadtree<T, Dynamicity, Container, Coord>::merge_children() {
+	if (!children_) {
+		return;
+	}
+	for (auto i = 0u ; i < 4 ; ++i) {
+		quadtree& child = (*children_)[i];
+		child.merge_children();
+		for (size_type idx = 0 ; idx < child.values_.size() ; ++idx) {
+			values_.push_back(std::move_if_noexcept(*std::next(child.values_.begin(), static_cast<difference_type>(idx))));
+			hitboxes_.push_back(child.hitboxes_[idx]);
+		}
+	}
+	children_.reset();
+}
+
+template<typename T, quadtree_dynamics Dynamicity, template <typename...> typename Container, typename Coord>
+void quadtree<T, Dynamicity, Container, Coord>::collect_stats(quadtree_stats& stats, size_type depth) const {
+	if (stats.nodes_per_depth.size() <= depth) {
+		stats.nodes_per_depth.resize(depth + 1, 0);
+		stats.elements_per_depth.resize(depth + 1, 0);
+	}
+	++stats.node_count;
+	++stats.nodes_per_depth[depth];
+	stats.elements_per_depth[depth] += values_.size();
+	stats.visited_nodes += visits_.get();
+	stats.allocated_bytes += values_.capacity() * sizeof(value_type) + hitboxes_.allocated_bytes();
+
+	if (children_) {
+		stats.interior_elements += values_.size();
+		stats.allocated_bytes += sizeof(children); // includes the children themselves
+		for (auto i = 0u ; i < 4 ; ++i) {
+			(*children_)[i].collect_stats(stats, depth + 1);
+		}
+	}
+}
+
 
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-template<typename T, quadtree_dynamics Dynamicity, template <typename...> typename Container>
-quadtree<T, Dynamicity, Container>::children::children(const area& shared_area, size_type max_depth, size_type max_size)
+template<typename T, quadtree_dynamics Dynamicity, template <typename...> typename Container, typename Coord>
+quadtree<T, Dynamicity, Container, Coord>::children::children(const area& shared_area, size_type max_depth, size_type max_size)
 	: children_{{
         {split_from_indexed_dir(shared_area, 0), max_depth, max_size},
         {split_from_indexed_dir(shared_area, 1), max_depth, max_size},
@@ -795,8 +1147,8 @@ quadtree<T, Dynamicity, Container>::children::children(const area& shared_area,
         {split_from_indexed_dir(shared_area, 3), max_depth, max_size}}}
 {}
 
-template<typename T, quadtree_dynamics Dynamicity, template <typename...> typename Container>
-auto quadtree<T, Dynamicity, Container>::children::split_from_indexed_dir(const area& shared, int dir) -> area {
+template<typename T, quadtree_dynamics Dynamicity, template <typename...> typename Container, typename Coord>
+auto quadtree<T, Dynamicity, Container, Coord>::children::split_from_indexed_dir(const area& shared, int dir) -> area {
 
 	const point center = (shared.top_left + shared.bot_right) / 2;
 	const point& top_left = shared.top_left;
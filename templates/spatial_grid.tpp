@@ -0,0 +1,637 @@
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///                                                                                                                                     ///
+///  Copyright C 2019, Lucas Lazare                                                                                                     ///
+///  Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation         ///
+///  		files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy,  ///
+///  modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software     ///
+///  		is furnished to do so, subject to the following conditions:                                                                 ///
+///                                                                                                                                     ///
+///  The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.     ///
+///                                                                                                                                     ///
+///  The Software is provided “as is”, without warranty of any kind, express or implied, including but not limited to the               ///
+///  warranties of merchantability, fitness for a particular purpose and noninfringement. In no event shall the authors or              ///
+///  copyright holders be liable for any claim, damages or other liability, whether in an action of contract, tort or otherwise,        ///
+///  arising from, out of or in connection with the software or the use or other dealings in the Software.                              ///
+///                                                                                                                                     ///
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <cassert>
+#include <cmath>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <algorithm>
+#include <limits>
+
+namespace dungeep {
+
+template <typename T, template <typename...> typename C, typename Coord>
+template <typename Grid, typename Value, typename SubIterator>
+struct spatial_grid<T,C,Coord>::iterator_type {
+
+	using difference_type = std::ptrdiff_t;
+	using value_type = Value;
+	using pointer = Value*;
+	using reference = Value&;
+	using iterator_category = std::bidirectional_iterator_tag;
+
+	iterator_type() noexcept : grid_{nullptr}, cell_{0}, current_{} {}
+
+	explicit iterator_type(Grid& grid) noexcept : grid_{&grid}, cell_{0}, current_{grid.cells_.front().values.begin()} {
+		skip_empty_cells();
+	}
+
+	iterator_type(Grid& grid, std::size_t cell, SubIterator current) noexcept : grid_{&grid}, cell_{cell}, current_{current} {}
+
+	iterator_type operator++(int) noexcept {
+		iterator_type tmp(*this);
+		++*this;
+		return tmp;
+	}
+
+	iterator_type& operator++() noexcept {
+		assert(!is_at_end());
+		++current_;
+		skip_empty_cells();
+		return *this;
+	}
+
+	iterator_type operator--(int) noexcept {
+		iterator_type tmp(*this);
+		--*this;
+		return tmp;
+	}
+
+	iterator_type& operator--() noexcept {
+		assert(grid_);
+		while (cell_ == grid_->cells_.size() || current_ == grid_->cells_[cell_].values.begin()) {
+			assert(cell_ > 0);
+			--cell_;
+			current_ = grid_->cells_[cell_].values.end();
+		}
+		--current_;
+		return *this;
+	}
+
+	// end == end, end == {}
+	bool operator==(const iterator_type& other) const noexcept {
+		if (is_at_end() || other.is_at_end()) {
+			return is_at_end() && other.is_at_end();
+		}
+		return grid_ == other.grid_ && cell_ == other.cell_ && current_ == other.current_;
+	}
+
+	bool operator!=(const iterator_type& other) const noexcept {
+		return !(*this == other);
+	}
+
+	Value& operator*() const noexcept {
+		assert(!is_at_end());
+		return *current_;
+	}
+
+	Value* operator->() const noexcept {
+		assert(!is_at_end());
+		return &*current_;
+	}
+
+	bool is_at_end() const noexcept {
+		return grid_ == nullptr || cell_ == grid_->cells_.size();
+	}
+
+private:
+	friend spatial_grid<T,C,Coord>;
+
+	void skip_empty_cells() noexcept {
+		while (current_ == grid_->cells_[cell_].values.end()) {
+			if (++cell_ == grid_->cells_.size()) {
+				return;
+			}
+			current_ = grid_->cells_[cell_].values.begin();
+		}
+	}
+
+	Grid* grid_;
+	std::size_t cell_;
+	SubIterator current_;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename T, template <typename...> typename Container, typename Coord>
+spatial_grid<T, Container, Coord>::spatial_grid(const area& ar, float cell_size)
+	: area_{ar}
+	, cell_size_{cell_size}
+	, columns_{std::max(static_cast<size_type>(std::ceil(static_cast<float>(ar.width()) / cell_size)), size_type{1})}
+	, rows_{std::max(static_cast<size_type>(std::ceil(static_cast<float>(ar.height()) / cell_size)), size_type{1})}
+	, cells_(columns_ * rows_)
+{
+	assert(cell_size > 0.f);
+}
+
+template <typename T, template <typename...> typename Container, typename Coord>
+auto spatial_grid<T, Container, Coord>::begin() noexcept -> iterator {
+	return iterator{*this};
+}
+
+template <typename T, template <typename...> typename Container, typename Coord>
+auto spatial_grid<T, Container, Coord>::begin() const noexcept -> const_iterator {
+	return const_iterator{*this};
+}
+
+template <typename T, template <typename...> typename Container, typename Coord>
+auto spatial_grid<T, Container, Coord>::cbegin() const noexcept -> const_iterator {
+	return const_iterator{*this};
+}
+
+template <typename T, template <typename...> typename Container, typename Coord>
+auto spatial_grid<T, Container, Coord>::end() noexcept -> iterator {
+	return iterator{};
+}
+
+template <typename T, template <typename...> typename Container, typename Coord>
+auto spatial_grid<T, Container, Coord>::end() const noexcept -> const_iterator {
+	return const_iterator{};
+}
+
+template <typename T, template <typename...> typename Container, typename Coord>
+auto spatial_grid<T, Container, Coord>::cend() const noexcept -> const_iterator {
+	return const_iterator{};
+}
+
+template <typename T, template <typename...> typename Container, typename Coord>
+auto spatial_grid<T, Container, Coord>::insert(const value_type& value) -> iterator {
+	return emplace(value.hitbox(), value);
+}
+
+template <typename T, template <typename...> typename Container, typename Coord>
+template <typename... Args>
+auto spatial_grid<T, Container, Coord>::emplace(const area& target, Args&&... args) -> iterator {
+	const size_type cell_idx = cell_of(target);
+	cell& c = cells_[cell_idx];
+	c.values.emplace_back(std::forward<Args>(args)...);
+	c.hitboxes.push_back(target);
+
+	max_extent_.x = std::max(max_extent_.x, target.width());
+	max_extent_.y = std::max(max_extent_.y, target.height());
+	++size_;
+
+	return {*this, cell_idx, std::prev(c.values.end())};
+}
+
+template <typename T, template <typename...> typename Container, typename Coord>
+template <typename FuncT>
+std::enable_if_t<std::is_invocable_v<FuncT, typename spatial_grid<T, Container, Coord>::iterator>>
+spatial_grid<T, Container, Coord>::visit(const area& target, FuncT&& visitor) noexcept(std::is_nothrow_invocable_v<FuncT, iterator>) {
+	const cell_range range = cells_for(target);
+	count_query(range);
+	for (size_type row = range.min_y ; row <= range.max_y ; ++row) {
+		visit_row<iterator>(*this, range, row, target, visitor);
+	}
+}
+
+template <typename T, template <typename...> typename Container, typename Coord>
+template <typename FuncT>
+std::enable_if_t<std::is_invocable_v<FuncT, typename spatial_grid<T, Container, Coord>::const_iterator>>
+spatial_grid<T, Container, Coord>::visit(const area& target, FuncT&& visitor) const noexcept(std::is_nothrow_invocable_v<FuncT, const_iterator>) {
+	const cell_range range = cells_for(target);
+	count_query(range);
+	for (size_type row = range.min_y ; row <= range.max_y ; ++row) {
+		visit_row<const_iterator>(*this, range, row, target, visitor);
+	}
+}
+
+template <typename T, template <typename...> typename Container, typename Coord>
+template <typename FuncT>
+void spatial_grid<T, Container, Coord>::parallel_visit(const area& target, FuncT&& visitor, thread_pool& pool) const {
+	const cell_range range = cells_for(target);
+	if (!is_large_query(range)) {
+		visit(target, visitor);
+		return;
+	}
+	count_query(range);
+
+	thread_pool::task_group group;
+	for (size_type row = range.min_y ; row <= range.max_y ; ++row) {
+		pool.push(group, [this, &range, row, &target, &visitor] {
+			visit_row<const_iterator>(*this, range, row, target, visitor);
+		});
+	}
+	pool.wait(group);
+}
+
+template <typename T, template <typename...> typename Container, typename Coord>
+bool spatial_grid<T, Container, Coord>::empty() const noexcept {
+	return size_ == 0;
+}
+
+template <typename T, template <typename...> typename Container, typename Coord>
+auto spatial_grid<T, Container, Coord>::size() const noexcept -> size_type {
+	return size_;
+}
+
+template <typename T, template <typename...> typename Container, typename Coord>
+void spatial_grid<T, Container, Coord>::clear() noexcept(noexcept(container().clear())) {
+	for (cell& c : cells_) {
+		c.values.clear();
+		c.hitboxes.clear();
+	}
+	max_extent_ = {};
+	size_ = 0;
+}
+
+template <typename T, template <typename...> typename Container, typename Coord>
+auto spatial_grid<T, Container, Coord>::erase(iterator it) -> iterator {
+	return erase_impl(it);
+}
+
+template <typename T, template <typename...> typename Container, typename Coord>
+auto spatial_grid<T, Container, Coord>::erase(const_iterator it) -> iterator {
+	return erase_impl(it);
+}
+
+template <typename T, template <typename...> typename Container, typename Coord>
+void spatial_grid<T, Container, Coord>::erase(const T& t) {
+	iterator it = find(t);
+	if (it != end()) {
+		erase_impl(it);
+	}
+}
+
+template <typename T, template <typename...> typename Container, typename Coord>
+bool spatial_grid<T, Container, Coord>::has_collision(const area& ar) const noexcept {
+	return has_collision_if(ar, [](auto&&) { return true; });
+}
+
+template <typename T, template <typename...> typename Container, typename Coord>
+template <typename FuncT>
+bool spatial_grid<T, Container, Coord>::has_collision_if(const area& ar, FuncT&& pred) noexcept(std::is_nothrow_invocable_v<FuncT, T&>) {
+	const cell_range range = cells_for(ar);
+	count_query(range);
+	for (size_type row = range.min_y ; row <= range.max_y ; ++row) {
+		if (has_collision_in_row(*this, range, row, ar, pred)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+template <typename T, template <typename...> typename Container, typename Coord>
+template <typename FuncT>
+bool spatial_grid<T, Container, Coord>::has_collision_if(const area& ar, FuncT&& pred) const noexcept(std::is_nothrow_invocable_v<FuncT, const T&>) {
+	const cell_range range = cells_for(ar);
+	count_query(range);
+	for (size_type row = range.min_y ; row <= range.max_y ; ++row) {
+		if (has_collision_in_row(*this, range, row, ar, pred)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+template <typename T, template <typename...> typename Container, typename Coord>
+template <typename FuncT>
+bool spatial_grid<T, Container, Coord>::parallel_has_collision_if(const area& ar, FuncT&& pred, thread_pool& pool) const {
+	const cell_range range = cells_for(ar);
+	if (!is_large_query(range)) {
+		return has_collision_if(ar, pred);
+	}
+	count_query(range);
+
+	std::atomic<bool> found{false};
+	auto until_found = [&found, &pred](const T& value) {
+		return found.load(std::memory_order_relaxed) || pred(value);
+	};
+
+	thread_pool::task_group group;
+	for (size_type row = range.min_y ; row <= range.max_y ; ++row) {
+		pool.push(group, [this, &range, row, &ar, &until_found, &found] {
+			if (!found.load(std::memory_order_relaxed) && has_collision_in_row(*this, range, row, ar, until_found)) {
+				found.store(true, std::memory_order_relaxed);
+			}
+		});
+	}
+	pool.wait(group);
+	return found.load(std::memory_order_relaxed);
+}
+
+template <typename T, template <typename...> typename Container, typename Coord>
+template <typename FuncT>
+void spatial_grid<T, Container, Coord>::for_each_colliding_pair(FuncT&& func) noexcept(std::is_nothrow_invocable_v<FuncT, T&, T&>) {
+	colliding_pairs_impl(*this, func);
+}
+
+template <typename T, template <typename...> typename Container, typename Coord>
+template <typename FuncT>
+void spatial_grid<T, Container, Coord>::for_each_colliding_pair(FuncT&& func) const noexcept(std::is_nothrow_invocable_v<FuncT, const T&, const T&>) {
+	colliding_pairs_impl(*this, func);
+}
+
+template <typename T, template <typename...> typename Container, typename Coord>
+auto spatial_grid<T, Container, Coord>::raycast(const point& from, const point& to) noexcept -> iterator {
+	return raycast_if(from, to, [](auto&&) { return true; });
+}
+
+template <typename T, template <typename...> typename Container, typename Coord>
+auto spatial_grid<T, Container, Coord>::raycast(const point& from, const point& to) const noexcept -> const_iterator {
+	return raycast_if(from, to, [](auto&&) { return true; });
+}
+
+template <typename T, template <typename...> typename Container, typename Coord>
+template <typename FuncT>
+auto spatial_grid<T, Container, Coord>::raycast_if(const point& from, const point& to, FuncT&& pred) noexcept(std::is_nothrow_invocable_v<FuncT, T&>) -> iterator {
+	return raycast_impl<iterator>(*this, from, to, pred);
+}
+
+template <typename T, template <typename...> typename Container, typename Coord>
+template <typename FuncT>
+auto spatial_grid<T, Container, Coord>::raycast_if(const point& from, const point& to, FuncT&& pred) const noexcept(std::is_nothrow_invocable_v<FuncT, const T&>) -> const_iterator {
+	return raycast_impl<const_iterator>(*this, from, to, pred);
+}
+
+template <typename T, template <typename...> typename Container, typename Coord>
+T spatial_grid<T, Container, Coord>::extract(iterator element) {
+	return extract_impl(element);
+}
+
+template <typename T, template <typename...> typename Container, typename Coord>
+T spatial_grid<T, Container, Coord>::extract(const_iterator element) {
+	return extract_impl(element);
+}
+
+template <typename T, template <typename...> typename Container, typename Coord>
+auto spatial_grid<T, Container, Coord>::find(const T& element) noexcept -> iterator {
+	return find_impl<iterator>(*this, element);
+}
+
+template <typename T, template <typename...> typename Container, typename Coord>
+auto spatial_grid<T, Container, Coord>::find(const T& element) const noexcept -> const_iterator {
+	return find_impl<const_iterator>(*this, element);
+}
+
+template <typename T, template <typename...> typename Container, typename Coord>
+void spatial_grid<T, Container, Coord>::move(iterator it, const area& new_area) {
+	move_impl(it, new_area);
+}
+
+template <typename T, template <typename...> typename Container, typename Coord>
+void spatial_grid<T, Container, Coord>::move(const T& element, const area& new_area) {
+	iterator it = find(element);
+	if (it != end()) {
+		move_impl(it, new_area);
+	}
+}
+
+template <typename T, template <typename...> typename Container, typename Coord>
+void spatial_grid<T, Container, Coord>::move(const_iterator it, const area& new_area) {
+	move_impl(it, new_area);
+}
+
+template <typename T, template <typename...> typename Container, typename Coord>
+quadtree_stats spatial_grid<T, Container, Coord>::stats() const {
+	quadtree_stats stats{};
+	stats.node_count = cells_.size();
+	stats.nodes_per_depth = {cells_.size()};
+	stats.elements_per_depth = {size_};
+	stats.allocated_bytes = sizeof(*this) + cells_.capacity() * sizeof(cell);
+	for (const cell& c : cells_) {
+		stats.allocated_bytes += c.values.capacity() * sizeof(value_type) + c.hitboxes.allocated_bytes();
+	}
+	stats.query_count = queries_.get();
+	stats.visited_nodes = visited_cells_.get();
+	return stats;
+}
+
+template <typename T, template <typename...> typename Container, typename Coord>
+void spatial_grid<T, Container, Coord>::reset_stats() noexcept {
+	queries_.reset();
+	visited_cells_.reset();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename T, template <typename...> typename Container, typename Coord>
+auto spatial_grid<T, Container, Coord>::column_of(float x) const noexcept -> size_type {
+	const float column = (x - static_cast<float>(area_.top_left.x)) / cell_size_;
+	if (!(column > 0.f)) {
+		return 0;
+	}
+	return std::min(static_cast<size_type>(column), columns_ - 1);
+}
+
+template <typename T, template <typename...> typename Container, typename Coord>
+auto spatial_grid<T, Container, Coord>::row_of(float y) const noexcept -> size_type {
+	const float row = (y - static_cast<float>(area_.top_left.y)) / cell_size_;
+	if (!(row > 0.f)) {
+		return 0;
+	}
+	return std::min(static_cast<size_type>(row), rows_ - 1);
+}
+
+template <typename T, template <typename...> typename Container, typename Coord>
+auto spatial_grid<T, Container, Coord>::cell_of(const area& hitbox) const noexcept -> size_type {
+	return row_of(static_cast<float>(hitbox.top_left.y)) * columns_ + column_of(static_cast<float>(hitbox.top_left.x));
+}
+
+template <typename T, template <typename...> typename Container, typename Coord>
+auto spatial_grid<T, Container, Coord>::cells_for(const area& target) const noexcept -> cell_range {
+	// an element colliding with target has its top left corner within [target.top_left - max_extent_ ; target.bot_right]
+	// computed as floats, so that unsigned coordinates do not wrap around
+	return {
+		column_of(static_cast<float>(target.top_left.x) - static_cast<float>(max_extent_.x)),
+		row_of(static_cast<float>(target.top_left.y) - static_cast<float>(max_extent_.y)),
+		column_of(static_cast<float>(target.bot_right.x)),
+		row_of(static_cast<float>(target.bot_right.y))
+	};
+}
+
+template <typename T, template <typename...> typename Container, typename Coord>
+void spatial_grid<T, Container, Coord>::count_query(const cell_range& range) const noexcept {
+	queries_.add();
+	visited_cells_.add((range.max_y - range.min_y + 1) * (range.max_x - range.min_x + 1));
+}
+
+template <typename T, template <typename...> typename Container, typename Coord>
+bool spatial_grid<T, Container, Coord>::is_large_query(const cell_range& range) noexcept {
+	return range.max_y > range.min_y && (range.max_y - range.min_y + 1) * (range.max_x - range.min_x + 1) >= 64;
+}
+
+template <typename T, template <typename...> typename Container, typename Coord>
+void spatial_grid<T, Container, Coord>::erase_value_at(cell& c, size_type idx) {
+	assert(c.values.size() == c.hitboxes.size());
+	auto it = std::next(c.values.begin(), static_cast<difference_type>(idx));
+	if (it + 1 != c.values.end()) {
+		*it = std::move_if_noexcept(c.values.back());
+	}
+	c.values.pop_back();
+	c.hitboxes.erase_by_swap(idx);
+	--size_;
+}
+
+template <typename T, template <typename...> typename Container, typename Coord>
+template <typename IteratorType>
+auto spatial_grid<T, Container, Coord>::erase_impl(IteratorType it) -> iterator {
+	assert(!it.is_at_end());
+	cell& c = cells_[it.cell_];
+	const auto idx = static_cast<size_type>(it.current_ - c.values.begin());
+	erase_value_at(c, idx);
+
+	// the last value of the cell was moved to idx
+	iterator next{*this, it.cell_, std::next(c.values.begin(), static_cast<difference_type>(idx))};
+	next.skip_empty_cells();
+	return next;
+}
+
+template <typename T, template <typename...> typename Container, typename Coord>
+template <typename IteratorType>
+T spatial_grid<T, Container, Coord>::extract_impl(IteratorType element) {
+	assert(!element.is_at_end());
+	cell& c = cells_[element.cell_];
+	const auto idx = static_cast<size_type>(element.current_ - c.values.begin());
+	T return_value = std::move_if_noexcept(*std::next(c.values.begin(), static_cast<difference_type>(idx)));
+	erase_value_at(c, idx);
+	return return_value;
+}
+
+template <typename T, template <typename...> typename Container, typename Coord>
+template <typename IteratorType>
+void spatial_grid<T, Container, Coord>::move_impl(IteratorType it, const area& new_area) {
+	assert(!it.is_at_end());
+	const size_type new_cell = cell_of(new_area);
+	if (new_cell == it.cell_) {
+		cell& c = cells_[it.cell_];
+		const auto idx = static_cast<size_type>(it.current_ - c.values.begin());
+		auto value = std::next(c.values.begin(), static_cast<difference_type>(idx));
+		value->set_hitbox(new_area);
+		c.hitboxes.set(idx, new_area);
+		max_extent_.x = std::max(max_extent_.x, new_area.width());
+		max_extent_.y = std::max(max_extent_.y, new_area.height());
+		return;
+	}
+
+	T val = extract(it);
+	val.set_hitbox(new_area);
+	emplace(new_area, std::move_if_noexcept(val));
+}
+
+template <typename T, template <typename...> typename Container, typename Coord>
+template <typename IteratorType, typename Grid>
+IteratorType spatial_grid<T, Container, Coord>::find_impl(Grid& grid, const T& element) {
+	const size_type cell_idx = grid.cell_of(element.hitbox());
+	auto& values = grid.cells_[cell_idx].values;
+	auto it = std::find(values.begin(), values.end(), element);
+	if (it == values.end()) {
+		return {};
+	}
+	return {grid, cell_idx, it};
+}
+
+template <typename T, template <typename...> typename Container, typename Coord>
+template <typename IteratorType, typename Grid, typename FuncT>
+void spatial_grid<T, Container, Coord>::visit_row(Grid& grid, const cell_range& range, size_type row, const area& target, FuncT& visitor) {
+	for (size_type cell_idx = row * grid.columns_ + range.min_x ; cell_idx <= row * grid.columns_ + range.max_x ; ++cell_idx) {
+		auto& c = grid.cells_[cell_idx];
+
+		// hitboxes are tested from the cell's hitboxes, values are only dereferenced by the visitor, on a hit
+		auto idx = c.hitboxes.find_collision(target, 0);
+		while (idx < c.values.size()) {
+			IteratorType it{grid, cell_idx, std::next(c.values.begin(), static_cast<difference_type>(idx))};
+			// if non const context AND visitor returns a boolean
+			if constexpr (std::is_same_v<IteratorType, iterator>) {
+				if constexpr (std::is_same_v<std::invoke_result_t<FuncT, iterator>, bool>) {
+					if (visitor(it)) {
+						// last value is moved to idx, which thus needs to be tested again
+						grid.erase_value_at(c, idx);
+						idx = c.hitboxes.find_collision(target, idx);
+						continue;
+					}
+				} else {
+					visitor(it);
+				}
+			} else {
+				visitor(it);
+			}
+			idx = c.hitboxes.find_collision(target, idx + 1);
+		}
+	}
+}
+
+template <typename T, template <typename...> typename Container, typename Coord>
+template <typename Grid, typename FuncT>
+bool spatial_grid<T, Container, Coord>::has_collision_in_row(Grid& grid, const cell_range& range, size_type row, const area& ar, FuncT& pred) {
+	for (size_type cell_idx = row * grid.columns_ + range.min_x ; cell_idx <= row * grid.columns_ + range.max_x ; ++cell_idx) {
+		auto& c = grid.cells_[cell_idx];
+		for (auto idx = c.hitboxes.find_collision(ar, 0) ; idx < c.values.size() ; idx = c.hitboxes.find_collision(ar, idx + 1)) {
+			if (pred(*std::next(c.values.begin(), static_cast<difference_type>(idx)))) {
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+template <typename T, template <typename...> typename Container, typename Coord>
+template <typename Grid, typename FuncT>
+void spatial_grid<T, Container, Coord>::colliding_pairs_impl(Grid& grid, FuncT& func) {
+	// two colliding elements have their top left corners at most max_extent_ apart
+	const auto reach_x = static_cast<size_type>(std::ceil(static_cast<float>(grid.max_extent_.x) / grid.cell_size_));
+	const auto reach_y = static_cast<size_type>(std::ceil(static_cast<float>(grid.max_extent_.y) / grid.cell_size_));
+
+	for (size_type row = 0 ; row < grid.rows_ ; ++row) {
+		for (size_type column = 0 ; column < grid.columns_ ; ++column) {
+			auto& c = grid.cells_[row * grid.columns_ + column];
+
+			for (size_type i = 0 ; i < c.values.size() ; ++i) {
+				const area hitbox = c.hitboxes[i];
+				auto& value = *std::next(c.values.begin(), static_cast<difference_type>(i));
+
+				for (auto j = c.hitboxes.find_collision(hitbox, i + 1) ; j < c.values.size() ; j = c.hitboxes.find_collision(hitbox, j + 1)) {
+					func(value, *std::next(c.values.begin(), static_cast<difference_type>(j)));
+				}
+
+				// pairs with the previous cells were already reported from them
+				const size_type last_row = std::min(row + reach_y, grid.rows_ - 1);
+				const size_type first_column = column > reach_x ? column - reach_x : 0;
+				const size_type last_column = std::min(column + reach_x, grid.columns_ - 1);
+				for (size_type other_row = row ; other_row <= last_row ; ++other_row) {
+					for (size_type other_column = other_row == row ? column + 1 : first_column ; other_column <= last_column ; ++other_column) {
+						auto& other = grid.cells_[other_row * grid.columns_ + other_column];
+						for (auto j = other.hitboxes.find_collision(hitbox, 0) ; j < other.values.size() ; j = other.hitboxes.find_collision(hitbox, j + 1)) {
+							func(value, *std::next(other.values.begin(), static_cast<difference_type>(j)));
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+template <typename T, template <typename...> typename Container, typename Coord>
+template <typename IteratorType, typename Grid, typename FuncT>
+IteratorType spatial_grid<T, Container, Coord>::raycast_impl(Grid& grid, const point& from, const point& to, FuncT& pred) {
+	const area bounds{{std::min(from.x, to.x), std::min(from.y, to.y)}, {std::max(from.x, to.x), std::max(from.y, to.y)}};
+	const cell_range range = grid.cells_for(bounds);
+	grid.count_query(range);
+
+	IteratorType hit{};
+	float closest = std::numeric_limits<float>::infinity();
+	for (size_type row = range.min_y ; row <= range.max_y ; ++row) {
+		for (size_type cell_idx = row * grid.columns_ + range.min_x ; cell_idx <= row * grid.columns_ + range.max_x ; ++cell_idx) {
+			auto& c = grid.cells_[cell_idx];
+			for (size_type idx = 0 ; idx < c.values.size() ; ++idx) {
+				const float entry = c.hitboxes[idx].segment_entry(from, to);
+				if (entry >= 0.f && entry < closest) {
+					auto val = std::next(c.values.begin(), static_cast<difference_type>(idx));
+					if (pred(*val)) {
+						closest = entry;
+						hit = {grid, cell_idx, val};
+					}
+				}
+			}
+		}
+	}
+	return hit;
+}
+
+}
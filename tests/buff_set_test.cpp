@@ -0,0 +1,123 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///                                                                                                                                     ///
+///  Copyright C 2019, Lucas Lazare                                                                                                     ///
+///  Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation         ///
+///  		files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy,  ///
+///  modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software     ///
+///  		is furnished to do so, subject to the following conditions:                                                                 ///
+///                                                                                                                                     ///
+///  The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.     ///
+///                                                                                                                                     ///
+///  The Software is provided “as is”, without warranty of any kind, express or implied, including but not limited to the               ///
+///  warranties of merchantability, fitness for a particular purpose and noninfringement. In no event shall the authors or              ///
+///  copyright holders be liable for any claim, damages or other liability, whether in an action of contract, tort or otherwise,        ///
+///  arising from, out of or in connection with the software or the use or other dealings in the Software.                              ///
+///                                                                                                                                     ///
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <memory>
+#include <catch2/catch.hpp>
+#include <iconned/buff_set.hpp>
+
+namespace {
+
+	std::unique_ptr<fixed_effect> fixed_buff(int hp, int armor) {
+		return std::make_unique<fixed_effect>("fixed", fixed_effect::defense{hp, armor, 0}, fixed_effect::attack{0, 0, 0},
+		                                      fixed_effect::critics{0, 0}, fixed_effect::misc{0.f, 0, 0});
+	}
+
+	// divides the physical damages taken by 'divisor'
+	struct dividing_buff final : dynamic_effect {
+		dividing_buff(int armor, int divisor_)
+			: dynamic_effect("dividing", defense{0, armor, 0}, attack{0, 0, 0}, critics{0, 0}, misc{0.f, 0, 0})
+			, divisor{divisor_}
+		{}
+
+		int update_cooldown_once(int current_cooldown) noexcept override { return current_cooldown; }
+		int update_input_physical_damage(int input) noexcept override { return input / divisor; }
+		int update_input_magical_damage(int input) noexcept override { return input; }
+		int update_input_true_damage(int input) noexcept override { return input; }
+		int update_output_physical_damage(int input) noexcept override { return input; }
+		int update_output_magical_damage(int input) noexcept override { return input; }
+		int update_output_true_damage(int input) noexcept override { return input; }
+		int ignored_armor(int) noexcept override { return 0; }
+		int ignored_resist(int) noexcept override { return 0; }
+		void tick(player&, world_proxy&) noexcept override {}
+
+		unsigned int hooks() const noexcept override {
+			return effect_hook_bit(effect_hook::input_physical_damage);
+		}
+
+		int divisor;
+	};
+}
+
+TEST_CASE("Buff set") {
+	buff_set buffs;
+
+	SECTION("Bonuses") {
+		auto first = fixed_buff(10, 1);
+		fixed_effect* first_ptr = first.get();
+		buffs.add(std::move(first));
+		buffs.add(fixed_buff(5, 2));
+		buffs.add(std::make_unique<dividing_buff>(4, 2));
+		CHECK(buffs.size() == 3);
+		CHECK(buffs.bonuses().hp == 15);
+		CHECK(buffs.bonuses().armor == 7);
+
+		CHECK(buffs.remove(first_ptr));
+		CHECK(buffs.size() == 2);
+		CHECK(buffs.bonuses().hp == 5);
+		CHECK(buffs.bonuses().armor == 6);
+	}
+
+	SECTION("Removing an effect twice") {
+		auto fixed = fixed_buff(10, 1);
+		fixed_effect* fixed_ptr = fixed.get();
+		auto dynamic = std::make_unique<dividing_buff>(4, 2);
+		fixed_effect* dynamic_ptr = dynamic.get();
+		buffs.add(std::move(fixed));
+		buffs.add(std::move(dynamic));
+
+		CHECK(buffs.remove(fixed_ptr));
+		CHECK_FALSE(buffs.remove(fixed_ptr));
+		CHECK(buffs.remove(dynamic_ptr));
+		CHECK_FALSE(buffs.remove(dynamic_ptr));
+		CHECK(buffs.size() == 0);
+		CHECK(buffs.bonuses().hp == 0);
+		CHECK(buffs.bonuses().armor == 0);
+		CHECK(buffs.hooked(effect_hook::input_physical_damage).empty());
+	}
+
+	SECTION("Removing an effect that was never added") {
+		buffs.add(fixed_buff(10, 1));
+		auto stranger = fixed_buff(3, 3);
+		CHECK_FALSE(buffs.remove(stranger.get()));
+		CHECK(buffs.size() == 1);
+		CHECK(buffs.bonuses().hp == 10);
+		CHECK(buffs.bonuses().armor == 1);
+	}
+
+	SECTION("Hooks") {
+		auto halving = std::make_unique<dividing_buff>(0, 2);
+		dynamic_effect* halving_ptr = halving.get();
+		buffs.add(std::move(halving));
+		buffs.add(fixed_buff(1, 1));
+		buffs.add(std::make_unique<dividing_buff>(0, 3));
+
+		const auto& hooked = buffs.hooked(effect_hook::input_physical_damage);
+		REQUIRE(hooked.size() == 2);
+		CHECK(hooked[0] == halving_ptr);
+		CHECK(buffs.hooked(effect_hook::input_magical_damage).empty());
+
+		int damage = 60;
+		for (dynamic_effect* buff : hooked) {
+			damage = buff->update_input_physical_damage(damage);
+		}
+		CHECK(damage == 10);
+
+		CHECK(buffs.remove(halving_ptr));
+		REQUIRE(hooked.size() == 1);
+		CHECK(hooked[0]->update_input_physical_damage(60) == 20);
+	}
+}
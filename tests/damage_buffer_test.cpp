@@ -0,0 +1,143 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///                                                                                                                                     ///
+///  Copyright C 2019, Lucas Lazare                                                                                                     ///
+///  Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation         ///
+///  		files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy,  ///
+///  modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software     ///
+///  		is furnished to do so, subject to the following conditions:                                                                 ///
+///                                                                                                                                     ///
+///  The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.     ///
+///                                                                                                                                     ///
+///  The Software is provided “as is”, without warranty of any kind, express or implied, including but not limited to the               ///
+///  warranties of merchantability, fitness for a particular purpose and noninfringement. In no event shall the authors or              ///
+///  copyright holders be liable for any claim, damages or other liability, whether in an action of contract, tort or otherwise,        ///
+///  arising from, out of or in connection with the software or the use or other dealings in the Software.                              ///
+///                                                                                                                                     ///
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <environment/damage_buffer.hpp>
+
+namespace {
+	struct dummy {
+		std::uint32_t id;
+		int hp;
+		int armor;
+		int resist;
+
+		std::vector<std::pair<damage_type, int>> hooked{}; // what the buffs' hooks saw, in order
+		int health_losses{0};
+
+		[[nodiscard]] std::uint32_t entity_id() const noexcept {
+			return id;
+		}
+
+		// a buff doubling magical damages
+		int filter_input_damage(damage_type type, int damage) {
+			hooked.emplace_back(type, damage);
+			return type == damage_type::magical ? damage * 2 : damage;
+		}
+
+		[[nodiscard]] int defense_against(damage_type type) const noexcept {
+			return type == damage_type::magical ? resist : armor;
+		}
+
+		void lose_health(int amount) noexcept {
+			hp -= amount;
+			++health_losses;
+		}
+
+		[[nodiscard]] int get_hp() const noexcept {
+			return hp;
+		}
+	};
+
+	using dummy_buffer = basic_damage_buffer<dummy>;
+}
+
+TEST_CASE("Damage buffer") {
+
+	SECTION("Batched reductions match reduce()") {
+		std::vector<int> damages;
+		std::vector<int> defenses;
+		for (int damage = -50 ; damage <= 5000 ; damage += 7) {
+			for (int defense = -999 ; defense <= 4000 ; defense += 13) {
+				damages.push_back(damage);
+				defenses.push_back(defense);
+			}
+		}
+		for (int defense : {0, -1, 1, -1000, 1000, 100000, -100000}) {
+			damages.push_back(999);
+			defenses.push_back(defense);
+		}
+
+		std::vector<int> reduced(damages.size());
+		dummy_buffer::reduce_all(damages.data(), defenses.data(), reduced.data(), damages.size());
+		std::size_t mismatches = 0;
+		for (std::size_t i = 0 ; i < damages.size() ; ++i) {
+			if (reduced[i] != dummy_buffer::reduce(damages[i], defenses[i])) {
+				++mismatches;
+			}
+		}
+		CHECK(mismatches == 0);
+
+		CHECK(dummy_buffer::reduce(100, 0) == 100);
+		CHECK(dummy_buffer::reduce(100, 1000) == 50);
+		CHECK(dummy_buffer::reduce(100, -1000) == 150);
+	}
+
+	SECTION("Several events on the same target") {
+		dummy tank{7, 1000, 1000, 0};
+		dummy weakling{3, 100, 0, 0};
+		dummy bystander{5, 100, 0, 0};
+
+		dummy_buffer buffer;
+		buffer.push(tank, damage_type::physical, 100);
+		buffer.push(weakling, damage_type::true_damage, 60);
+		buffer.push(tank, damage_type::magical, 40);
+		buffer.push(tank, damage_type::physical, 100, 1000);
+
+		dummy_buffer other;
+		other.push(weakling, damage_type::physical, 50);
+		other.push(bystander, damage_type::magical, 10);
+		buffer.append(other);
+		CHECK(other.empty());
+		REQUIRE(buffer.size() == 6);
+
+		const std::vector<dummy*> dead = buffer.resolve();
+		CHECK(buffer.empty());
+
+		// 100 halved by the armor, 40 doubled by the buff, 100 with all of the armor ignored
+		CHECK(tank.hp == 1000 - 50 - 80 - 100);
+		CHECK(weakling.hp == 100 - 60 - 50);
+		CHECK(bystander.hp == 100 - 20);
+		CHECK(tank.health_losses == 1);
+		CHECK(weakling.health_losses == 1);
+		CHECK(bystander.health_losses == 1);
+
+		const std::vector<std::pair<damage_type, int>> tank_hooks{
+				{damage_type::physical, 100}, {damage_type::magical, 40}, {damage_type::physical, 100}};
+		CHECK(tank.hooked == tank_hooks);
+		const std::vector<std::pair<damage_type, int>> weakling_hooks{{damage_type::true_damage, 60}, {damage_type::physical, 50}};
+		CHECK(weakling.hooked == weakling_hooks);
+
+		CHECK(dead == std::vector<dummy*>{&weakling});
+	}
+
+	SECTION("The dead are ordered by entity id") {
+		dummy a{9, 10, 0, 0};
+		dummy b{2, 10, 0, 0};
+		dummy c{5, 10, 0, 0};
+		dummy survivor{1, 100, 0, 0};
+
+		dummy_buffer buffer;
+		for (dummy* target : {&a, &survivor, &b, &c}) {
+			buffer.push(*target, damage_type::true_damage, 10);
+		}
+		CHECK(buffer.resolve() == std::vector<dummy*>{&b, &c, &a});
+		CHECK(buffer.resolve().empty());
+		CHECK(survivor.hp == 90);
+	}
+}
@@ -0,0 +1,121 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///                                                                                                                                     ///
+///  Copyright C 2018, Lucas Lazare                                                                                                     ///
+///  Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation         ///
+///  		files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy,  ///
+///  modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software     ///
+///  		is furnished to do so, subject to the following conditions:                                                                 ///
+///                                                                                                                                     ///
+///  The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.     ///
+///                                                                                                                                     ///
+///  The Software is provided “as is”, without warranty of any kind, express or implied, including but not limited to the               ///
+///  warranties of merchantability, fitness for a particular purpose and noninfringement. In no event shall the authors or              ///
+///  copyright holders be liable for any claim, damages or other liability, whether in an action of contract, tort or otherwise,        ///
+///  arising from, out of or in connection with the software or the use or other dealings in the Software.                              ///
+///                                                                                                                                     ///
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <random>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <catch2/catch.hpp>
+#include <utils/flat_quadtree.hpp>
+#include <utils/geometry.hpp>
+
+using area = dungeep::area<float>;
+using point = dungeep::point<float>;
+using dungeep::flat_quadtree;
+
+namespace {
+
+	struct collider {
+
+		collider(const collider&) noexcept = default;
+		collider& operator=(const collider&) noexcept = default;
+		bool operator==(const collider& other) const {
+			// lazy equality test
+			return hitbox_.contains(other.hitbox_) && other.hitbox_.contains(hitbox_);
+		}
+
+		const area& hitbox() const noexcept {
+			return hitbox_;
+		}
+
+		void set_hitbox(const area& ar) noexcept {
+			hitbox_ = ar;
+		}
+
+		area hitbox_;
+	};
+
+	area rand_area(std::mt19937& rand) {
+		std::uniform_real_distribution<float> pos{-5.f, 100.f};
+		std::uniform_real_distribution<float> size{0.f, 10.f};
+		point pt{pos(rand), pos(rand)};
+		return {pt, pt + point{size(rand), size(rand)}};
+	}
+}
+
+TEST_CASE("Flat quadtree") {
+	using tree_type = flat_quadtree<collider, 4>;
+
+	SECTION("Layout") {
+		static_assert(tree_type::node_count == 1 + 4 + 16 + 64 + 256);
+		static_assert(tree_type::level_begin(2) == 5);
+
+		for (unsigned int level = 0 ; level < 4 ; ++level) {
+			for (auto node = tree_type::level_begin(level) ; node < tree_type::level_begin(level + 1) ; ++node) {
+				const auto child = tree_type::first_child_of(node, level);
+				const auto side = std::size_t{2} << level;
+				CHECK(tree_type::parent_of(child, level + 1) == node);
+				CHECK(tree_type::parent_of(child + 1, level + 1) == node);
+				CHECK(tree_type::parent_of(child + side, level + 1) == node);
+				CHECK(tree_type::parent_of(child + side + 1, level + 1) == node);
+			}
+		}
+	}
+
+	SECTION("Container") {
+		std::mt19937 rand{42};
+		tree_type tree{{{0.f, 0.f}, {100.f, 100.f}}};
+
+		std::vector<collider> colliders;
+		for (auto i = 0u ; i < 300 ; ++i) {
+			colliders.push_back({rand_area(rand)});
+			tree.insert(colliders.back());
+		}
+		REQUIRE(tree.size() == colliders.size());
+		CHECK(std::distance(tree.begin(), tree.end()) == static_cast<long>(colliders.size()));
+
+		for (collider& c : colliders) {
+			area moved = rand_area(rand);
+			tree.move(c, moved);
+			c.set_hitbox(moved);
+		}
+		for (const collider& c : colliders) {
+			CHECK(tree.find(c) != tree.end());
+		}
+
+		const area target{{20.f, 30.f}, {45.f, 50.f}};
+		auto expected = std::count_if(colliders.begin(), colliders.end(), [&target](const collider& c) {
+			return target.collides_with(c.hitbox());
+		});
+
+		long hits = 0;
+		std::as_const(tree).visit(target, [&hits, &target](tree_type::const_iterator it) {
+			CHECK(target.collides_with(it->hitbox()));
+			++hits;
+		});
+		CHECK(hits == expected);
+
+		tree.visit(target, [](tree_type::iterator) { return true; });
+		CHECK(tree.size() == colliders.size() - static_cast<std::size_t>(expected));
+		CHECK(!tree.has_collision(target));
+
+		for (auto it = tree.begin() ; it != tree.end() ;) {
+			it = tree.erase(it);
+		}
+		CHECK(tree.empty());
+	}
+}
@@ -0,0 +1,46 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///                                                                                                                                     ///
+///  Copyright C 2018, Lucas Lazare                                                                                                     ///
+///  Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation         ///
+///  		files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy,  ///
+///  modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software     ///
+///  		is furnished to do so, subject to the following conditions:                                                                 ///
+///                                                                                                                                     ///
+///  The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.     ///
+///                                                                                                                                     ///
+///  The Software is provided “as is”, without warranty of any kind, express or implied, including but not limited to the               ///
+///  warranties of merchantability, fitness for a particular purpose and noninfringement. In no event shall the authors or              ///
+///  copyright holders be liable for any claim, damages or other liability, whether in an action of contract, tort or otherwise,        ///
+///  arising from, out of or in connection with the software or the use or other dealings in the Software.                              ///
+///                                                                                                                                     ///
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <catch2/catch.hpp>
+#include <utils/hash.hpp>
+
+using dungeep::fnv1a;
+
+TEST_CASE("FNV-1a") {
+
+	SECTION("Known answers") {
+		static_assert(fnv1a{}.value() == 0xCBF29CE484222325u);
+		CHECK(fnv1a{}.add("a").value() == 0xAF63DC4C8601EC8Cu);
+		CHECK(fnv1a{}.add("foobar").value() == 0x85944171F73967E8u);
+
+		const unsigned char bytes[] = {'f', 'o', 'o', 'b', 'a', 'r'};
+		CHECK(fnv1a{}.add_bytes(bytes, sizeof(bytes)).value() == 0x85944171F73967E8u);
+	}
+
+	SECTION("Values are fed as little endian bytes") {
+		CHECK(fnv1a{}.add(std::uint32_t{0x12345678u}).value() == 0xCCCFD053E47C3365u);
+		CHECK(fnv1a{}.add(std::int32_t{0x12345678}).value() == 0xCCCFD053E47C3365u);
+		CHECK(fnv1a{}.add(std::uint8_t{'a'}).value() == 0xAF63DC4C8601EC8Cu);
+	}
+
+	SECTION("Incremental") {
+		CHECK(fnv1a{}.add("foo").add("bar").value() == fnv1a{}.add("foobar").value());
+		CHECK(fnv1a{}.add(1.f).value() != fnv1a{}.add(2.f).value());
+		CHECK(fnv1a{}.add(1.f).value() == fnv1a{}.add(std::uint32_t{0x3F800000u}).value());
+		CHECK(fnv1a{}.add(true).value() != fnv1a{}.add(false).value());
+	}
+}
@@ -0,0 +1,153 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///                                                                                                                                     ///
+///  Copyright C 2019, Lucas Lazare                                                                                                     ///
+///  Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation         ///
+///  		files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy,  ///
+///  modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software     ///
+///  		is furnished to do so, subject to the following conditions:                                                                 ///
+///                                                                                                                                     ///
+///  The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.     ///
+///                                                                                                                                     ///
+///  The Software is provided “as is”, without warranty of any kind, express or implied, including but not limited to the               ///
+///  warranties of merchantability, fitness for a particular purpose and noninfringement. In no event shall the authors or              ///
+///  copyright holders be liable for any claim, damages or other liability, whether in an action of contract, tort or otherwise,        ///
+///  arising from, out of or in connection with the software or the use or other dealings in the Software.                              ///
+///                                                                                                                                     ///
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <environment/map_cache.hpp>
+#include <environment/map_snapshot.hpp>
+
+namespace {
+	const std::vector<room_gen_properties> rooms_properties{{{60.f, 20.f, 2.f, 1.f, 3u, 4u, 12u},
+	                                                         {6.f, 2.f, 1.f, 0.5f, 2u, 2u, 4u},
+	                                                         6.f, 2.f, 3.f, 1.f}};
+	const hallway_gen_properties hallway_properties{0.5f, 10.f, 8.f, 2.f, 3.f, 1.f, 2u, 4u};
+	constexpr map::size_type map_size{120u, 80u};
+	constexpr std::uint64_t seed = 11u;
+
+	bool same_tiles(const map& lhs, const map& rhs) {
+		if (lhs.size().width != rhs.size().width || lhs.size().height != rhs.size().height) {
+			return false;
+		}
+		for (unsigned int x = 0 ; x < lhs.size().width ; ++x) {
+			if (lhs[x] != rhs[x]) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool same_rooms(const std::vector<map::map_area>& lhs, const std::vector<map::map_area>& rhs) {
+		return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), [](const map::map_area& l, const map::map_area& r) {
+			return l.x == r.x && l.y == r.y && l.width == r.width && l.height == r.height;
+		});
+	}
+
+	std::vector<std::filesystem::path> files_in(const std::filesystem::path& directory) {
+		return {std::filesystem::directory_iterator{directory}, std::filesystem::directory_iterator{}};
+	}
+
+	void write(const std::filesystem::path& path, const std::string& data) {
+		std::ofstream{path, std::ios_base::binary | std::ios_base::trunc}.write(data.data(), static_cast<std::streamsize>(data.size()));
+	}
+
+	std::string read(const std::filesystem::path& path) {
+		std::ifstream file{path, std::ios_base::binary};
+		return {std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+	}
+}
+
+TEST_CASE("Map cache") {
+	const std::filesystem::path directory = std::filesystem::temp_directory_path() / "dungeep_map_cache_test";
+	std::filesystem::remove_all(directory);
+	const map_cache cache{directory};
+	const std::uint64_t key = map_cache::key(seed, map_size, rooms_properties, hallway_properties);
+
+	map reference;
+	const std::vector<map::map_area> reference_rooms = reference.generate(map_size, rooms_properties, hallway_properties, seed);
+
+	map generated;
+	const std::vector<map::map_area> generated_rooms = cache.generate(generated, map_size, rooms_properties, hallway_properties, seed);
+	CHECK(same_tiles(generated, reference));
+	CHECK(same_rooms(generated_rooms, reference_rooms));
+	const std::vector<std::filesystem::path> files = files_in(directory);
+	REQUIRE(files.size() == 1);
+	const std::filesystem::path file = files.front();
+	CHECK(file.extension() == ".dgm");
+
+	SECTION("Stored maps are loaded back") {
+		map loaded;
+		const std::optional<std::vector<map::map_area>> loaded_rooms = cache.load(key, loaded);
+		REQUIRE(loaded_rooms);
+		CHECK(same_rooms(*loaded_rooms, reference_rooms));
+		CHECK(same_tiles(loaded, reference));
+
+		map hit;
+		CHECK(same_rooms(cache.generate(hit, map_size, rooms_properties, hallway_properties, seed), reference_rooms));
+		CHECK(same_tiles(hit, reference));
+		CHECK(files_in(directory).size() == 1);
+	}
+
+	SECTION("Changing any input misses") {
+		std::vector<room_gen_properties> other_rooms = rooms_properties;
+		other_rooms.front().holes_properties.max_height = 5u;
+		hallway_gen_properties other_hallways = hallway_properties;
+		other_hallways.curliness = 0.6f;
+
+		const std::uint64_t other_keys[] = {
+				map_cache::key(seed + 1, map_size, rooms_properties, hallway_properties),
+				map_cache::key(seed, {121u, 80u}, rooms_properties, hallway_properties),
+				map_cache::key(seed, {120u, 81u}, rooms_properties, hallway_properties),
+				map_cache::key(seed, map_size, other_rooms, hallway_properties),
+				map_cache::key(seed, map_size, {}, hallway_properties),
+				map_cache::key(seed, map_size, rooms_properties, other_hallways),
+		};
+		map target;
+		for (std::uint64_t other_key : other_keys) {
+			CHECK(other_key != key);
+			CHECK_FALSE(cache.load(other_key, target));
+		}
+		CHECK(map_cache::key(seed, map_size, rooms_properties, hallway_properties) == key);
+
+		cache.generate(target, map_size, rooms_properties, hallway_properties, seed + 1);
+		CHECK(files_in(directory).size() == 2);
+	}
+
+	SECTION("Corrupted files are ignored, and the map regenerated") {
+		std::string data = read(file);
+		data[data.size() / 2] = static_cast<char>(data[data.size() / 2] ^ 0x10);
+		write(file, data);
+
+		map target;
+		CHECK_FALSE(cache.load(key, target));
+		CHECK(same_rooms(cache.generate(target, map_size, rooms_properties, hallway_properties, seed), reference_rooms));
+		CHECK(same_tiles(target, reference));
+		CHECK(cache.load(key, target)); // stored again
+	}
+
+	SECTION("Truncated files are ignored") {
+		const std::string data = read(file);
+		write(file, data.substr(0, data.size() - 1));
+		map target;
+		CHECK_FALSE(cache.load(key, target));
+	}
+
+	SECTION("Files tagged with another key are ignored") {
+		write(file, map_snapshot::serialize(reference, reference_rooms, map_snapshot::tile_encoding::run_length, key + 1));
+		map target;
+		CHECK_FALSE(cache.load(key, target));
+		CHECK(same_rooms(cache.generate(target, map_size, rooms_properties, hallway_properties, seed), reference_rooms));
+		CHECK(same_tiles(target, reference));
+		CHECK(cache.load(key, target));
+	}
+
+	std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,180 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///                                                                                                                                     ///
+///  Copyright C 2019, Lucas Lazare                                                                                                     ///
+///  Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation         ///
+///  		files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy,  ///
+///  modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software     ///
+///  		is furnished to do so, subject to the following conditions:                                                                 ///
+///                                                                                                                                     ///
+///  The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.     ///
+///                                                                                                                                     ///
+///  The Software is provided “as is”, without warranty of any kind, express or implied, including but not limited to the               ///
+///  warranties of merchantability, fitness for a particular purpose and noninfringement. In no event shall the authors or              ///
+///  copyright holders be liable for any claim, damages or other liability, whether in an action of contract, tort or otherwise,        ///
+///  arising from, out of or in connection with the software or the use or other dealings in the Software.                              ///
+///                                                                                                                                     ///
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <environment/map_snapshot.hpp>
+
+namespace {
+	const std::vector<room_gen_properties> rooms_properties{{{60.f, 20.f, 2.f, 1.f, 3u, 4u, 12u},
+	                                                         {6.f, 2.f, 1.f, 0.5f, 2u, 2u, 4u},
+	                                                         6.f, 2.f, 3.f, 1.f}};
+	const hallway_gen_properties hallway_properties{0.5f, 10.f, 8.f, 2.f, 3.f, 1.f, 2u, 4u};
+
+	map_snapshot view(const std::string& data) {
+		return map_snapshot{reinterpret_cast<const unsigned char*>(data.data()), data.size()};
+	}
+
+	void write_u32(std::string& data, std::size_t pos, std::uint32_t value) {
+		for (auto i = 0u ; i < 4u ; ++i) {
+			data[pos + i] = static_cast<char>((value >> (8u * i)) & 0xFFu);
+		}
+	}
+
+	bool same_tiles(const map& lhs, const map& rhs) {
+		if (lhs.size().width != rhs.size().width || lhs.size().height != rhs.size().height) {
+			return false;
+		}
+		for (unsigned int x = 0 ; x < lhs.size().width ; ++x) {
+			if (lhs[x] != rhs[x]) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool same_rooms(const std::vector<map::map_area>& lhs, const std::vector<map::map_area>& rhs) {
+		return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), [](const map::map_area& l, const map::map_area& r) {
+			return l.x == r.x && l.y == r.y && l.width == r.width && l.height == r.height;
+		});
+	}
+}
+
+TEST_CASE("Map snapshots") {
+	map source;
+	const std::vector<map::map_area> rooms = source.generate({120u, 80u}, rooms_properties, hallway_properties, 3u);
+	REQUIRE_FALSE(rooms.empty());
+	const std::size_t tiles_pos = map_snapshot::header_size + rooms.size() * 4 * sizeof(std::uint32_t);
+
+	SECTION("Round trips") {
+		for (auto encoding : {map_snapshot::tile_encoding::raw, map_snapshot::tile_encoding::run_length}) {
+			const std::string data = map_snapshot::serialize(source, rooms, encoding, 42u);
+			const map_snapshot snapshot = view(data);
+			REQUIRE(snapshot.is_valid());
+			CHECK(snapshot.checksum_matches());
+			CHECK(snapshot.version() == map_snapshot::format_version);
+			CHECK(snapshot.encoding() == encoding);
+			CHECK(snapshot.tag() == 42u);
+			CHECK(snapshot.size().width == 120u);
+			CHECK(snapshot.size().height == 80u);
+			CHECK(same_rooms(snapshot.rooms(), rooms));
+
+			map loaded;
+			snapshot.load_into(loaded);
+			CHECK(same_tiles(loaded, source));
+		}
+	}
+
+	SECTION("Raw tiles are read in place") {
+		const std::string data = map_snapshot::serialize(source, rooms, map_snapshot::tile_encoding::raw);
+		const map_snapshot snapshot = view(data);
+		REQUIRE(snapshot.is_valid());
+		bool same = true;
+		for (auto x = 0u ; x < 120u ; ++x) {
+			for (auto y = 0u ; y < 80u ; ++y) {
+				same = same && snapshot.tile(x, y) == source[x][y];
+			}
+		}
+		CHECK(same);
+	}
+
+	SECTION("Run length encoding is smaller") {
+		CHECK(map_snapshot::serialize(source, rooms, map_snapshot::tile_encoding::run_length).size()
+		      < map_snapshot::serialize(source, rooms, map_snapshot::tile_encoding::raw).size());
+	}
+
+	SECTION("Files") {
+		const std::filesystem::path directory = std::filesystem::temp_directory_path() / "dungeep_map_snapshot_test";
+		std::filesystem::create_directories(directory);
+		const std::filesystem::path path = directory / "map.dgms";
+		const std::string data = map_snapshot::serialize(source, rooms, map_snapshot::tile_encoding::run_length);
+		std::ofstream{path, std::ios_base::binary | std::ios_base::trunc}.write(data.data(), static_cast<std::streamsize>(data.size()));
+
+		const map_snapshot snapshot{path};
+		REQUIRE(snapshot.is_valid());
+		map loaded;
+		snapshot.load_into(loaded);
+		CHECK(same_tiles(loaded, source));
+
+		CHECK_FALSE(map_snapshot{directory / "missing.dgms"}.is_valid());
+		std::filesystem::remove_all(directory);
+	}
+
+	SECTION("Corruption is caught by the checksum") {
+		std::string data = map_snapshot::serialize(source, rooms, map_snapshot::tile_encoding::raw);
+		data[data.size() / 2] = static_cast<char>(data[data.size() / 2] ^ 1);
+		const map_snapshot snapshot = view(data);
+		REQUIRE(snapshot.is_valid());
+		CHECK_FALSE(snapshot.checksum_matches());
+	}
+
+	SECTION("Truncated snapshots") {
+		for (auto encoding : {map_snapshot::tile_encoding::raw, map_snapshot::tile_encoding::run_length}) {
+			const std::string data = map_snapshot::serialize(source, rooms, encoding);
+			CHECK_FALSE(view(data.substr(0, data.size() - 1)).is_valid());
+			CHECK_FALSE(view(data.substr(0, tiles_pos)).is_valid());
+			CHECK_FALSE(view(data.substr(0, map_snapshot::header_size - 1)).is_valid());
+			CHECK_FALSE(view(std::string{}).is_valid());
+		}
+	}
+
+	SECTION("Bad magic number") {
+		std::string data = map_snapshot::serialize(source, rooms, map_snapshot::tile_encoding::raw);
+		data[0] = 'X';
+		CHECK_FALSE(view(data).is_valid());
+	}
+
+	SECTION("Newer versions") {
+		std::string data = map_snapshot::serialize(source, rooms, map_snapshot::tile_encoding::raw);
+		data[4] = static_cast<char>(map_snapshot::format_version + 1);
+		CHECK_FALSE(view(data).is_valid());
+	}
+
+	SECTION("Unknown encodings and tiles") {
+		std::string unknown_encoding = map_snapshot::serialize(source, rooms, map_snapshot::tile_encoding::raw);
+		unknown_encoding[20] = 2;
+		CHECK_FALSE(view(unknown_encoding).is_valid());
+
+		std::string raw = map_snapshot::serialize(source, rooms, map_snapshot::tile_encoding::raw);
+		raw[tiles_pos + 10] = static_cast<char>(static_cast<int>(tiles::none) + 1);
+		CHECK_FALSE(view(raw).is_valid());
+
+		std::string run_length = map_snapshot::serialize(source, rooms, map_snapshot::tile_encoding::run_length);
+		run_length[tiles_pos + 4] = static_cast<char>(static_cast<int>(tiles::none) + 1);
+		CHECK_FALSE(view(run_length).is_valid());
+	}
+
+	SECTION("Runs overflowing the map") {
+		const std::string data = map_snapshot::serialize(source, rooms, map_snapshot::tile_encoding::run_length);
+		REQUIRE(data.size() > tiles_pos + 5); // more than one run
+
+		std::string whole_map = data;
+		write_u32(whole_map, tiles_pos, 120u * 80u);
+		CHECK_FALSE(view(whole_map).is_valid());
+
+		std::string wrapping = data;
+		write_u32(wrapping, tiles_pos, 0xFFFFFFFFu);
+		CHECK_FALSE(view(wrapping).is_valid());
+
+		std::string empty_run = data;
+		write_u32(empty_run, tiles_pos, 0u);
+		CHECK_FALSE(view(empty_run).is_valid());
+	}
+}
@@ -0,0 +1,169 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///                                                                                                                                     ///
+///  Copyright C 2019, Lucas Lazare                                                                                                     ///
+///  Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation         ///
+///  		files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy,  ///
+///  modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software     ///
+///  		is furnished to do so, subject to the following conditions:                                                                 ///
+///                                                                                                                                     ///
+///  The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.     ///
+///                                                                                                                                     ///
+///  The Software is provided “as is”, without warranty of any kind, express or implied, including but not limited to the               ///
+///  warranties of merchantability, fitness for a particular purpose and noninfringement. In no event shall the authors or              ///
+///  copyright holders be liable for any claim, damages or other liability, whether in an action of contract, tort or otherwise,        ///
+///  arising from, out of or in connection with the software or the use or other dealings in the Software.                              ///
+///                                                                                                                                     ///
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <environment/map.hpp>
+#include <utils/quadtree.hpp>
+#include <utils/thread_pool.hpp>
+
+namespace {
+	const std::vector<room_gen_properties> rooms_properties{{{120.f, 40.f, 3.f, 1.f, 4u, 6u, 20u},
+	                                                         {6.f, 2.f, 1.f, 0.5f, 2u, 2u, 4u},
+	                                                         12.f, 3.f, 6.f, 2.f}};
+	const hallway_gen_properties hallway_properties{0.5f, 10.f, 8.f, 2.f, 3.f, 1.f, 2u, 5u};
+	constexpr map::size_type map_size{300u, 180u};
+
+	bool same_tiles(const map& lhs, const map& rhs) {
+		if (lhs.size().width != rhs.size().width || lhs.size().height != rhs.size().height) {
+			return false;
+		}
+		for (unsigned int x = 0 ; x < lhs.size().width ; ++x) {
+			if (lhs[x] != rhs[x]) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	struct collider {
+		const dungeep::area_f& hitbox() const noexcept {
+			return box;
+		}
+
+		dungeep::area_f box;
+	};
+
+	bool same_rooms(const std::vector<map::map_area>& lhs, const std::vector<map::map_area>& rhs) {
+		return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(), [](const map::map_area& l, const map::map_area& r) {
+			return l.x == r.x && l.y == r.y && l.width == r.width && l.height == r.height;
+		});
+	}
+}
+
+TEST_CASE("Map generation") {
+
+	SECTION("A seed gives the same map whatever the number of threads") {
+		dungeep::thread_pool single_thread{1};
+		dungeep::thread_pool many_threads{8};
+
+		for (std::uint64_t seed : {1u, 7u, 42u}) {
+			map sequential, single, parallel;
+			const std::vector<map::map_area> sequential_rooms = sequential.generate(map_size, rooms_properties, hallway_properties, seed);
+			const std::vector<map::map_area> single_rooms = single.generate(map_size, rooms_properties, hallway_properties, seed, &single_thread);
+			const std::vector<map::map_area> parallel_rooms = parallel.generate(map_size, rooms_properties, hallway_properties, seed, &many_threads);
+
+			INFO("seed " << seed);
+			CHECK_FALSE(sequential_rooms.empty());
+			CHECK(same_rooms(sequential_rooms, single_rooms));
+			CHECK(same_rooms(sequential_rooms, parallel_rooms));
+			CHECK(same_tiles(sequential, single));
+			CHECK(same_tiles(sequential, parallel));
+		}
+	}
+
+	SECTION("Different seeds give different maps") {
+		map a, b;
+		a.generate(map_size, rooms_properties, hallway_properties, 1u);
+		b.generate(map_size, rooms_properties, hallway_properties, 2u);
+		CHECK_FALSE(same_tiles(a, b));
+	}
+}
+
+// dungeep_tests_mt19937 runs it with std::mt19937_64, dungeep_tests with xoshiro256** (see dungeep::default_engine)
+TEST_CASE("Map generation benchmarks", "[.][benchmark]") {
+	const std::string engine = std::is_same_v<dungeep::default_engine, std::mt19937_64> ? "mt19937_64" : "xoshiro256**";
+	dungeep::thread_pool pool{4};
+
+	std::uint64_t seed = 0;
+	BENCHMARK("generate, " + engine) {
+		map generated;
+		return generated.generate(map_size, rooms_properties, hallway_properties, ++seed).size();
+	};
+
+	BENCHMARK("generate on 4 threads, " + engine) {
+		map generated;
+		return generated.generate(map_size, rooms_properties, hallway_properties, ++seed, &pool).size();
+	};
+}
+
+TEST_CASE("Map raycasts") {
+	map terrain;
+	terrain.generate(map_size, rooms_properties, hallway_properties, 1u);
+	for (unsigned int x = 0 ; x < map_size.width ; ++x) {
+		std::fill(terrain[x].begin(), terrain[x].end(), tiles::walkable);
+		terrain[x][120] = tiles::wall;
+	}
+	for (unsigned int y = 0 ; y < map_size.height ; ++y) {
+		terrain[100][y] = tiles::empty_space;
+	}
+	terrain[50][20] = tiles::hole;
+
+	SECTION("Nothing in the way") {
+		CHECK(terrain.cast_ray({10.5f, 10.5f}, {90.5f, 60.5f}) == Approx(1.f));
+		CHECK(terrain.cast_ray({30.5f, 20.5f}, {70.5f, 20.5f}) == Approx(1.f)); // holes do not block sight
+	}
+
+	SECTION("Axis aligned rays") {
+		CHECK(terrain.cast_ray({50.5f, 20.5f}, {150.5f, 20.5f}) == Approx(0.495f));
+		CHECK(terrain.cast_ray({150.5f, 20.5f}, {50.5f, 20.5f}) == Approx(0.495f));
+		CHECK(terrain.cast_ray({20.5f, 100.5f}, {20.5f, 140.5f}) == Approx(0.4875f));
+		CHECK(terrain.cast_ray({20.5f, 140.5f}, {20.5f, 100.5f}) == Approx(0.4875f));
+	}
+
+	SECTION("Diagonal rays") {
+		CHECK(terrain.cast_ray({80.5f, 20.5f}, {120.5f, 60.5f}) == Approx(0.4875f));
+		CHECK(terrain.cast_ray({20.5f, 100.5f}, {60.5f, 140.5f}) == Approx(0.4875f));
+		CHECK(terrain.cast_ray({120.5f, 60.5f}, {80.5f, 20.5f}) == Approx(0.4875f));
+	}
+
+	SECTION("Rays leaving the map") {
+		CHECK(terrain.cast_ray({10.5f, 10.5f}, {-10.5f, 10.5f}) == Approx(0.5f));
+		CHECK(terrain.cast_ray({290.5f, 10.5f}, {310.5f, 10.5f}) == Approx(0.475f));
+		CHECK(terrain.cast_ray({10.5f, 10.5f}, {10.5f, -10.5f}) == Approx(0.5f));
+	}
+
+	SECTION("Rays starting in a wall, or of null length") {
+		CHECK(terrain.cast_ray({100.5f, 10.5f}, {150.5f, 10.5f}) == Approx(0.f));
+		CHECK(terrain.cast_ray({100.5f, 10.5f}, {100.5f, 10.5f}) == Approx(0.f));
+		CHECK(terrain.cast_ray({10.5f, 10.5f}, {10.5f, 10.5f}) == Approx(1.f));
+	}
+
+	SECTION("Objects of an index, stopped by walls") {
+		dungeep::quadtree<collider> index{{{0.f, 0.f}, {300.f, 180.f}}};
+		index.insert({{{60.f, 19.f}, {62.f, 22.f}}});
+		index.insert({{{110.f, 19.f}, {112.f, 22.f}}});
+		auto any = [](const collider&) { return true; };
+		auto behind_the_wall = [](const collider& c) { return c.hitbox().top_left.x > 100.f; };
+
+		auto it = terrain.cast_ray(index, {50.5f, 20.5f}, {150.5f, 20.5f}, any);
+		REQUIRE(it != index.end());
+		CHECK(it->hitbox().top_left.x == Approx(60.f));
+		CHECK(terrain.cast_ray(index, {50.5f, 20.5f}, {150.5f, 20.5f}, behind_the_wall) == index.end());
+
+		it = terrain.cast_ray(index, {105.5f, 20.5f}, {150.5f, 20.5f}, behind_the_wall);
+		REQUIRE(it != index.end());
+		CHECK(it->hitbox().top_left.x == Approx(110.f));
+		CHECK(terrain.cast_ray(index, {150.5f, 20.5f}, {50.5f, 20.5f}, any) != index.end());
+		CHECK(terrain.cast_ray(index, {50.5f, 30.5f}, {150.5f, 30.5f}, any) == index.end());
+	}
+}
@@ -0,0 +1,78 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///                                                                                                                                     ///
+///  Copyright C 2018, Lucas Lazare                                                                                                     ///
+///  Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation         ///
+///  		files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy,  ///
+///  modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software     ///
+///  		is furnished to do so, subject to the following conditions:                                                                 ///
+///                                                                                                                                     ///
+///  The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.     ///
+///                                                                                                                                     ///
+///  The Software is provided “as is”, without warranty of any kind, express or implied, including but not limited to the               ///
+///  warranties of merchantability, fitness for a particular purpose and noninfringement. In no event shall the authors or              ///
+///  copyright holders be liable for any claim, damages or other liability, whether in an action of contract, tort or otherwise,        ///
+///  arising from, out of or in connection with the software or the use or other dealings in the Software.                              ///
+///                                                                                                                                     ///
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <catch2/catch.hpp>
+#include <utils/mapped_file.hpp>
+
+using dungeep::mapped_file;
+
+TEST_CASE("Memory mapped files") {
+	const std::filesystem::path directory = std::filesystem::temp_directory_path() / "dungeep_mapped_file_test";
+	std::filesystem::create_directories(directory);
+	const std::filesystem::path path = directory / "content.bin";
+	const std::filesystem::path empty_path = directory / "empty.bin";
+
+	std::string content;
+	for (auto i = 0 ; i < 10000 ; ++i) {
+		content.push_back(static_cast<char>(i * 7));
+	}
+	std::ofstream{path, std::ios_base::binary | std::ios_base::trunc}.write(content.data(), static_cast<std::streamsize>(content.size()));
+	std::ofstream{empty_path, std::ios_base::binary | std::ios_base::trunc}.flush();
+
+	SECTION("Content") {
+		mapped_file file{path};
+		REQUIRE(file.is_open());
+		REQUIRE(file.size() == content.size());
+		CHECK(std::equal(content.begin(), content.end(), file.data(), [](char lhs, unsigned char rhs) {
+			return static_cast<unsigned char>(lhs) == rhs;
+		}));
+	}
+
+	SECTION("Empty and missing files") {
+		mapped_file empty{empty_path};
+		CHECK(empty.is_open());
+		CHECK(empty.size() == 0);
+		CHECK(empty.data() == nullptr);
+
+		mapped_file missing{directory / "missing.bin"};
+		CHECK_FALSE(missing.is_open());
+		CHECK(missing.size() == 0);
+
+		CHECK_FALSE(mapped_file{}.is_open());
+	}
+
+	SECTION("Moves") {
+		mapped_file file{path};
+		const unsigned char* data = file.data();
+
+		mapped_file moved{std::move(file)};
+		CHECK_FALSE(file.is_open()); // NOLINT
+		CHECK(moved.data() == data);
+		CHECK(moved.size() == content.size());
+
+		file = std::move(moved);
+		CHECK(file.data() == data);
+		file.close();
+		CHECK_FALSE(file.is_open());
+	}
+
+	std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,189 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///                                                                                                                                     ///
+///  Copyright C 2018, Lucas Lazare                                                                                                     ///
+///  Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation         ///
+///  		files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy,  ///
+///  modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software     ///
+///  		is furnished to do so, subject to the following conditions:                                                                 ///
+///                                                                                                                                     ///
+///  The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.     ///
+///                                                                                                                                     ///
+///  The Software is provided “as is”, without warranty of any kind, express or implied, including but not limited to the               ///
+///  warranties of merchantability, fitness for a particular purpose and noninfringement. In no event shall the authors or              ///
+///  copyright holders be liable for any claim, damages or other liability, whether in an action of contract, tort or otherwise,        ///
+///  arising from, out of or in connection with the software or the use or other dealings in the Software.                              ///
+///                                                                                                                                     ///
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <utils/object_pool.hpp>
+
+using dungeep::object_pool;
+
+namespace {
+
+	struct counted {
+		explicit counted(int v) noexcept : value{v} {
+			++alive;
+		}
+
+		~counted() {
+			--alive;
+		}
+
+		int value;
+		static inline std::atomic<int> alive{0};
+	};
+
+	struct base {
+		virtual ~base() = default;
+		virtual int value() const noexcept = 0;
+	};
+
+	struct pooled final : base, dungeep::pool_allocated<pooled> {
+		explicit pooled(int v) noexcept : v_{v} {}
+
+		int value() const noexcept override {
+			return v_;
+		}
+
+		int v_;
+		char padding[40]{};
+	};
+}
+
+TEST_CASE("Object pool") {
+
+	SECTION("Handles") {
+		object_pool<counted, 4> pool;
+		auto first = pool.create(1);
+		auto second = pool.create(2);
+		CHECK(counted::alive == 2);
+		CHECK(pool.size() == 2);
+		REQUIRE(pool.get(first) != nullptr);
+		CHECK(pool.get(first)->value == 1);
+		CHECK(pool.get(second)->value == 2);
+		CHECK(pool.handle_of(pool.get(second)) == second);
+
+		counted* first_address = pool.get(first);
+		pool.destroy(first);
+		CHECK(counted::alive == 1);
+		CHECK(pool.get(first) == nullptr);
+		pool.destroy(first);
+		CHECK(counted::alive == 1);
+
+		// the slot is reused, but the old handle stays stale
+		auto third = pool.create(3);
+		CHECK(pool.get(third) == first_address);
+		CHECK(third != first);
+		CHECK(pool.get(first) == nullptr);
+		CHECK(pool.get(object_pool<counted, 4>::handle{}) == nullptr);
+
+		pool.destroy(second);
+		pool.destroy(third);
+		CHECK(counted::alive == 0);
+		CHECK(pool.size() == 0);
+	}
+
+	SECTION("Stable addresses") {
+		object_pool<counted, 4> pool;
+		std::vector<std::pair<object_pool<counted, 4>::handle, counted*>> objects;
+		for (int i = 0 ; i < 50 ; ++i) {
+			auto h = pool.create(i);
+			objects.emplace_back(h, pool.get(h));
+		}
+		for (int i = 0 ; i < 50 ; ++i) {
+			CHECK(pool.get(objects[i].first) == objects[i].second);
+			CHECK(objects[i].second->value == i);
+			pool.destroy(objects[i].first);
+		}
+		CHECK(counted::alive == 0);
+	}
+
+	SECTION("Pool allocated classes") {
+		std::vector<std::unique_ptr<base>> objects;
+		for (int i = 0 ; i < 10 ; ++i) {
+			objects.push_back(std::make_unique<pooled>(i));
+		}
+		CHECK(pooled::pool().size() == 10);
+
+		auto h = static_cast<pooled&>(*objects[3]).get_handle();
+		CHECK(pooled::from_handle(h) == objects[3].get());
+		objects.erase(objects.begin() + 3);
+		CHECK(pooled::from_handle(h) == nullptr);
+		CHECK(pooled::pool().size() == 9);
+
+		objects.clear();
+		CHECK(pooled::pool().size() == 0);
+	}
+
+	SECTION("References to a base class") {
+		auto object = std::make_unique<pooled>(7);
+		auto ref = dungeep::pool_ref<base>::to(*object);
+		REQUIRE(ref.get() == object.get());
+		CHECK(ref.get()->value() == 7);
+		CHECK(ref == dungeep::pool_ref<base>::to(*object));
+		CHECK(dungeep::pool_ref<base>{}.get() == nullptr);
+
+		object.reset();
+		CHECK(ref.get() == nullptr);
+		auto other = std::make_unique<pooled>(8);
+		CHECK(ref.get() == nullptr);
+	}
+
+	SECTION("Handles checked while allocating") {
+		object_pool<counted, 16> pool;
+		std::vector<object_pool<counted, 16>::handle> handles;
+		for (int i = 0 ; i < 64 ; ++i) {
+			handles.push_back(pool.create(i));
+		}
+
+		std::atomic<bool> done{false};
+		std::thread checker([&pool, &handles, &done] {
+			while (!done) {
+				for (auto h : handles) {
+					(void) pool.get(h);
+				}
+			}
+		});
+		for (int i = 0 ; i < 64 ; ++i) {
+			pool.destroy(handles[static_cast<std::size_t>(i)]);
+			pool.destroy(pool.create(i));
+		}
+		done = true;
+		checker.join();
+
+		for (auto h : handles) {
+			CHECK(pool.get(h) == nullptr);
+		}
+		CHECK(pool.size() == 0);
+	}
+
+	SECTION("Concurrent allocations") {
+		object_pool<counted, 16> pool;
+		std::atomic<int> mismatches{0};
+		std::vector<std::thread> threads;
+		for (int t = 0 ; t < 4 ; ++t) {
+			threads.emplace_back([&pool, &mismatches, t] {
+				for (int i = 0 ; i < 1000 ; ++i) {
+					auto h = pool.create(t * 1000 + i);
+					if (pool.get(h)->value != t * 1000 + i) {
+						++mismatches;
+					}
+					if (i % 2 == 0) {
+						pool.destroy(h);
+					}
+				}
+			});
+		}
+		for (std::thread& thread : threads) {
+			thread.join();
+		}
+		CHECK(mismatches == 0);
+		CHECK(pool.size() == 2000);
+	}
+}
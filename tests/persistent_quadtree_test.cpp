@@ -0,0 +1,181 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///                                                                                                                                     ///
+///  Copyright C 2018, Lucas Lazare                                                                                                     ///
+///  Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation         ///
+///  		files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy,  ///
+///  modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software     ///
+///  		is furnished to do so, subject to the following conditions:                                                                 ///
+///                                                                                                                                     ///
+///  The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.     ///
+///                                                                                                                                     ///
+///  The Software is provided “as is”, without warranty of any kind, express or implied, including but not limited to the               ///
+///  warranties of merchantability, fitness for a particular purpose and noninfringement. In no event shall the authors or              ///
+///  copyright holders be liable for any claim, damages or other liability, whether in an action of contract, tort or otherwise,        ///
+///  arising from, out of or in connection with the software or the use or other dealings in the Software.                              ///
+///                                                                                                                                     ///
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <random>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <utils/persistent_quadtree.hpp>
+#include <utils/geometry.hpp>
+
+using area = dungeep::area<float>;
+using point = dungeep::point<float>;
+using dungeep::persistent_quadtree;
+
+namespace {
+
+	struct collider {
+		bool operator==(const collider& other) const noexcept {
+			return id == other.id;
+		}
+
+		const area& hitbox() const noexcept {
+			return hitbox_;
+		}
+
+		void set_hitbox(const area& ar) noexcept {
+			hitbox_ = ar;
+		}
+
+		area hitbox_;
+		unsigned int id;
+	};
+
+	area rand_area(std::mt19937& rand) {
+		std::uniform_real_distribution<float> pos{0.f, 95.f};
+		std::uniform_real_distribution<float> size{0.f, 5.f};
+		point pt{pos(rand), pos(rand)};
+		return {pt, pt + point{size(rand), size(rand)}};
+	}
+
+	// ids of the elements of 'tree' colliding with 'target', sorted
+	std::vector<unsigned int> visited_ids(const persistent_quadtree<collider>& tree, const area& target) {
+		std::vector<unsigned int> ids;
+		tree.visit(target, [&ids](const collider& c) { ids.push_back(c.id); });
+		std::sort(ids.begin(), ids.end());
+		return ids;
+	}
+
+	std::vector<unsigned int> colliding_ids(const std::vector<collider>& colliders, const area& target) {
+		std::vector<unsigned int> ids;
+		for (const collider& c : colliders) {
+			if (c.hitbox().collides_with(target)) {
+				ids.push_back(c.id);
+			}
+		}
+		std::sort(ids.begin(), ids.end());
+		return ids;
+	}
+}
+
+TEST_CASE("Persistent quadtree") {
+	std::mt19937 rand{42};
+	persistent_quadtree<collider> tree(area{{0.f, 0.f}, {100.f, 100.f}}, 5, 8);
+	std::vector<collider> colliders;
+	for (auto i = 0u ; i < 400 ; ++i) {
+		colliders.push_back({rand_area(rand), i});
+		tree.insert(colliders.back());
+	}
+	REQUIRE(tree.size() == colliders.size());
+
+	const area whole{{0.f, 0.f}, {100.f, 100.f}};
+	const area target{{20.f, 10.f}, {60.f, 45.f}};
+
+	SECTION("Modifying & visiting") {
+		CHECK(visited_ids(tree, whole) == colliding_ids(colliders, whole));
+		CHECK(visited_ids(tree, target) == colliding_ids(colliders, target));
+
+		for (auto i = 0u ; i < colliders.size() ; i += 2) {
+			CHECK(tree.erase(colliders[i]));
+		}
+		CHECK(!tree.erase(colliders[0]));
+		for (auto i = 1u ; i < colliders.size() ; i += 4) {
+			const area new_area = rand_area(rand);
+			CHECK(tree.move(colliders[i], new_area));
+			colliders[i].hitbox_ = new_area;
+		}
+		std::vector<collider> remaining;
+		for (auto i = 1u ; i < colliders.size() ; i += 2) {
+			remaining.push_back(colliders[i]);
+		}
+		CHECK(tree.size() == remaining.size());
+		CHECK(visited_ids(tree, whole) == colliding_ids(remaining, whole));
+		CHECK(visited_ids(tree, target) == colliding_ids(remaining, target));
+		CHECK(tree.has_collision_if(whole, [&remaining](const collider& c) { return c == remaining[10]; }));
+		CHECK(!tree.has_collision_if(whole, [&colliders](const collider& c) { return c == colliders[10]; }));
+
+		for (const collider& c : remaining) {
+			CHECK(tree.erase(c));
+		}
+		CHECK(tree.empty());
+		CHECK(!tree.has_collision(whole));
+	}
+
+	SECTION("Snapshots") {
+		const auto snapshot = tree.snapshot();
+		CHECK(snapshot.shared_node_count(tree) > 0);
+		const auto expected = colliding_ids(colliders, target);
+
+		for (auto i = 0u ; i < 100 ; ++i) {
+			CHECK(tree.erase(colliders[i]));
+			tree.insert({rand_area(rand), 1000 + i});
+		}
+		tree.clear();
+		tree.insert(colliders.back());
+
+		CHECK(snapshot.size() == colliders.size());
+		CHECK(visited_ids(snapshot, target) == expected);
+		CHECK(visited_ids(snapshot, whole) == colliding_ids(colliders, whole));
+		CHECK(tree.size() == 1);
+		CHECK(snapshot.shared_node_count(tree) == 0);
+	}
+
+	SECTION("Path copying") {
+		const auto snapshot = tree.snapshot();
+		const auto node_count = snapshot.shared_node_count(snapshot);
+		REQUIRE(node_count > 5);
+
+		// the leaf holding the element and its ancestors are duplicated, the other nodes stay shared
+		tree.insert({{{1.f, 1.f}, {1.5f, 1.5f}}, 1000});
+		const auto shared = tree.shared_node_count(snapshot);
+		CHECK(shared < node_count);
+		CHECK(shared + 6 >= node_count);
+
+		// nodes are only duplicated once: they now belong to 'tree' alone
+		tree.insert({{{1.f, 1.f}, {1.5f, 1.5f}}, 1001});
+		CHECK(tree.shared_node_count(snapshot) == shared);
+	}
+
+	SECTION("Concurrent readers") {
+		// Catch assertions are not thread-safe: results are only checked from this thread
+		std::atomic<bool> stop{false};
+		std::atomic<unsigned int> mismatches{0};
+		auto snapshot = tree.snapshot();
+		const auto expected = colliding_ids(colliders, target);
+
+		std::thread reader([&] {
+			while (!stop.load()) {
+				if (visited_ids(snapshot, target) != expected) {
+					++mismatches;
+				}
+			}
+		});
+		for (auto i = 0u ; i < 2000 ; ++i) {
+			collider& c = colliders[i % colliders.size()];
+			const area new_area = rand_area(rand);
+			tree.move(c, new_area);
+			c.hitbox_ = new_area;
+		}
+		stop = true;
+		reader.join();
+
+		CHECK(mismatches == 0);
+		CHECK(visited_ids(tree, target) == colliding_ids(colliders, target));
+	}
+}
@@ -17,9 +17,14 @@
 
 #include <cstdlib>
 #include <ctime>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <atomic>
 #include <catch2/catch.hpp>
 #include <utils/quadtree.hpp>
 #include <utils/geometry.hpp>
+#include <utils/thread_pool.hpp>
 
 using area = dungeep::area<float>;
 using point = dungeep::point<float>;
@@ -119,4 +124,196 @@ TEST_CASE("Quadtree") {
 			CHECK(!qt.has_collision({{0.f, 0.f}, {2.f, 2.f}}));
 		}
 	}
+
+	SECTION("Raycast") {
+		collider first{{{20.f, 48.f}, {22.f, 52.f}}};
+		collider second{{{70.f, 45.f}, {72.f, 55.f}}};
+		collider aside{{{40.f, 10.f}, {42.f, 12.f}}};
+		collider large{{{10.f, 60.f}, {90.f, 90.f}}};
+
+		qt.insert(second);
+		qt.insert(aside);
+		qt.insert(large);
+		qt.insert(first);
+
+		auto it = qt.raycast({0.f, 50.f}, {100.f, 50.f});
+		REQUIRE(it != qt.end());
+		CHECK(*it == first);
+
+		it = qt.raycast({100.f, 50.f}, {0.f, 50.f});
+		REQUIRE(it != qt.end());
+		CHECK(*it == second);
+
+		it = qt.raycast({50.f, 0.f}, {50.f, 100.f});
+		REQUIRE(it != qt.end());
+		CHECK(*it == large);
+
+		it = qt.raycast_if({0.f, 50.f}, {100.f, 50.f}, [&first](const collider& c) { return !(c == first); });
+		REQUIRE(it != qt.end());
+		CHECK(*it == second);
+
+		CHECK(qt.raycast({0.f, 50.f}, {15.f, 50.f}) == qt.end());
+		CHECK(qt.raycast({0.f, 0.f}, {100.f, 5.f}) == qt.end());
+	}
+
+	SECTION("Colliding pairs") {
+		std::vector<collider> colliders;
+		for (auto i = 0u ; i < 200 ; ++i) {
+			point pt = rand_point();
+			colliders.push_back({{pt, pt + point{static_cast<float>(rand() % 8), static_cast<float>(rand() % 8)}}});
+			qt.insert(colliders.back());
+		}
+
+		unsigned int expected = 0;
+		for (auto i = 0u ; i < colliders.size() ; ++i) {
+			for (auto j = i + 1 ; j < colliders.size() ; ++j) {
+				if (colliders[i].hitbox().collides_with(colliders[j].hitbox())) {
+					++expected;
+				}
+			}
+		}
+
+		unsigned int found = 0;
+		qt.for_each_colliding_pair([&found](const collider& lhs, const collider& rhs) {
+			CHECK(lhs.hitbox().collides_with(rhs.hitbox()));
+			++found;
+		});
+		CHECK(found == expected);
+	}
+
+	SECTION("Crowded node") {
+		// all elements cross the center and stay in the root node
+		std::vector<collider> colliders;
+		for (auto i = 0u ; i < 50 ; ++i) {
+			point pt = rand_point() / 2.f;
+			colliders.push_back({{pt, point{50.f, 50.f} + pt}});
+			qt.insert(colliders.back());
+		}
+
+		const area target{{10.f, 10.f}, {30.f, 20.f}};
+		auto expected = std::count_if(colliders.begin(), colliders.end(), [&target](const collider& c) {
+			return target.collides_with(c.hitbox());
+		});
+
+		long hits = 0;
+		qt.visit(target, [&hits](decltype(qt)::iterator) {
+			++hits;
+			return true;
+		});
+		CHECK(hits == expected);
+		CHECK(qt.size() == colliders.size() - static_cast<unsigned long>(expected));
+		CHECK(!qt.has_collision(target));
+	}
+
+	SECTION("Stats") {
+		for (auto i = 0u ; i < 100 ; ++i) {
+			qt.insert({rand_area()});
+		}
+
+		dungeep::quadtree_stats stats = qt.stats();
+		CHECK(stats.node_count % 4 == 1);
+		CHECK(stats.nodes_per_depth[0] == 1);
+		CHECK(std::accumulate(stats.nodes_per_depth.begin(), stats.nodes_per_depth.end(), std::size_t{0}) == stats.node_count);
+		CHECK(std::accumulate(stats.elements_per_depth.begin(), stats.elements_per_depth.end(), std::size_t{0}) == qt.size());
+		CHECK(stats.interior_elements < qt.size());
+		CHECK(stats.allocated_bytes >= sizeof(qt) + qt.size() * sizeof(collider));
+
+		qt.reset_stats();
+		CHECK(qt.stats().query_count == 0);
+		(void)qt.has_collision({{10.f, 10.f}, {12.f, 12.f}});
+		qt.visit({{0.f, 0.f}, {100.f, 100.f}}, [](decltype(qt)::iterator) {});
+		stats = qt.stats();
+		CHECK(stats.query_count == 2);
+		// the visit walks every node, has_collision at least the root
+		CHECK(stats.visited_nodes > stats.node_count);
+		CHECK(stats.average_query_visits() > 1.f);
+	}
+
+	SECTION("Adaptive tuning") {
+		quadtree<collider> shallow{{{0.f, 0.f}, {100.f, 100.f}}, 1, 20};
+		std::vector<collider> colliders;
+		for (auto i = 0u ; i < 200 ; ++i) {
+			point pt = rand_point() / 10.f;
+			colliders.push_back({{pt, pt + point{.5f, .5f}}});
+			shallow.insert(colliders.back());
+		}
+		const std::size_t initial_depth = shallow.stats().nodes_per_depth.size();
+
+		// a dense, heavily queried spot splits deeper
+		dungeep::quadtree_tuning tuning{};
+		for (auto tick = 0u ; tick < 20 ; ++tick) {
+			for (auto i = 0u ; i < 50 ; ++i) {
+				(void)shallow.has_collision_if({{2.f, 2.f}, {3.f, 3.f}}, [](const collider&) { return false; });
+			}
+			shallow.adapt(tuning);
+		}
+		CHECK(shallow.stats().nodes_per_depth.size() > initial_depth);
+		CHECK(shallow.size() == colliders.size());
+
+		// then merges back once left alone
+		tuning.max_size = 1000;
+		for (auto tick = 0u ; tick < 20 ; ++tick) {
+			shallow.adapt(tuning);
+		}
+		CHECK(shallow.stats().node_count == 1);
+		CHECK(shallow.size() == colliders.size());
+		for (const collider& c : colliders) {
+			CHECK(shallow.find(c) != shallow.end());
+		}
+	}
+
+	SECTION("Parallel queries") {
+		dungeep::thread_pool pool{3};
+		std::vector<collider> colliders;
+		for (auto i = 0u ; i < 500 ; ++i) {
+			colliders.push_back({rand_area()});
+			qt.insert(colliders.back());
+		}
+
+		const area target{{5.f, 5.f}, {80.f, 90.f}};
+		auto expected = std::count_if(colliders.begin(), colliders.end(), [&target](const collider& c) {
+			return target.collides_with(c.hitbox());
+		});
+
+		// Catch assertions are not thread-safe: results are only checked from this thread
+		std::atomic<long> hits{0};
+		std::atomic<long> misses{0};
+		qt.parallel_visit(target, [&hits, &misses, &target](decltype(qt)::const_iterator it) {
+			++(target.collides_with(it->hitbox()) ? hits : misses);
+		}, pool);
+		CHECK(hits == expected);
+		CHECK(misses == 0);
+
+		const collider& needle = colliders[42];
+		CHECK(qt.parallel_has_collision_if(target, [&needle](const collider& c) { return c == needle; }, pool)
+		      == target.collides_with(needle.hitbox()));
+		CHECK(!qt.parallel_has_collision_if(target, [](const collider&) { return false; }, pool));
+	}
+}
+
+TEST_CASE("Quadtree with integer coordinates") {
+	using area_i = dungeep::area<int>;
+	struct tile_collider {
+		const area_i& hitbox() const noexcept {
+			return hitbox_;
+		}
+
+		area_i hitbox_;
+	};
+
+	quadtree<tile_collider, dungeep::quadtree_dynamics::dynamic_children, std::vector, int> qt(area_i{{0, 0}, {64, 64}});
+	for (int x = 0 ; x < 64 ; x += 4) {
+		for (int y = 0 ; y < 64 ; y += 4) {
+			qt.insert({{{x, y}, {x + 1, y + 1}}});
+		}
+	}
+	CHECK(qt.size() == 256);
+
+	// comparisons are exact: touching a tile's border counts as a collision, the next coordinate does not
+	CHECK(qt.has_collision({{2, 2}, {4, 4}}));
+	CHECK(!qt.has_collision({{2, 2}, {3, 3}}));
+
+	unsigned int visited = 0;
+	qt.visit(area_i{{0, 0}, {15, 15}}, [&visited](auto) { ++visited; });
+	CHECK(visited == 16);
 }
@@ -0,0 +1,321 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///                                                                                                                                     ///
+///  Copyright C 2018, Lucas Lazare                                                                                                     ///
+///  Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation         ///
+///  		files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy,  ///
+///  modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software     ///
+///  		is furnished to do so, subject to the following conditions:                                                                 ///
+///                                                                                                                                     ///
+///  The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.     ///
+///                                                                                                                                     ///
+///  The Software is provided “as is”, without warranty of any kind, express or implied, including but not limited to the               ///
+///  warranties of merchantability, fitness for a particular purpose and noninfringement. In no event shall the authors or              ///
+///  copyright holders be liable for any claim, damages or other liability, whether in an action of contract, tort or otherwise,        ///
+///  arising from, out of or in connection with the software or the use or other dealings in the Software.                              ///
+///                                                                                                                                     ///
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <sstream>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <utils/hash.hpp>
+#include <utils/random.hpp>
+
+using dungeep::philox4x32;
+using dungeep::xoshiro256ss;
+
+TEST_CASE("Philox4x32-10") {
+
+	SECTION("Known answers") {
+		// from the Random123 test vectors
+		CHECK(philox4x32::block({0u, 0u, 0u, 0u}, {0u, 0u}) == philox4x32::counter_type{0x6627e8d5u, 0xe169c58du, 0xbc57ac4cu, 0x9b00dbd8u});
+		CHECK(philox4x32::block({0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu}, {0xffffffffu, 0xffffffffu})
+		      == philox4x32::counter_type{0x408f276du, 0x41c83b0eu, 0xa20bc7c6u, 0x6d5451fdu});
+		CHECK(philox4x32::block({0x243f6a88u, 0x85a308d3u, 0x13198a2eu, 0x03707344u}, {0xa4093822u, 0x299f31d0u})
+		      == philox4x32::counter_type{0xd16cfe09u, 0x94fdccebu, 0x5001e420u, 0x24126ea1u});
+
+		philox4x32 engine;
+		CHECK(engine() == 0x6627e8d5u);
+		CHECK(engine() == 0xe169c58du);
+	}
+
+	SECTION("Streams") {
+		philox4x32 a{42, 7, 100};
+		philox4x32 b{42, 7, 100};
+		philox4x32 other_entity{42, 8, 100};
+		philox4x32 other_tick{42, 7, 101};
+		unsigned int differences_entity = 0;
+		unsigned int differences_tick = 0;
+		for (auto i = 0 ; i < 100 ; ++i) {
+			const auto value = a();
+			CHECK(value == b());
+			differences_entity += value != other_entity();
+			differences_tick += value != other_tick();
+		}
+		CHECK(differences_entity > 90);
+		CHECK(differences_tick > 90);
+	}
+
+	SECTION("Jump ahead") {
+		philox4x32 reference{1234, 5, 6};
+		std::vector<philox4x32::result_type> values;
+		for (auto i = 0 ; i < 64 ; ++i) {
+			values.push_back(reference());
+		}
+
+		for (unsigned int skip : {0u, 1u, 3u, 4u, 5u, 17u, 40u}) {
+			for (unsigned int before : {0u, 2u}) {
+				philox4x32 engine{1234, 5, 6};
+				for (auto i = 0u ; i < before ; ++i) {
+					engine();
+				}
+				engine.discard(skip);
+				CHECK(engine() == values[before + skip]);
+				CHECK(engine() == values[before + skip + 1]);
+			}
+		}
+
+		philox4x32 far{1234, 5, 6};
+		far.discard(4ull << 40u);
+		CHECK(far() == philox4x32::block({0u, 1u << 8u, 5u, 6u}, {1234u, 0u})[0]);
+	}
+
+	SECTION("Distributions") {
+		philox4x32 engine{99};
+		dungeep::uniform_int_distribution<int> dist{-3, 3};
+		for (auto i = 0 ; i < 1000 ; ++i) {
+			const int value = dist(engine);
+			CHECK(value >= -3);
+			CHECK(value <= 3);
+		}
+	}
+}
+
+TEST_CASE("xoshiro256**") {
+
+	SECTION("Known answers") {
+		// from the reference implementations
+		dungeep::splitmix64 expander{1234567};
+		CHECK(expander() == 6457827717110365317u);
+		CHECK(expander() == 3203168211198807973u);
+		CHECK(expander() == 9817491932198370423u);
+
+		xoshiro256ss engine{xoshiro256ss::state_type{1u, 2u, 3u, 4u}};
+		CHECK(engine() == 11520u);
+		CHECK(engine() == 0u);
+		CHECK(engine() == 1509978240u);
+		CHECK(engine() == 1215971899390074240u);
+	}
+
+	SECTION("Seeding and snapshots") {
+		xoshiro256ss a{42};
+		xoshiro256ss b;
+		b.seed(42);
+		CHECK(a == b);
+		CHECK(a != xoshiro256ss{43});
+
+		a.discard(10);
+		std::stringstream ss;
+		ss << a;
+		ss >> b;
+		CHECK(a == b);
+		CHECK(a() == b());
+	}
+
+	SECTION("Jump") {
+		xoshiro256ss a{7};
+		xoshiro256ss b{a};
+		b.jump();
+		CHECK(a != b);
+		unsigned int equal = 0;
+		for (auto i = 0 ; i < 100 ; ++i) {
+			equal += a() == b();
+		}
+		CHECK(equal == 0);
+	}
+
+	SECTION("Distributions") {
+		xoshiro256ss engine{99};
+		dungeep::uniform_int_distribution<unsigned int> dist{0u, 9u};
+		dungeep::normal_distribution<float> normal{10.f, 2.f};
+		unsigned int counts[10] = {};
+		double sum = 0;
+		for (auto i = 0 ; i < 10000 ; ++i) {
+			++counts[dist(engine)];
+			sum += normal(engine);
+		}
+		for (unsigned int count : counts) {
+			CHECK(count > 800);
+			CHECK(count < 1200);
+		}
+		CHECK(sum / 10000 == Approx(10.).margin(0.1));
+	}
+}
+
+// a draw pattern similar to map generation's: normal sizes, uniform positions and coin flips
+TEMPLATE_TEST_CASE("Random engines benchmarks", "[.][benchmark]", std::mt19937_64, xoshiro256ss, philox4x32) {
+	BENCHMARK("seed") {
+		TestType engine{42};
+		return engine();
+	};
+
+	// map::generate itself is benchmarked in tests/map_test.cpp
+	TestType engine{42};
+	dungeep::normal_distribution<float> sizes{20.f, 5.f};
+	dungeep::uniform_int_distribution<unsigned int> positions{0u, 500u};
+	BENCHMARK("1000 draws") {
+		float acc = 0.f;
+		for (auto i = 0 ; i < 1000 ; ++i) {
+			acc += sizes(engine);
+			acc += static_cast<float>(positions(engine));
+			acc += static_cast<float>(engine() % 2);
+		}
+		return acc;
+	};
+}
+
+TEST_CASE("Bounded integers") {
+
+	SECTION("Wide multiplication") {
+		auto product = dungeep::details::multiply(0xFFFFFFFFFFFFFFFFu, 0xFFFFFFFFFFFFFFFFu);
+		CHECK(product.high == 0xFFFFFFFFFFFFFFFEu);
+		CHECK(product.low == 1u);
+		product = dungeep::details::multiply(0x123456789ABCDEF0u, 0x10u);
+		CHECK(product.high == 0x1u);
+		CHECK(product.low == 0x23456789ABCDEF00u);
+	}
+
+	SECTION("Ranges") {
+		xoshiro256ss engine64{5};
+		philox4x32 engine32{5};
+		unsigned int counts64[7] = {};
+		unsigned int counts32[7] = {};
+		for (auto i = 0 ; i < 7000 ; ++i) {
+			CHECK(dungeep::bounded_rand(engine64, 1u) == 0u);
+			CHECK(dungeep::bounded_rand(engine32, std::size_t{1}) == 0u);
+			++counts64[dungeep::bounded_rand(engine64, 7u)];
+			++counts32[dungeep::bounded_rand(engine32, 7u)];
+		}
+		for (auto i = 0u ; i < 7 ; ++i) {
+			CHECK(counts64[i] > 850);
+			CHECK(counts64[i] < 1150);
+			CHECK(counts32[i] > 850);
+			CHECK(counts32[i] < 1150);
+		}
+	}
+
+	SECTION("Distribution bounds") {
+		xoshiro256ss engine{11};
+		dungeep::uniform_int_distribution<int> full{std::numeric_limits<int>::min(), std::numeric_limits<int>::max()};
+		dungeep::uniform_int_distribution<short> shorts{-5, -2};
+		dungeep::uniform_int_distribution<unsigned long long> wide{0u, ~0ull - 1};
+		bool negative = false, positive = false;
+		for (auto i = 0 ; i < 1000 ; ++i) {
+			const int value = full(engine);
+			negative |= value < 0;
+			positive |= value > 0;
+			const short s = shorts(engine);
+			CHECK(s >= -5);
+			CHECK(s <= -2);
+			CHECK(wide(engine) != ~0ull);
+		}
+		CHECK(negative);
+		CHECK(positive);
+	}
+}
+
+TEMPLATE_TEST_CASE("Normal distribution", "", xoshiro256ss, philox4x32, std::minstd_rand) {
+	constexpr int sample_count = 200000;
+
+	auto check_moments = [](const std::vector<double>& samples) {
+		double mean = 0., variance = 0., kurtosis = 0.;
+		int tail = 0;
+		for (double sample : samples) {
+			mean += sample;
+		}
+		mean /= static_cast<double>(samples.size());
+		for (double sample : samples) {
+			const double centered = sample - mean;
+			variance += centered * centered;
+			kurtosis += centered * centered * centered * centered;
+			tail += std::abs(centered) > 3.442619855899;
+		}
+		variance /= static_cast<double>(samples.size());
+		kurtosis /= static_cast<double>(samples.size()) * variance * variance;
+
+		CHECK(mean == Approx(0.).margin(0.01));
+		CHECK(variance == Approx(1.).margin(0.02));
+		CHECK(kurtosis == Approx(3.).margin(0.1));
+		// P(|x| > r) ~= 5.76e-4
+		CHECK(tail > 80);
+		CHECK(tail < 160);
+	};
+
+	TestType engine{1};
+	dungeep::normal_distribution<double> normal{};
+
+	SECTION("Single samples") {
+		std::vector<double> samples;
+		for (auto i = 0 ; i < sample_count ; ++i) {
+			samples.push_back(normal(engine));
+		}
+		check_moments(samples);
+	}
+
+	SECTION("Bulk samples") {
+		std::vector<double> samples(sample_count);
+		normal.generate(samples.begin(), samples.end(), engine);
+		check_moments(samples);
+
+		std::vector<double> replayed(sample_count);
+		TestType replay_engine{1};
+		normal.generate(replayed.begin(), replayed.end(), replay_engine);
+		CHECK(samples == replayed);
+	}
+
+	SECTION("Parameters") {
+		dungeep::normal_distribution<float> shifted{5.f, 0.5f};
+		float samples[100];
+		shifted.generate(std::begin(samples), std::end(samples), engine);
+		float sum = 0.f;
+		for (float sample : samples) {
+			sum += sample;
+		}
+		CHECK(sum / 100.f == Approx(5.f).margin(0.25f));
+	}
+}
+
+TEST_CASE("Portable exp and log") {
+
+	SECTION("Close to the standard library's") {
+		double exp_error = 0.;
+		for (double x = -50. ; x < 50. ; x += 0.0037) {
+			exp_error = std::max(exp_error, std::abs(dungeep::details::portable_exp(x) / std::exp(x) - 1.));
+		}
+		CHECK(exp_error < 1e-15);
+
+		double log_error = 0.;
+		for (double x = 1e-300 ; x < 1e10 ; x *= 1.0137) {
+			log_error = std::max(log_error, std::abs(dungeep::details::portable_log(x) - std::log(x)));
+		}
+		CHECK(log_error < 1e-12);
+		CHECK(dungeep::details::portable_log(1.) == 0.);
+		CHECK(dungeep::details::portable_exp(0.) == 1.);
+	}
+
+	SECTION("Normal samples are the same bits everywhere") {
+		// slow paths included: about 50 of these samples come from the tail
+		dungeep::xoshiro256ss engine{2024};
+		dungeep::normal_distribution<double> normal{};
+		dungeep::fnv1a hash;
+		for (auto i = 0 ; i < 100000 ; ++i) {
+			hash.add(normal(engine));
+		}
+		CHECK(hash.value() == 0x37FA48D7D9D42CEEu);
+	}
+}
@@ -0,0 +1,216 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///                                                                                                                                     ///
+///  Copyright C 2018, Lucas Lazare                                                                                                     ///
+///  Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation         ///
+///  		files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy,  ///
+///  modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software     ///
+///  		is furnished to do so, subject to the following conditions:                                                                 ///
+///                                                                                                                                     ///
+///  The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.     ///
+///                                                                                                                                     ///
+///  The Software is provided “as is”, without warranty of any kind, express or implied, including but not limited to the               ///
+///  warranties of merchantability, fitness for a particular purpose and noninfringement. In no event shall the authors or              ///
+///  copyright holders be liable for any claim, damages or other liability, whether in an action of contract, tort or otherwise,        ///
+///  arising from, out of or in connection with the software or the use or other dealings in the Software.                              ///
+///                                                                                                                                     ///
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <utility>
+#include <catch2/catch.hpp>
+#include <utils/spatial_grid.hpp>
+#include <utils/quadtree.hpp>
+#include <utils/geometry.hpp>
+
+using area = dungeep::area<float>;
+using point = dungeep::point<float>;
+using dungeep::quadtree;
+using dungeep::spatial_grid;
+
+namespace {
+
+	struct collider {
+
+		collider(const collider&) noexcept = default;
+		collider& operator=(const collider&) noexcept = default;
+		bool operator==(const collider& other) const {
+			// lazy equality test
+			return hitbox_.contains(other.hitbox_) && other.hitbox_.contains(hitbox_);
+		}
+
+		const area& hitbox() const noexcept {
+			return hitbox_;
+		}
+
+		void set_hitbox(const area& ar) noexcept {
+			hitbox_ = ar;
+		}
+
+		area hitbox_;
+	};
+
+	// creature-like elements: small, evenly spread
+	area rand_area(std::mt19937& rand) {
+		std::uniform_real_distribution<float> pos{0.f, 495.f};
+		std::uniform_real_distribution<float> size{0.5f, 4.f};
+		point pt{pos(rand), pos(rand)};
+		return {pt, pt + point{size(rand), size(rand)}};
+	}
+
+	const area world_area{{0.f, 0.f}, {500.f, 500.f}};
+}
+
+TEMPLATE_TEST_CASE("Spatial indexes", "", quadtree<collider>, spatial_grid<collider>) {
+	std::mt19937 rand{42};
+	TestType index{world_area};
+
+	std::vector<collider> colliders;
+	for (auto i = 0u ; i < 1000 ; ++i) {
+		colliders.push_back({rand_area(rand)});
+		index.insert(colliders.back());
+	}
+	REQUIRE(index.size() == colliders.size());
+	CHECK(static_cast<std::size_t>(std::distance(index.begin(), index.end())) == colliders.size());
+
+	SECTION("Visiting") {
+		const area target{{100.f, 100.f}, {180.f, 150.f}};
+		auto expected = std::count_if(colliders.begin(), colliders.end(), [&target](const collider& c) {
+			return target.collides_with(c.hitbox());
+		});
+
+		long hits = 0;
+		std::as_const(index).visit(target, [&hits, &target](typename TestType::const_iterator it) {
+			CHECK(target.collides_with(it->hitbox()));
+			++hits;
+		});
+		CHECK(hits == expected);
+
+		index.visit(target, [](typename TestType::iterator) { return true; });
+		CHECK(index.size() == colliders.size() - static_cast<std::size_t>(expected));
+		CHECK(!index.has_collision(target));
+	}
+
+	SECTION("Moving") {
+		for (collider& c : colliders) {
+			area moved = rand_area(rand);
+			index.move(c, moved);
+			c.set_hitbox(moved);
+		}
+		REQUIRE(index.size() == colliders.size());
+
+		for (const collider& c : colliders) {
+			CHECK(index.find(c) != index.end());
+			CHECK(index.has_collision_if(c.hitbox(), [&c](const collider& other) { return other == c; }));
+		}
+	}
+
+	SECTION("Colliding pairs") {
+		long expected = 0;
+		for (auto i = 0u ; i < colliders.size() ; ++i) {
+			for (auto j = i + 1 ; j < colliders.size() ; ++j) {
+				expected += colliders[i].hitbox().collides_with(colliders[j].hitbox());
+			}
+		}
+
+		long found = 0;
+		index.for_each_colliding_pair([&found](const collider& lhs, const collider& rhs) {
+			CHECK(lhs.hitbox().collides_with(rhs.hitbox()));
+			++found;
+		});
+		CHECK(found == expected);
+	}
+
+	SECTION("Raycast") {
+		const point from{0.f, 250.f};
+		const point to{500.f, 260.f};
+
+		float closest = 2.f;
+		for (const collider& c : colliders) {
+			float entry = c.hitbox().segment_entry(from, to);
+			if (entry >= 0.f) {
+				closest = std::min(closest, entry);
+			}
+		}
+
+		auto it = index.raycast(from, to);
+		if (closest > 1.f) {
+			CHECK(it == index.end());
+		} else {
+			REQUIRE(it != index.end());
+			CHECK(it->hitbox().segment_entry(from, to) == closest);
+		}
+	}
+
+	SECTION("Stats") {
+		dungeep::quadtree_stats stats = index.stats();
+		CHECK(std::accumulate(stats.nodes_per_depth.begin(), stats.nodes_per_depth.end(), std::size_t{0}) == stats.node_count);
+		CHECK(std::accumulate(stats.elements_per_depth.begin(), stats.elements_per_depth.end(), std::size_t{0}) == index.size());
+		CHECK(stats.allocated_bytes >= index.size() * sizeof(collider));
+
+		index.reset_stats();
+		(void)index.has_collision({{10.f, 10.f}, {12.f, 12.f}});
+		(void)index.raycast({0.f, 250.f}, {500.f, 260.f});
+		stats = index.stats();
+		CHECK(stats.query_count == 2);
+		CHECK(stats.visited_nodes >= 2);
+	}
+
+	SECTION("Erasing") {
+		for (const collider& c : colliders) {
+			index.erase(c);
+		}
+		CHECK(index.empty());
+		CHECK(index.begin() == index.end());
+	}
+}
+
+TEMPLATE_TEST_CASE("Spatial indexes benchmarks", "[.][benchmark]", quadtree<collider>, spatial_grid<collider>) {
+	std::mt19937 rand{42};
+	std::vector<collider> colliders;
+	for (auto i = 0u ; i < 2000 ; ++i) {
+		colliders.push_back({rand_area(rand)});
+	}
+
+	// what the world does when a level is generated
+	BENCHMARK("insert") {
+		TestType index{world_area};
+		for (const collider& c : colliders) {
+			index.insert(c);
+		}
+		return index.size();
+	};
+
+	// what the world does each tick with its creatures
+	TestType index{world_area};
+	for (const collider& c : colliders) {
+		index.insert(c);
+	}
+
+	float offset = 0.5f;
+	BENCHMARK("move") {
+		// moves are small, as creatures' ones
+		for (collider& c : colliders) {
+			area moved{c.hitbox().top_left + point{offset, offset}, c.hitbox().bot_right + point{offset, offset}};
+			index.move(c, moved);
+			c.set_hitbox(moved);
+		}
+		offset = -offset;
+		return index.size();
+	};
+
+	BENCHMARK("query") {
+		long hits = 0;
+		for (float x = 0.f ; x < 500.f ; x += 25.f) {
+			for (float y = 0.f ; y < 500.f ; y += 25.f) {
+				std::as_const(index).visit({{x, y}, {x + 10.f, y + 10.f}}, [&hits](typename TestType::const_iterator) { ++hits; });
+			}
+		}
+		return hits;
+	};
+}
@@ -0,0 +1,129 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///                                                                                                                                     ///
+///  Copyright C 2019, Lucas Lazare                                                                                                     ///
+///  Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation         ///
+///  		files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy,  ///
+///  modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software     ///
+///  		is furnished to do so, subject to the following conditions:                                                                 ///
+///                                                                                                                                     ///
+///  The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.     ///
+///                                                                                                                                     ///
+///  The Software is provided “as is”, without warranty of any kind, express or implied, including but not limited to the               ///
+///  warranties of merchantability, fitness for a particular purpose and noninfringement. In no event shall the authors or              ///
+///  copyright holders be liable for any claim, damages or other liability, whether in an action of contract, tort or otherwise,        ///
+///  arising from, out of or in connection with the software or the use or other dealings in the Software.                              ///
+///                                                                                                                                     ///
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <tuple>
+#include <vector>
+#include <catch2/catch.hpp>
+#include <environment/world_objects/creature_components.hpp>
+#include <utils/object_pool.hpp>
+#include <utils/random.hpp>
+#include <utils/thread_pool.hpp>
+
+using stat = creature_components::stat;
+
+namespace {
+	constexpr unsigned int strip_count = 16;
+	constexpr float world_width = 800.f;
+
+	struct critter : dungeep::pool_allocated<critter> {
+		critter(creature_components& components_, float x_) : components{components_}, entity{components_.create()}, x{x_} {
+			components.get(stat::current_health, entity) = 100;
+		}
+
+		critter(const critter&) = delete;
+		critter& operator=(const critter&) = delete;
+
+		~critter() {
+			components.destroy(entity);
+		}
+
+		creature_components& components;
+		creature_components::id entity;
+		float x;
+	};
+
+	// world::next_tick in short: strips tick by parity, each of them drawing from streams keyed by entity id and requesting
+	// spawns, then the requests are applied in strip order. Returns the entity, position and health of the survivors.
+	std::vector<std::tuple<creature_components::id, float, int>> simulate(dungeep::thread_pool& pool, bool parallel) {
+		creature_components components;
+		std::vector<std::unique_ptr<critter>> critters;
+		for (auto i = 0 ; i < 300 ; ++i) {
+			critters.push_back(std::make_unique<critter>(components, static_cast<float>(i) * world_width / 300.f));
+		}
+
+		for (std::uint32_t tick = 0 ; tick < 40 ; ++tick) {
+			std::array<std::vector<critter*>, strip_count> strips;
+			for (const auto& c : critters) {
+				strips[std::min(static_cast<unsigned int>(c->x / (world_width / strip_count)), strip_count - 1)].push_back(c.get());
+			}
+
+			std::array<std::vector<std::function<std::unique_ptr<critter>()>>, strip_count> spawns;
+			dungeep::run_strips_by_parity(pool, strip_count, parallel, [&](unsigned int strip) {
+				for (critter* c : strips[strip]) {
+					dungeep::philox4x32 rand{42u, c->entity, tick};
+					const std::uint32_t draw = rand();
+					components.get(stat::current_health, c->entity) -= static_cast<int>(draw % 16u);
+					if (draw % 8u == 0u) {
+						const float x = std::fmod(c->x + static_cast<float>(rand() % 100u), world_width);
+						spawns[strip].emplace_back([&components, x] { return std::make_unique<critter>(components, x); });
+					}
+				}
+			});
+
+			// dead critters free their entity, which the spawns reuse
+			critters.erase(std::remove_if(critters.begin(), critters.end(), [&components](const auto& c) {
+				return components.get(stat::current_health, c->entity) <= 0;
+			}), critters.end());
+			for (auto& strip_spawns : spawns) {
+				for (auto& spawn : strip_spawns) {
+					critters.push_back(spawn());
+				}
+			}
+		}
+
+		std::vector<std::tuple<creature_components::id, float, int>> survivors;
+		for (const auto& c : critters) {
+			survivors.emplace_back(c->entity, c->x, components.get(stat::current_health, c->entity));
+		}
+		return survivors;
+	}
+}
+
+TEST_CASE("Ticking by strips") {
+
+	SECTION("The result does not depend on the number of threads") {
+		dungeep::thread_pool single_thread{1};
+		dungeep::thread_pool many_threads{8};
+
+		const auto sequential = simulate(single_thread, false);
+		REQUIRE(sequential.size() > 300);
+		CHECK(simulate(single_thread, true) == sequential);
+		CHECK(simulate(many_threads, true) == sequential);
+		CHECK(simulate(many_threads, true) == sequential);
+	}
+
+	SECTION("Neighbouring strips never run at the same time") {
+		dungeep::thread_pool pool{4};
+		std::array<std::atomic<bool>, strip_count> running{};
+		std::atomic<bool> overlap{false};
+		dungeep::run_strips_by_parity(pool, strip_count, true, [&](unsigned int strip) {
+			running[strip] = true;
+			for (auto i = 0 ; i < 1000 ; ++i) {
+				if ((strip > 0 && running[strip - 1]) || (strip + 1 < strip_count && running[strip + 1])) {
+					overlap = true;
+				}
+			}
+			running[strip] = false;
+		});
+		CHECK_FALSE(overlap);
+	}
+}
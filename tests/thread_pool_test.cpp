@@ -0,0 +1,76 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///                                                                                                                                     ///
+///  Copyright C 2019, Lucas Lazare                                                                                                     ///
+///  Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation         ///
+///  		files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy,  ///
+///  modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software     ///
+///  		is furnished to do so, subject to the following conditions:                                                                 ///
+///                                                                                                                                     ///
+///  The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.     ///
+///                                                                                                                                     ///
+///  The Software is provided “as is”, without warranty of any kind, express or implied, including but not limited to the               ///
+///  warranties of merchantability, fitness for a particular purpose and noninfringement. In no event shall the authors or              ///
+///  copyright holders be liable for any claim, damages or other liability, whether in an action of contract, tort or otherwise,        ///
+///  arising from, out of or in connection with the software or the use or other dealings in the Software.                              ///
+///                                                                                                                                     ///
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <stdexcept>
+#include <catch2/catch.hpp>
+#include <utils/thread_pool.hpp>
+
+using dungeep::thread_pool;
+
+TEST_CASE("Thread pool") {
+	thread_pool pool{3};
+
+	SECTION("Every task runs") {
+		std::atomic<int> sum{0};
+		thread_pool::task_group group;
+		for (int i = 1 ; i <= 100 ; ++i) {
+			pool.push(group, [&sum, i] { sum += i; });
+		}
+		pool.wait(group);
+		CHECK(group.done());
+		CHECK(sum == 5050);
+	}
+
+	SECTION("Nested groups") {
+		std::atomic<int> count{0};
+		thread_pool::task_group outer;
+		for (int i = 0 ; i < 8 ; ++i) {
+			pool.push(outer, [&pool, &count] {
+				thread_pool::task_group inner;
+				for (int j = 0 ; j < 8 ; ++j) {
+					pool.push(inner, [&count] { ++count; });
+				}
+				pool.wait(inner);
+			});
+		}
+		pool.wait(outer);
+		CHECK(count == 64);
+	}
+
+	SECTION("Exceptions") {
+		std::atomic<int> ran{0};
+		thread_pool::task_group group;
+		for (int i = 0 ; i < 32 ; ++i) {
+			pool.push(group, [&ran, i] {
+				++ran;
+				if (i % 8 == 3) {
+					throw std::runtime_error("task failed");
+				}
+			});
+		}
+		CHECK_THROWS_AS(pool.wait(group), std::runtime_error);
+		CHECK(group.done());
+		CHECK(ran == 32);
+
+		// the exception is only rethrown once, and the group and the pool stay usable
+		CHECK_NOTHROW(pool.wait(group));
+		pool.push(group, [&ran] { ++ran; });
+		CHECK_NOTHROW(pool.wait(group));
+		CHECK(ran == 33);
+	}
+}
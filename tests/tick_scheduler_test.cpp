@@ -0,0 +1,80 @@
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+///                                                                                                                                     ///
+///  Copyright C 2018, Lucas Lazare                                                                                                     ///
+///  Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation         ///
+///  		files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy,  ///
+///  modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software     ///
+///  		is furnished to do so, subject to the following conditions:                                                                 ///
+///                                                                                                                                     ///
+///  The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.     ///
+///                                                                                                                                     ///
+///  The Software is provided “as is”, without warranty of any kind, express or implied, including but not limited to the               ///
+///  warranties of merchantability, fitness for a particular purpose and noninfringement. In no event shall the authors or              ///
+///  copyright holders be liable for any claim, damages or other liability, whether in an action of contract, tort or otherwise,        ///
+///  arising from, out of or in connection with the software or the use or other dealings in the Software.                              ///
+///                                                                                                                                     ///
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include <chrono>
+#include <catch2/catch.hpp>
+#include <utils/tick_scheduler.hpp>
+
+using namespace std::chrono_literals;
+using dungeep::tick_scheduler;
+using dungeep::duration_histogram;
+
+TEST_CASE("Tick scheduler") {
+	tick_scheduler scheduler{10ms, 3};
+	unsigned int ticks = 0;
+	auto tick = [&ticks] { ++ticks; };
+
+	SECTION("Fixed steps") {
+		CHECK(scheduler.advance(4ms, tick) == 0);
+		CHECK(scheduler.advance(4ms, tick) == 0);
+		CHECK(scheduler.advance(4ms, tick) == 1);
+		CHECK(scheduler.interpolation() == Approx(0.2f));
+		CHECK(scheduler.advance(18ms, tick) == 2);
+		CHECK(ticks == 3);
+		CHECK(scheduler.tick_count() == 3);
+		CHECK(scheduler.dropped_ticks() == 0);
+		CHECK(scheduler.tick_durations().count() == 3);
+	}
+
+	SECTION("Bounded catch up") {
+		CHECK(scheduler.advance(75ms, tick) == 3);
+		CHECK(ticks == 3);
+		CHECK(scheduler.dropped_ticks() == 4);
+		CHECK(scheduler.interpolation() == Approx(0.5f));
+
+		CHECK(scheduler.advance(5ms, tick) == 1);
+		CHECK(scheduler.tick_count() == 4);
+
+		scheduler.reset_stats();
+		CHECK(scheduler.dropped_ticks() == 0);
+		CHECK(scheduler.tick_durations().count() == 0);
+		CHECK(scheduler.tick_count() == 4);
+	}
+}
+
+TEST_CASE("Duration histogram") {
+	duration_histogram histogram;
+	histogram.add(500ns);
+	histogram.add(3us);
+	histogram.add(3us);
+	histogram.add(40us);
+	histogram.add(10s);
+
+	CHECK(histogram.count() == 5);
+	CHECK(histogram.buckets()[0] == 1);
+	CHECK(histogram.buckets()[1] == 2);
+	CHECK(histogram.buckets()[5] == 1);
+	CHECK(histogram.buckets()[duration_histogram::bucket_count - 1] == 1);
+	CHECK(histogram.max() == 10s);
+	CHECK(histogram.percentile(0.5f) == 4us);
+	CHECK(histogram.percentile(0.7f) == 64us);
+	CHECK(histogram.percentile(1.f) == 10s);
+
+	histogram.reset();
+	CHECK(histogram.count() == 0);
+	CHECK(histogram.mean() == 0ns);
+}